@@ -9,11 +9,22 @@
 
 #include <vulkan/vulkan.h>
 #include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * Pipeline cache persistence
+ *
+ * The cache lives in $PEARVISOR_CACHE_DIR, else ~/Library/Caches/PearVisor,
+ * one file per pipelineCacheUUID and driver version. Compiles write it back
+ * at most every FLUSH_INTERVAL seconds; device destruction always does.
+ */
+#define PV_MOLTENVK_PIPELINE_CACHE_FLUSH_INTERVAL  30
+
 /*
  * MoltenVK context
  * 
@@ -36,13 +47,25 @@ struct pv_moltenvk_context {
     VkDevice device;
     bool device_created;
     
-    /* Queues */
+    /* Queues (compute and transfer share graphics when the device has no spare) */
     VkQueue graphics_queue;
     VkQueue compute_queue;
     VkQueue transfer_queue;
     uint32_t graphics_queue_family;
     uint32_t compute_queue_family;
     uint32_t transfer_queue_family;
+    uint32_t compute_queue_index;     /* Within compute_queue_family */
+    uint32_t transfer_queue_index;    /* Within transfer_queue_family */
+    
+    /* Held around vkQueueSubmit / vkQueueWaitIdle (queues may alias) */
+    pthread_mutex_t queue_lock;
+    
+    /* Pipeline cache for every pipeline creation (VK_NULL_HANDLE if unavailable) */
+    VkPipelineCache pipeline_cache;
+    char *pipeline_cache_path;        /* NULL = not persisted */
+    size_t pipeline_cache_saved;      /* Data size at the last flush */
+    time_t pipeline_cache_flushed;    /* Time of the last flush */
+    pthread_mutex_t pipeline_cache_lock;  /* Serializes flushes */
 };
 
 /*
@@ -89,6 +112,43 @@ VkResult pv_moltenvk_create_device(
     struct pv_moltenvk_context *ctx
 );
 
+/*
+ * Map a guest queue request onto one of the device's queues
+ * 
+ * An exact family/index match gets that queue; anything else gets the
+ * queue whose role fits the family best (graphics, then compute, then
+ * transfer).
+ * 
+ * @ctx: MoltenVK context with a device
+ * @family: Queue family index the guest asked for
+ * @index: Queue index within the family
+ * Returns: Queue, or VK_NULL_HANDLE if @family doesn't exist
+ */
+VkQueue pv_moltenvk_get_queue(
+    const struct pv_moltenvk_context *ctx,
+    uint32_t family,
+    uint32_t index
+);
+
+/*
+ * Flush the pipeline cache and destroy the logical device
+ * 
+ * @ctx: MoltenVK context
+ */
+void pv_moltenvk_destroy_device(struct pv_moltenvk_context *ctx);
+
+/*
+ * Write the pipeline cache to disk
+ * 
+ * Written to a temporary file and renamed over the old one, so a crash
+ * never leaves a torn cache behind.
+ * 
+ * @ctx: MoltenVK context
+ * @force: Write even if the flush interval hasn't passed
+ * Returns: 0 on success (or nothing to do), negative on error
+ */
+int pv_moltenvk_pipeline_cache_flush(struct pv_moltenvk_context *ctx, bool force);
+
 /*
  * Print Vulkan information (for debugging)
  */
@@ -0,0 +1,247 @@
+/*
+ * PearVisor - Venus Submit Completion Tracking
+ *
+ * Every vkQueueSubmit the host makes carries a host fence. A completion
+ * thread waits on those fences, oldest first, and publishes how far the
+ * guest's submits have got into a page of shared memory. The guest waits
+ * on that page instead of asking the ring thread to block in
+ * vkQueueWaitIdle, so decoding never stalls behind the GPU.
+ *
+ * Progress is counted in guest submits: the Nth vkQueueSubmit command a
+ * context decodes has sequence number N. The published value only ever
+ * grows and covers every submit up to it, across all queues.
+ *
+ * Guest fences live in the same page as slots holding the number of the
+ * submit that signals them, so the guest can check one with two loads:
+ * signalled == (slot <= completed). Creation, resets and submits update
+ * the slots; only waits that really have to block need the ring.
+ *
+ * A submit the driver refused, or whose fence wait failed, still counts
+ * as completed so nothing waits on it forever, but it also marks the
+ * context lost: the page records the first such submit, and from then on
+ * the guest should treat the device as lost (VK_ERROR_DEVICE_LOST).
+ */
+
+#ifndef PV_VENUS_COMPLETION_H
+#define PV_VENUS_COMPLETION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PV_VENUS_COMPLETION_MAGIC    0x50564346u  /* "PVCF" */
+#define PV_VENUS_COMPLETION_VERSION  3
+
+/* Fence slot value of a fence no pending submit will signal */
+#define PV_VENUS_FENCE_UNSIGNALED    UINT64_MAX
+
+/* How long one backend wait blocks before the thread checks for stop */
+#define PV_VENUS_COMPLETION_WAIT_NS  (100ull * 1000 * 1000)
+
+/*
+ * Shared completion page (host writes, guest reads)
+ */
+struct pv_venus_completion_page {
+    uint32_t magic;
+    uint32_t version;
+    _Atomic uint64_t submitted;       /* Last guest submit handed to the driver */
+    _Atomic uint64_t completed;       /* Last guest submit whose work finished */
+    _Atomic uint64_t failed;          /* First guest submit that failed (0 = none) */
+    uint32_t fence_slot_count;        /* Slots that fit in the attached memory */
+    uint32_t _padding;
+    _Atomic uint64_t fences[];        /* Signalling submit per guest fence slot */
+};
+
+/*
+ * Host fence backend
+ *
+ * Implemented with vkWaitForFences / vkResetFences / vkDestroyFence by
+ * the handlers, and with fakes by the tests.
+ */
+struct pv_venus_completion_backend {
+    /* Returns: 1 if signalled, 0 on timeout, negative on error */
+    int (*wait)(void *user_data, void *fence, uint64_t timeout_ns);
+    void (*reset)(void *user_data, void *fence);
+    void (*destroy)(void *user_data, void *fence);
+    void *user_data;
+};
+
+/* One submission in flight */
+struct pv_venus_completion_entry {
+    void *fence;
+    uint64_t seqno;
+    bool owned;                       /* Recycle the fence once signalled */
+    bool failed;                      /* Never reached the GPU (no fence) */
+};
+
+/* Tracker statistics */
+struct pv_venus_completion_stats {
+    uint64_t submissions;             /* Host submits tracked */
+    uint64_t completions;
+    uint64_t errors;                  /* Failed submits and fence waits (published anyway) */
+    uint64_t host_waits;              /* pv_venus_completion_wait calls that blocked */
+    uint64_t fences_created;          /* Owned fences not served by the free list */
+    uint64_t max_in_flight;
+};
+
+/*
+ * Completion tracker for one guest context
+ */
+struct pv_venus_completion_tracker {
+    struct pv_venus_completion_backend backend;
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;              /* Submission pushed, or stop */
+    pthread_cond_t done;              /* Completion published */
+    pthread_t thread;
+    bool thread_running;
+    bool stop;
+
+    /* In flight, oldest first (circular) */
+    struct pv_venus_completion_entry *entries;
+    uint32_t head;
+    uint32_t count;
+    uint32_t capacity;
+
+    /* Signalled owned fences, reset and ready for reuse */
+    void **free_fences;
+    uint32_t free_count;
+    uint32_t free_capacity;
+
+    /* Host's own view; the guest may scribble on its page */
+    uint64_t submitted;
+    uint64_t completed;
+    uint64_t failed;                  /* First failed submit, 0 = none (sticky) */
+
+    /* Guest page the view is mirrored to (NULL until attached) */
+    struct pv_venus_completion_page *page;
+    uint32_t page_fence_slots;        /* Host's copy of page->fence_slot_count */
+
+    struct pv_venus_completion_stats stats;
+};
+
+/*
+ * Initialize a tracker and start its completion thread
+ *
+ * @tracker: Tracker to initialize
+ * @backend: Fence functions (copied)
+ * Returns: 0 on success, negative on error
+ */
+int pv_venus_completion_init(struct pv_venus_completion_tracker *tracker,
+                             const struct pv_venus_completion_backend *backend);
+
+/*
+ * Wait for everything in flight, stop the thread, destroy pooled fences
+ */
+void pv_venus_completion_destroy(struct pv_venus_completion_tracker *tracker);
+
+/*
+ * Publish into guest-visible memory from now on
+ *
+ * The page is stamped and brought up to date before this returns; every
+ * fence slot starts out unsignalled.
+ *
+ * @page: Shared memory
+ * @size: Bytes at @page (decides the number of fence slots)
+ * Returns: 0 on success, negative on error
+ */
+int pv_venus_completion_attach_page(struct pv_venus_completion_tracker *tracker,
+                                    struct pv_venus_completion_page *page,
+                                    size_t size);
+
+/*
+ * True once a guest page is attached
+ */
+bool pv_venus_completion_has_page(struct pv_venus_completion_tracker *tracker);
+
+/*
+ * Take a reset fence from the free list
+ *
+ * Returns: A fence, or NULL if the caller has to create one
+ */
+void *pv_venus_completion_take_fence(struct pv_venus_completion_tracker *tracker);
+
+/*
+ * Track a submission that was just handed to the driver
+ *
+ * @fence: Host fence the submission signals
+ * @owned: Fence belongs to the tracker (recycled once signalled)
+ * @seqno: Last guest submit it includes
+ * Returns: 0 on success, negative on error (nothing tracked)
+ */
+int pv_venus_completion_push(struct pv_venus_completion_tracker *tracker,
+                             void *fence, bool owned, uint64_t seqno);
+
+/*
+ * Record a guest submit that failed
+ *
+ * It is published in order like any other, so a later completion never
+ * stands in for it, and marks the context lost. If even that can't be
+ * queued the context is marked lost at once.
+ *
+ * @seqno: Last guest submit the failed host submit included
+ */
+void pv_venus_completion_push_failed(struct pv_venus_completion_tracker *tracker,
+                                     uint64_t seqno);
+
+/*
+ * First guest submit that failed
+ *
+ * Returns: Its sequence number, or 0 while the context is healthy
+ */
+uint64_t pv_venus_completion_failed(struct pv_venus_completion_tracker *tracker);
+
+/*
+ * Block until guest submit @seqno has completed
+ *
+ * For the host's own needs (teardown, guests without a page); guests
+ * with a page wait on it instead.
+ */
+void pv_venus_completion_wait(struct pv_venus_completion_tracker *tracker, uint64_t seqno);
+
+/*
+ * Block until guest submit @seqno has completed, or @timeout_ns passes
+ *
+ * Returns: 0 once completed, 1 on timeout or if @seqno is not in flight,
+ *          -1 if the context is lost
+ */
+int pv_venus_completion_wait_timeout(struct pv_venus_completion_tracker *tracker,
+                                     uint64_t seqno, uint64_t timeout_ns);
+
+/*
+ * Mirror a guest fence's signalling submit into its page slot
+ *
+ * Ignored without a page, or for slots beyond its end.
+ */
+void pv_venus_completion_set_fence(struct pv_venus_completion_tracker *tracker,
+                                   uint32_t slot, uint64_t seqno);
+
+/*
+ * Wait for everything in flight and destroy pooled fences
+ *
+ * Required before the device the fences belong to goes away.
+ */
+void pv_venus_completion_drain(struct pv_venus_completion_tracker *tracker);
+
+/*
+ * Last completed guest submit
+ */
+uint64_t pv_venus_completion_completed(struct pv_venus_completion_tracker *tracker);
+
+/*
+ * Get tracker statistics
+ */
+void pv_venus_completion_get_stats(struct pv_venus_completion_tracker *tracker,
+                                   struct pv_venus_completion_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PV_VENUS_COMPLETION_H */
@@ -9,11 +9,32 @@
 
 #include "pv_venus_ring.h"
 #include "pv_venus_protocol.h"
+#include "pv_venus_latency.h"
+#include <pthread.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Latency of one command ID */
+struct pv_venus_command_latency {
+    struct pv_venus_latency_histogram dispatch;  /* Header read -> handler return */
+    struct pv_venus_latency_histogram queue;     /* Tail seen -> handler return */
+};
+
+/*
+ * Per-thread latency table
+ * 
+ * Every decoding thread records into its own table, so recording takes
+ * no locks and shares no cache lines. Per-command entries are allocated
+ * on first use. Snapshots merge all tables.
+ */
+struct pv_venus_latency_table {
+    pthread_t thread;
+    struct pv_venus_latency_table *next;
+    _Atomic(struct pv_venus_command_latency *) commands[PV_VENUS_MAX_COMMAND_ID];
+};
+
 /*
  * Command dispatch context
  * 
@@ -36,6 +57,11 @@ struct pv_venus_dispatch_context {
     uint64_t commands_dispatched;
     uint64_t commands_unknown;
     uint64_t commands_failed;
+    
+    /* Latency histograms, one table per decoding thread */
+    uint64_t generation;              /* Unique per context, for per-thread caches */
+    pthread_mutex_t latency_lock;
+    struct pv_venus_latency_table *_Atomic latency_tables;
 };
 
 /*
@@ -57,10 +83,44 @@ void pv_venus_dispatch_register(
     pv_venus_command_handler_t handler
 );
 
+/*
+ * Snapshot latency histograms for one command
+ * 
+ * Merges the histograms of all decoding threads. Safe to call while the
+ * ring thread is running (counts may be a few samples apart).
+ * 
+ * @ctx: Dispatch context
+ * @command_id: Command to snapshot
+ * @latency: Filled with merged histograms
+ * Returns: Number of samples, 0 if the command was never decoded
+ */
+uint64_t pv_venus_dispatch_latency(
+    struct pv_venus_dispatch_context *ctx,
+    uint32_t command_id,
+    struct pv_venus_command_latency *latency
+);
+
+/*
+ * Scratch arena of the ring whose command is being dispatched
+ * 
+ * For handlers: allocations last until pv_venus_decode_all finishes its
+ * drain, and must not be kept past the handler.
+ * 
+ * Returns: Arena, or NULL when not called from a handler
+ */
+struct pv_venus_ring_arena *pv_venus_dispatch_arena(void);
+
+/*
+ * Returned when a command can't be framed (bad header, or a command that
+ * runs past the tail). The ring is marked PV_VENUS_RING_STATUS_ERROR.
+ */
+#define PV_VENUS_DECODE_FRAMING_ERROR (-2)
+
 /*
  * Process one command from ring buffer
  * 
- * Returns: 0 on success, negative on error
+ * Returns: 0 on success, PV_VENUS_DECODE_FRAMING_ERROR if the ring can't
+ * be decoded any further, other negative values if the handler failed
  */
 int pv_venus_decode_command(
     struct pv_venus_ring *ring,
@@ -70,6 +130,11 @@ int pv_venus_decode_command(
 /*
  * Process all available commands from ring buffer
  * 
+ * Head is published every ring->head_batch_bytes bytes or
+ * ring->head_batch_commands commands, and once more at the end.
+ * A framing error ends the drain and leaves the ring in PV_VENUS_RING_STATUS_ERROR.
+ * The ring's scratch arena is reset when the drain ends.
+ * 
  * Returns: Number of commands processed
  */
 int pv_venus_decode_all(
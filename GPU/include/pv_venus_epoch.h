@@ -0,0 +1,57 @@
+/*
+ * PearVisor - Epoch-Based Reclamation
+ *
+ * Lets readers walk shared structures without locks. Writers unlink old
+ * storage and hand it to pv_venus_epoch_retire(); it is freed once every
+ * thread that could still be reading it has left its read section.
+ */
+
+#ifndef PV_VENUS_EPOCH_H
+#define PV_VENUS_EPOCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Maximum threads inside read sections at once with their own record
+ * (more still work, but stall reclamation while they read)
+ */
+#define PV_VENUS_EPOCH_MAX_THREADS 128
+
+/*
+ * Enter a read section
+ *
+ * Pointers loaded after this stay valid until pv_venus_epoch_exit().
+ * Sections nest. The first call on a thread claims a per-thread record,
+ * released when the thread exits.
+ */
+void pv_venus_epoch_enter(void);
+
+/*
+ * Leave a read section
+ */
+void pv_venus_epoch_exit(void);
+
+/*
+ * Free @ptr once no read section can still reference it
+ *
+ * The caller must already have made @ptr unreachable for new readers.
+ *
+ * @ptr: Block from malloc/calloc (NULL is ignored)
+ */
+void pv_venus_epoch_retire(void *ptr);
+
+/*
+ * Free whatever retired storage is safe to free now
+ *
+ * A single relaxed load when nothing is pending, so writers can call it
+ * after every update.
+ */
+void pv_venus_epoch_reclaim(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PV_VENUS_EPOCH_H */
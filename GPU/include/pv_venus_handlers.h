@@ -9,6 +9,14 @@
 
 #include "pv_venus_protocol.h"
 #include "pv_venus_decoder.h"
+#include "pv_venus_reply.h"
+#include "pv_venus_objects.h"
+#include "pv_venus_memory.h"
+#include "pv_venus_shader_cache.h"
+#include "pv_venus_pipeline_pool.h"
+#include "pv_venus_submit.h"
+#include "pv_venus_completion.h"
+#include "pv_venus_query_cache.h"
 #include "pv_moltenvk.h"
 #include <vulkan/vulkan.h>
 
@@ -16,50 +24,6 @@
 extern "C" {
 #endif
 
-/*
- * Object ID type
- * 
- * Venus uses 64-bit IDs to reference Vulkan objects.
- * We need to map these guest IDs to host Vulkan handles.
- */
-typedef uint64_t pv_venus_object_id;
-
-/*
- * Object types
- */
-typedef enum {
-    PV_VENUS_OBJECT_TYPE_INSTANCE = 0,
-    PV_VENUS_OBJECT_TYPE_PHYSICAL_DEVICE,
-    PV_VENUS_OBJECT_TYPE_DEVICE,
-    PV_VENUS_OBJECT_TYPE_QUEUE,
-    PV_VENUS_OBJECT_TYPE_SEMAPHORE,
-    PV_VENUS_OBJECT_TYPE_FENCE,
-    PV_VENUS_OBJECT_TYPE_DEVICE_MEMORY,
-    PV_VENUS_OBJECT_TYPE_BUFFER,
-    PV_VENUS_OBJECT_TYPE_IMAGE,
-    PV_VENUS_OBJECT_TYPE_COMMAND_POOL,
-    PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER,
-} pv_venus_object_type;
-
-/*
- * Object table entry
- */
-struct pv_venus_object {
-    pv_venus_object_id guest_id;      /* ID from guest */
-    void *host_handle;                 /* VkInstance, VkDevice, etc */
-    pv_venus_object_type type;
-    bool in_use;
-};
-
-/*
- * Object table for tracking guest ID → host handle mappings
- */
-struct pv_venus_object_table {
-    struct pv_venus_object *objects;
-    size_t capacity;
-    size_t count;
-};
-
 /*
  * Venus handler context
  * 
@@ -72,6 +36,27 @@ struct pv_venus_handler_context {
     /* Object tracking */
     struct pv_venus_object_table objects;
     
+    /* Guest device memory, suballocated from shared host blocks */
+    struct pv_venus_memory_allocator memory;
+    
+    /* Pipelines compile here, off the ring thread */
+    struct pv_venus_pipeline_pool pipelines;
+    
+    /* Guest submits, merged into fewer vkQueueSubmit calls */
+    struct pv_venus_submit_coalescer submits;
+    
+    /* Fences on those submits, waited for off the ring thread */
+    struct pv_venus_completion_tracker completions;
+    
+    /* Layout for pipelines that declare none (VK_NULL_HANDLE until needed) */
+    VkPipelineLayout empty_layout;
+    
+    /* Physical device query replies, serialized once the device is selected */
+    struct pv_venus_query_cache queries;
+    
+    /* Query results back to the guest (NULL = not attached, not owned) */
+    struct pv_venus_reply_ring *reply;
+    
     /* Statistics */
     uint64_t commands_handled;
     uint64_t objects_created;
@@ -89,35 +74,43 @@ struct pv_venus_handler_context *pv_venus_handlers_create(void);
 void pv_venus_handlers_destroy(struct pv_venus_handler_context *ctx);
 
 /*
- * Register all command handlers with decoder
+ * Set up @ctx->memory, backed by vkAllocateMemory on @ctx->vk->device
+ *
+ * Returns: 0 on success, negative on error
  */
-void pv_venus_handlers_register(
-    struct pv_venus_dispatch_context *dispatch_ctx,
-    struct pv_venus_handler_context *handler_ctx
-);
+int pv_venus_handlers_memory_init(struct pv_venus_handler_context *ctx);
 
 /*
- * Object table operations
+ * Set up @ctx->completions and @ctx->submits (submitting under
+ * @ctx->vk->queue_lock)
+ *
+ * Returns: 0 on success, negative on error
  */
+int pv_venus_handlers_submit_init(struct pv_venus_handler_context *ctx);
 
-/* Add object to table */
-int pv_venus_object_add(
-    struct pv_venus_object_table *table,
-    pv_venus_object_id guest_id,
-    void *host_handle,
-    pv_venus_object_type type
-);
+/*
+ * Process-wide shader module cache
+ * 
+ * Entries are per VkDevice, and each context opens its own, so modules
+ * are deduplicated within a context, not across guests.
+ * 
+ * Returns: The cache (created on first use), or NULL if it couldn't be
+ */
+struct pv_venus_shader_cache *pv_venus_handlers_shader_cache(void);
 
-/* Get object from table */
-void *pv_venus_object_get(
-    struct pv_venus_object_table *table,
-    pv_venus_object_id guest_id
-);
+/*
+ * Destroy every host object still in the table, children-first
+ *
+ * For guests that crash or shut down without destroying their objects.
+ */
+void pv_venus_handlers_release_objects(struct pv_venus_handler_context *ctx);
 
-/* Remove object from table */
-void pv_venus_object_remove(
-    struct pv_venus_object_table *table,
-    pv_venus_object_id guest_id
+/*
+ * Register all command handlers with decoder
+ */
+void pv_venus_handlers_register(
+    struct pv_venus_dispatch_context *dispatch_ctx,
+    struct pv_venus_handler_context *handler_ctx
 );
 
 /*
@@ -176,6 +169,20 @@ int pv_venus_handle_vkGetPhysicalDeviceMemoryProperties(
     size_t data_size
 );
 
+int pv_venus_handle_vkGetPhysicalDeviceFormatProperties(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
+int pv_venus_handle_vkGetPhysicalDeviceQueueFamilyProperties(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
 /* Device management */
 int pv_venus_handle_vkCreateDevice(
     void *context,
@@ -235,6 +242,51 @@ int pv_venus_handle_vkBindBufferMemory(
     size_t data_size
 );
 
+/* Shader modules */
+int pv_venus_handle_vkCreateShaderModule(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
+int pv_venus_handle_vkDestroyShaderModule(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
+/* Pipelines (compiled asynchronously; placeholders resolve on first use) */
+int pv_venus_handle_vkCreateComputePipelines(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
+/* Rejected with VK_ERROR_FEATURE_NOT_PRESENT until the protocol carries pipeline state */
+int pv_venus_handle_vkCreateGraphicsPipelines(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
+int pv_venus_handle_vkDestroyPipeline(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
+int pv_venus_handle_vkCmdBindPipeline(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
 /* Image management */
 int pv_venus_handle_vkCreateImage(
     void *context,
@@ -301,6 +353,42 @@ int pv_venus_handle_vkEndCommandBuffer(
     size_t data_size
 );
 
+/* Fences (slots in the guest's completion page; results via the reply ring) */
+int pv_venus_handle_vkCreateFence(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
+int pv_venus_handle_vkDestroyFence(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
+int pv_venus_handle_vkResetFences(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
+int pv_venus_handle_vkGetFenceStatus(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
+int pv_venus_handle_vkWaitForFences(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size
+);
+
 /* Queue operations */
 int pv_venus_handle_vkQueueSubmit(
     void *context,
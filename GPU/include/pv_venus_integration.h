@@ -27,15 +27,58 @@ typedef struct pv_venus_stats {
     uint32_t _padding;  /* Align to 16 bytes */
 } pv_venus_stats;
 
+/* Per-command latency for Swift (nanoseconds) */
+typedef struct pv_venus_latency_stats {
+    uint32_t command_id;
+    uint32_t _padding;
+    uint64_t count;
+    uint64_t dispatch_p50_ns;   /* Header read -> handler return */
+    uint64_t dispatch_p99_ns;
+    uint64_t dispatch_max_ns;
+    uint64_t queue_p50_ns;      /* Tail seen -> handler return */
+    uint64_t queue_p99_ns;
+    uint64_t queue_max_ns;
+} pv_venus_latency_stats;
+
+/* Shader module cache statistics for Swift (shared by all contexts) */
+typedef struct pv_venus_shader_stats {
+    uint64_t lookups;           /* vkCreateShaderModule calls */
+    uint64_t hits;              /* Served by an existing host module */
+    uint64_t bytes_saved;       /* SPIR-V not recompiled */
+    uint64_t modules;           /* Live host modules */
+    double hit_rate;            /* hits / lookups (0 before any lookup) */
+} pv_venus_shader_stats;
+
+/* Queue submit coalescing statistics for Swift (per context) */
+typedef struct pv_venus_queue_stats {
+    uint64_t guest_submits;     /* Batches the guest submitted */
+    uint64_t host_submits;      /* vkQueueSubmit calls they became */
+    uint64_t timer_flushes;     /* Sent because the delay budget ran out */
+    uint64_t budget_flushes;    /* Sent because the byte/batch budget ran out */
+    uint64_t completed_submits; /* Guest submits finished on the GPU */
+    uint64_t host_waits;        /* Waits that blocked the ring thread */
+    double merge_ratio;         /* guest / host (0 before any submit) */
+} pv_venus_queue_stats;
+
 /*
  * Create Venus ring buffer from existing memory region
  * Used by Swift to create ring in VM shared memory
  * 
+ * The guest driver owns the control word offsets, so the layout is not
+ * the host's choice: pass the version and line size the guest
+ * advertised. The control words come first (16 bytes packed, three
+ * lines isolated) and the buffer is the largest power of 2 after them,
+ * so a power-of-2 ring needs @size = buffer + control size.
+ * 
  * @param memory Pointer to shared memory region (page-aligned)
- * @param size Size of memory region in bytes (power of 2)
+ * @param size Size of memory region in bytes
+ * @param layout_version PV_VENUS_RING_LAYOUT_PACKED or PV_VENUS_RING_LAYOUT_ISOLATED
+ * @param cache_line_size Line size for ISOLATED (0 = PV_VENUS_RING_CACHE_LINE_SIZE)
  * @return Ring buffer handle or NULL on failure
  */
-struct pv_venus_ring* pv_venus_ring_create_from_memory(void *memory, uint32_t size);
+struct pv_venus_ring* pv_venus_ring_create_from_memory(void *memory, uint32_t size,
+                                                       uint32_t layout_version,
+                                                       uint32_t cache_line_size);
 
 /* Note: pv_venus_ring_destroy declared in pv_venus_ring.h */
 /* Note: pv_venus_ring_notify declared in pv_venus_ring.h */
@@ -43,7 +86,7 @@ struct pv_venus_ring* pv_venus_ring_create_from_memory(void *memory, uint32_t si
 
 /*
  * Start ring buffer processing with dispatch context
- * Integration-specific function that sets up polling mode
+ * Starts the ring thread, which decodes commands into the context
  * 
  * @param ring Ring buffer handle
  * @param context Venus dispatch context
@@ -78,11 +121,76 @@ void* pv_venus_init(void);
  */
 void pv_venus_cleanup(void *context);
 
+/*
+ * Attach a reply ring to a Venus context
+ * 
+ * Query handlers serialize their results into @memory, which must be
+ * shared with the guest. Same layout and sizing as
+ * pv_venus_ring_create_from_memory, with the host producing at tail.
+ * The ring is destroyed with the context.
+ * 
+ * @param context Context from pv_venus_init
+ * @param memory Pointer to shared memory region (page-aligned)
+ * @param size Size of memory region in bytes
+ * @param layout_version Layout the guest uses for this ring
+ * @param cache_line_size Line size for ISOLATED (0 = default)
+ * @return 0 on success, negative on error
+ */
+int pv_venus_attach_reply_memory(void *context, void *memory, uint32_t size,
+                                 uint32_t layout_version, uint32_t cache_line_size);
+
+/*
+ * Attach the shared completion page to a Venus context
+ * 
+ * The host publishes how many of the context's vkQueueSubmit commands
+ * have finished on the GPU into @memory (struct pv_venus_completion_page),
+ * and vkQueueWaitIdle returns at once: the guest waits until
+ * completed >= the number of submits it has issued. The rest of @memory
+ * holds fence slots; a guest fence is signalled once its slot is
+ * <= completed, so fence status needs no ring round trip.
+ * 
+ * @param context Context from pv_venus_init
+ * @param memory Shared memory, at least the page header, 8-byte aligned
+ * @param size Size of memory region in bytes
+ * @return 0 on success, negative on error
+ */
+int pv_venus_attach_completion_memory(void *context, void *memory, uint32_t size);
+
 /*
  * Get Venus protocol statistics
  */
 struct pv_venus_stats pv_venus_get_stats(void *context);
 
+/*
+ * Snapshot per-command latency histograms
+ * 
+ * Fills one entry per command ID that has been decoded, in ID order.
+ * 
+ * @param context Context from pv_venus_init
+ * @param stats Output array
+ * @param max_stats Capacity of @stats
+ * @return Number of entries written
+ */
+uint32_t pv_venus_get_latency_stats(void *context, pv_venus_latency_stats *stats,
+                                    uint32_t max_stats);
+
+/*
+ * Get shader module cache statistics
+ * 
+ * The cache is process-wide, so this covers every guest.
+ * 
+ * @return Statistics (all zero before the first shader module)
+ */
+struct pv_venus_shader_stats pv_venus_get_shader_stats(void);
+
+/*
+ * Get queue submit coalescing statistics
+ * 
+ * @param context Context from pv_venus_init
+ * @return Statistics (all zero for a NULL context)
+ */
+struct pv_venus_queue_stats pv_venus_get_queue_stats(void *context);
+
 #ifdef __cplusplus
 }
 #endif
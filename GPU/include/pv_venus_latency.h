@@ -0,0 +1,148 @@
+/*
+ * PearVisor - Venus Latency Histograms
+ *
+ * Log-bucketed (HDR-style) latency histograms, cheap enough to record
+ * on every command: one clock read and one increment.
+ */
+
+#ifndef PV_VENUS_LATENCY_H
+#define PV_VENUS_LATENCY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bucket layout
+ *
+ * Values below 2^SUB_BITS ns get one bucket each. Above that, every
+ * power of 2 is split into 2^SUB_BITS linear sub-buckets, so the
+ * relative error is at most 1/2^SUB_BITS (25%). Values past 2^MAX_BITS
+ * ns (~69 s) land in the last bucket.
+ */
+#define PV_VENUS_LATENCY_SUB_BITS       2
+#define PV_VENUS_LATENCY_MAX_BITS       36
+#define PV_VENUS_LATENCY_BUCKETS \
+    ((PV_VENUS_LATENCY_MAX_BITS - PV_VENUS_LATENCY_SUB_BITS + 2) << PV_VENUS_LATENCY_SUB_BITS)
+
+/*
+ * Latency histogram
+ *
+ * One writer; other threads may snapshot it with pv_venus_latency_merge()
+ * while it records. Both sides use relaxed atomic accesses, so a snapshot
+ * never tears a counter, though its fields may be a few samples apart.
+ */
+struct pv_venus_latency_histogram {
+    uint64_t count;                  /* Samples recorded */
+    uint64_t sum_ns;                 /* Sum of samples, for the mean */
+    uint64_t max_ns;                 /* Largest sample */
+    uint64_t buckets[PV_VENUS_LATENCY_BUCKETS];
+};
+
+/* Summary of a histogram, for reporting */
+struct pv_venus_latency_summary {
+    uint64_t count;
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+};
+
+/*
+ * Monotonic timestamp in nanoseconds
+ *
+ * Served from the vDSO / commpage (TSC or CNTVCT underneath), so no
+ * syscall and no calibration on our side.
+ */
+static inline uint64_t pv_venus_clock_ns(void)
+{
+#if defined(__APPLE__)
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* Bucket index for a sample of @ns nanoseconds */
+static inline uint32_t pv_venus_latency_bucket(uint64_t ns)
+{
+    if (ns < (1ull << PV_VENUS_LATENCY_SUB_BITS)) {
+        return (uint32_t)ns;
+    }
+
+    uint32_t msb = 63 - (uint32_t)__builtin_clzll(ns);
+    if (msb > PV_VENUS_LATENCY_MAX_BITS) {
+        return PV_VENUS_LATENCY_BUCKETS - 1;
+    }
+
+    uint32_t shift = msb - PV_VENUS_LATENCY_SUB_BITS;
+    uint32_t sub = (uint32_t)(ns >> shift) & ((1u << PV_VENUS_LATENCY_SUB_BITS) - 1);
+    return ((shift + 1) << PV_VENUS_LATENCY_SUB_BITS) + sub;
+}
+
+/*
+ * Record one sample
+ *
+ * @hist: Histogram owned by the calling thread
+ * @ns: Latency in nanoseconds
+ */
+static inline void pv_venus_latency_record(struct pv_venus_latency_histogram *hist,
+                                           uint64_t ns)
+{
+    /* Single writer: plain load + store, no locked read-modify-write */
+    uint64_t *bucket = &hist->buckets[pv_venus_latency_bucket(ns)];
+    __atomic_store_n(bucket, __atomic_load_n(bucket, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&hist->count, hist->count + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&hist->sum_ns, hist->sum_ns + ns, __ATOMIC_RELAXED);
+    if (ns > hist->max_ns) {
+        __atomic_store_n(&hist->max_ns, ns, __ATOMIC_RELAXED);
+    }
+}
+
+/*
+ * Upper bound (inclusive) of the values counted in @bucket
+ */
+uint64_t pv_venus_latency_bucket_limit(uint32_t bucket);
+
+/*
+ * Add the samples of @src to @dst
+ *
+ * @src may be recording concurrently; @dst must belong to the caller.
+ */
+void pv_venus_latency_merge(
+    struct pv_venus_latency_histogram *dst,
+    const struct pv_venus_latency_histogram *src
+);
+
+/*
+ * Estimate a percentile
+ *
+ * @hist: Histogram
+ * @percentile: 0.0 - 100.0
+ * Returns: Upper bound of the bucket holding the percentile (ns),
+ *          capped at the largest sample; 0 if empty
+ */
+uint64_t pv_venus_latency_percentile(
+    const struct pv_venus_latency_histogram *hist,
+    double percentile
+);
+
+/*
+ * Summarize a histogram (count, mean, p50/p99/p99.9, max)
+ */
+struct pv_venus_latency_summary pv_venus_latency_summarize(
+    const struct pv_venus_latency_histogram *hist
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PV_VENUS_LATENCY_H */
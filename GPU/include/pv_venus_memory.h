@@ -0,0 +1,277 @@
+/*
+ * PearVisor - Venus Device Memory Suballocator
+ *
+ * Serves guest vkAllocateMemory calls from large host allocations
+ * ("blocks"), so the driver sees a handful of allocations instead of one
+ * per guest call. A guest allocation becomes a (block, offset) pair.
+ */
+
+#ifndef PV_VENUS_MEMORY_H
+#define PV_VENUS_MEMORY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Default size of a host allocation shared between guest allocations */
+#define PV_VENUS_MEMORY_BLOCK_SIZE      (64ull * 1024 * 1024)
+
+/*
+ * Default alignment of every guest allocation
+ *
+ * The guest may bind any resource at offset 0 of its allocation, so each
+ * suballocation must satisfy the strictest resource alignment (Apple GPU
+ * textures want a 16KB page).
+ */
+#define PV_VENUS_MEMORY_ALIGNMENT       (16u * 1024)
+
+/*
+ * Freed blocks held for reuse (scrubbed, or waiting to be)
+ *
+ * Past this, freed blocks go straight back to the backend.
+ */
+#define PV_VENUS_MEMORY_POOL_BYTES      (256ull * 1024 * 1024)
+
+/* Memory types tracked (VK_MAX_MEMORY_TYPES) */
+#define PV_VENUS_MEMORY_MAX_TYPES       32
+
+/*
+ * Allocations up to this size come from per-size-class slabs; larger ones
+ * from a TLSF allocator over the blocks; anything over half a block gets
+ * a dedicated host allocation.
+ */
+#define PV_VENUS_MEMORY_SMALL_MAX       (256u * 1024)
+
+/* Slots per slab (a slab is carved from a block like a large allocation) */
+#define PV_VENUS_MEMORY_SLAB_SLOTS      32
+
+/* TLSF: second-level subdivisions per power of 2 (log2) */
+#define PV_VENUS_MEMORY_TLSF_SL_LOG2    4
+#define PV_VENUS_MEMORY_TLSF_SL_COUNT   (1u << PV_VENUS_MEMORY_TLSF_SL_LOG2)
+#define PV_VENUS_MEMORY_TLSF_FL_COUNT   64
+
+/* Size classes: powers of 2 from the alignment up to SMALL_MAX */
+#define PV_VENUS_MEMORY_MAX_CLASSES     16
+
+/*
+ * Host allocation backend
+ *
+ * Implemented with vkAllocateMemory / vkFreeMemory by the handlers, and
+ * with plain heap memory by the tests.
+ */
+struct pv_venus_memory_backend {
+    /* Returns: 0 and the host handle in *memory, or negative on failure */
+    int (*allocate)(void *user_data, uint32_t memory_type, uint64_t size, void **memory);
+    void (*free)(void *user_data, uint32_t memory_type, void *memory);
+
+    /*
+     * Zero @size bytes of @memory (optional)
+     *
+     * Called from the recycler thread, never with the allocator lock
+     * held. When set, freed blocks are scrubbed and reused instead of
+     * going back to the backend.
+     * Returns: 0 on success, negative on failure (the block is freed)
+     */
+    int (*zero)(void *user_data, uint32_t memory_type, void *memory, uint64_t size);
+
+    void *user_data;
+};
+
+/*
+ * Host allocation shared by many guest allocations
+ */
+struct pv_venus_memory_block {
+    void *memory;                     /* Backend handle (VkDeviceMemory) */
+    uint64_t size;
+    uint64_t used;                    /* Bytes handed out (slabs count whole) */
+    uint32_t memory_type;
+    bool dedicated;                   /* Holds one large allocation */
+    struct pv_venus_memory_range *ranges;  /* By offset (NULL if dedicated) */
+
+    /* All blocks of the memory type (or the recycling list it is on) */
+    struct pv_venus_memory_block *prev;
+    struct pv_venus_memory_block *next;
+};
+
+/*
+ * Range of a block, tracked out of band (device memory isn't host readable)
+ */
+struct pv_venus_memory_range {
+    struct pv_venus_memory_block *block;
+    uint64_t offset;
+    uint64_t size;
+    bool free;
+    struct pv_venus_memory_slab *slab;     /* Slab carved from it, if any */
+
+    /* Neighbours in the block, for coalescing */
+    struct pv_venus_memory_range *prev_phys;
+    struct pv_venus_memory_range *next_phys;
+
+    /* TLSF free list (free ranges only) */
+    struct pv_venus_memory_range *prev_free;
+    struct pv_venus_memory_range *next_free;
+};
+
+/*
+ * Slab: one range split into equal slots of one size class
+ */
+struct pv_venus_memory_slab {
+    struct pv_venus_memory_range *range;
+    uint32_t size_class;
+    uint32_t free_count;
+    uint32_t free_mask;               /* Bit per slot, set = free */
+
+    /* Slabs of the class with free slots */
+    struct pv_venus_memory_slab *prev;
+    struct pv_venus_memory_slab *next;
+};
+
+/*
+ * Guest allocation: where it lives in host memory
+ */
+struct pv_venus_memory_allocation {
+    struct pv_venus_memory_block *block;
+    uint64_t offset;                  /* Within block->memory */
+    uint64_t size;                    /* Rounded up to the alignment / class */
+
+    /* Owner (exactly one set, neither for dedicated) */
+    struct pv_venus_memory_range *range;
+    struct pv_venus_memory_slab *slab;
+};
+
+/*
+ * Per-memory-type state
+ */
+struct pv_venus_memory_heap {
+    struct pv_venus_memory_block *blocks;
+    struct pv_venus_memory_block *clean;   /* Scrubbed, ready for reuse */
+
+    /* TLSF over the free ranges of every block */
+    uint64_t fl_bitmap;
+    uint32_t sl_bitmap[PV_VENUS_MEMORY_TLSF_FL_COUNT];
+    struct pv_venus_memory_range *free_lists[PV_VENUS_MEMORY_TLSF_FL_COUNT]
+                                            [PV_VENUS_MEMORY_TLSF_SL_COUNT];
+
+    /* Slabs with free slots, per size class */
+    struct pv_venus_memory_slab *slabs[PV_VENUS_MEMORY_MAX_CLASSES];
+};
+
+/* Allocator statistics */
+struct pv_venus_memory_stats {
+    uint64_t allocations;             /* Guest allocations served */
+    uint64_t frees;
+    uint64_t host_allocations;        /* Backend allocations made */
+    uint64_t host_frees;
+    uint64_t blocks;                  /* Live blocks (including dedicated) */
+    uint64_t block_bytes;             /* Host memory held by live blocks */
+    uint64_t bytes_in_use;            /* Bytes handed to the guest */
+    uint64_t scrubbed;                /* Freed blocks zeroed by the recycler */
+    uint64_t recycled;                /* Blocks reused instead of allocated */
+    uint64_t pool_blocks;             /* Freed blocks held for reuse */
+    uint64_t pool_bytes;
+};
+
+/*
+ * Device memory suballocator
+ *
+ * Thread-safe: one lock serializes allocate and free.
+ *
+ * With a zeroing backend, blocks that empty out are not freed: a recycler
+ * thread scrubs them and parks them on their heap's clean list, and the
+ * next block of that type and size comes from there without a backend
+ * call. Nothing the guest wrote is handed back out or returned to the
+ * backend unscrubbed, apart from the one spare block a heap keeps.
+ */
+struct pv_venus_memory_allocator {
+    struct pv_venus_memory_backend backend;
+    uint64_t block_size;
+    uint64_t alignment;
+    uint32_t class_count;             /* Size classes in use (alignment..SMALL_MAX) */
+
+    pthread_mutex_t lock;
+    struct pv_venus_memory_heap heaps[PV_VENUS_MEMORY_MAX_TYPES];
+
+    /* Recycler (only with backend.zero) */
+    pthread_t recycler;
+    bool recycler_running;
+    bool recycler_stop;
+    pthread_cond_t recycle_wake;      /* Dirty blocks queued, or stop */
+    pthread_cond_t recycle_idle;      /* Dirty queue drained */
+    struct pv_venus_memory_block *dirty;    /* Waiting to be zeroed */
+    struct pv_venus_memory_block *zeroing;  /* Being zeroed (lock dropped) */
+
+    struct pv_venus_memory_stats stats;
+};
+
+/*
+ * Initialize a suballocator
+ *
+ * @allocator: Allocator to initialize
+ * @backend: Host allocation functions (copied)
+ * @block_size: Bytes per shared block (0 = PV_VENUS_MEMORY_BLOCK_SIZE)
+ * @alignment: Alignment of every allocation, a power of 2
+ *             (0 = PV_VENUS_MEMORY_ALIGNMENT)
+ * Returns: 0 on success, negative on error
+ */
+int pv_venus_memory_allocator_init(struct pv_venus_memory_allocator *allocator,
+                                   const struct pv_venus_memory_backend *backend,
+                                   uint64_t block_size,
+                                   uint64_t alignment);
+
+/*
+ * Release every block back to the backend
+ *
+ * Outstanding allocations become invalid.
+ */
+void pv_venus_memory_allocator_destroy(struct pv_venus_memory_allocator *allocator);
+
+/*
+ * Allocate guest memory
+ *
+ * @memory_type: Vulkan memory type index
+ * @size: Bytes requested
+ * Returns: Allocation, or NULL on failure
+ */
+struct pv_venus_memory_allocation *pv_venus_memory_alloc(
+    struct pv_venus_memory_allocator *allocator,
+    uint32_t memory_type,
+    uint64_t size
+);
+
+/*
+ * Free guest memory (NULL is ignored)
+ */
+void pv_venus_memory_free(struct pv_venus_memory_allocator *allocator,
+                          struct pv_venus_memory_allocation *allocation);
+
+/*
+ * Return empty blocks to the backend
+ *
+ * The allocator keeps one empty block per memory type to absorb
+ * alloc/free churn, plus the recycling pool; call this before destroying
+ * the device. Empty blocks are scrubbed first, so this waits for the
+ * recycler.
+ */
+void pv_venus_memory_trim(struct pv_venus_memory_allocator *allocator);
+
+/*
+ * Wait until every freed block queued so far has been scrubbed
+ */
+void pv_venus_memory_wait_idle(struct pv_venus_memory_allocator *allocator);
+
+/*
+ * Get allocator statistics
+ */
+void pv_venus_memory_get_stats(struct pv_venus_memory_allocator *allocator,
+                               struct pv_venus_memory_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PV_VENUS_MEMORY_H */
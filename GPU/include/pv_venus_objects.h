@@ -0,0 +1,322 @@
+/*
+ * PearVisor - Venus Object Table
+ *
+ * Maps guest object IDs to host Vulkan handles
+ */
+
+#ifndef PV_VENUS_OBJECTS_H
+#define PV_VENUS_OBJECTS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Object ID type
+ *
+ * Venus uses 64-bit IDs to reference Vulkan objects.
+ * We need to map these guest IDs to host Vulkan handles.
+ */
+typedef uint64_t pv_venus_object_id;
+
+/*
+ * Object types
+ */
+typedef enum {
+    PV_VENUS_OBJECT_TYPE_INSTANCE = 0,
+    PV_VENUS_OBJECT_TYPE_PHYSICAL_DEVICE,
+    PV_VENUS_OBJECT_TYPE_DEVICE,
+    PV_VENUS_OBJECT_TYPE_QUEUE,
+    PV_VENUS_OBJECT_TYPE_SEMAPHORE,
+    PV_VENUS_OBJECT_TYPE_FENCE,
+    PV_VENUS_OBJECT_TYPE_DEVICE_MEMORY,
+    PV_VENUS_OBJECT_TYPE_BUFFER,
+    PV_VENUS_OBJECT_TYPE_IMAGE,
+    PV_VENUS_OBJECT_TYPE_COMMAND_POOL,
+    PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER,
+    PV_VENUS_OBJECT_TYPE_SHADER_MODULE,
+    PV_VENUS_OBJECT_TYPE_PIPELINE,
+    PV_VENUS_OBJECT_TYPE_COUNT
+} pv_venus_object_type;
+
+/*
+ * Object handle
+ *
+ * Host-side reference to a live object: [type:8][generation:24][slot:32].
+ * Resolving one is an index into the type's slot map plus a generation
+ * compare, so a handle kept after its object was removed (or its slot
+ * reused) is rejected without a hash lookup. Never 0 for a live object.
+ */
+typedef uint64_t pv_venus_object_handle;
+
+#define PV_VENUS_OBJECT_HANDLE_NULL     0
+#define PV_VENUS_OBJECT_GENERATION_MASK 0xFFFFFFu
+
+static inline pv_venus_object_type pv_venus_object_handle_type(pv_venus_object_handle handle)
+{
+    return (pv_venus_object_type)(handle >> 56);
+}
+
+static inline uint32_t pv_venus_object_handle_generation(pv_venus_object_handle handle)
+{
+    return (uint32_t)(handle >> 32) & PV_VENUS_OBJECT_GENERATION_MASK;
+}
+
+static inline uint32_t pv_venus_object_handle_slot(pv_venus_object_handle handle)
+{
+    return (uint32_t)handle;
+}
+
+/* Slot map slot: generation, and where the object lives in the dense arrays */
+struct pv_venus_object_slot {
+    uint32_t generation;               /* Bumped every time the slot is freed */
+    uint32_t dense;                    /* Dense index (live) or next free slot */
+};
+
+/*
+ * Ownership links, by slot (NULL handle = none)
+ *
+ * Children of one parent form a doubly linked sibling list, so detaching
+ * any object is O(1) and a whole subtree can be walked without a stack.
+ */
+struct pv_venus_object_links {
+    pv_venus_object_handle parent;
+    pv_venus_object_handle first_child;
+    pv_venus_object_handle next_sibling;
+    pv_venus_object_handle prev_sibling;
+};
+
+/*
+ * Per-type slot map
+ *
+ * Live objects of one type are packed at the front of the dense arrays
+ * (removal moves the last one into the hole), so walking all objects of
+ * a type is a linear scan:
+ *
+ *     for (uint32_t i = 0; i < map->count; i++)
+ *         destroy(map->host_handles[i]);
+ *
+ * Header and arrays are one allocation. Growing builds a bigger copy,
+ * publishes it and retires the old one, so a reader never sees an array
+ * freed under it.
+ */
+struct pv_venus_slot_map {
+    uint32_t capacity;                 /* Slots and dense entries allocated */
+    uint32_t slot_count;               /* Slots ever used */
+    uint32_t free_slot;                /* Head of free list (UINT32_MAX = empty) */
+    uint32_t count;                    /* Live objects */
+
+    /* Sparse, indexed by handle slot */
+    struct pv_venus_object_slot *slots;
+    struct pv_venus_object_links *links;
+
+    /* Dense, indexed 0..count */
+    void **host_handles;
+    pv_venus_object_id *guest_ids;
+    uint32_t *dense_slots;             /* Slot owning each dense entry */
+};
+
+/*
+ * Guest ID index entry
+ */
+struct pv_venus_object {
+    pv_venus_object_id guest_id;      /* ID from guest */
+    void *host_handle;                 /* VkInstance, VkDevice, etc (cached) */
+    pv_venus_object_handle handle;     /* Slot map handle (NULL = empty slot) */
+};
+
+/*
+ * Guest ID index array (header and slots in one allocation)
+ */
+struct pv_venus_object_index {
+    size_t capacity;                   /* Number of slots (power of 2) */
+    size_t mask;                       /* capacity - 1 */
+    struct pv_venus_object objects[];
+};
+
+/*
+ * Object table for tracking guest ID → host handle mappings
+ *
+ * Host handles live in one slot map per object type, together with
+ * parent/child ownership links. Guest IDs are
+ * chosen by the guest, so they are indexed by an open-addressing hash
+ * table with linear probing, so a lookup touches one or two adjacent
+ * cache lines. Removal shifts the rest of the probe run back instead
+ * of leaving tombstones, so lookups never slow down as objects churn.
+ *
+ * The index doubles when 7/8 of the slots are used and halves when
+ * fewer than 1/8 are (never below its initial size). Resizing is
+ * incremental: the previous array is kept and every add/remove moves
+ * at most PV_VENUS_OBJECT_TABLE_MIGRATE_STEP of its slots across, so no
+ * single call pays for a full rehash. Lookups check both arrays until
+ * the move completes.
+ *
+ * Concurrency: any number of threads may get/lookup/resolve while others
+ * add and remove. Reads are a seqlock, not lock-free: writers are
+ * serialized by @lock and keep @sequence odd while they change the
+ * table; readers take no lock but wait out an odd @sequence and re-read
+ * if it moved under them. Write sections are kept short: they never
+ * allocate, and a subtree teardown is one section per object. Arrays
+ * replaced by a resize are retired through pv_venus_epoch_retire(), so a
+ * reader still walking one stays safe.
+ */
+struct pv_venus_object_table {
+    /* Read side */
+    _Atomic(struct pv_venus_object_index *) index;
+    _Atomic(struct pv_venus_object_index *) old_index;  /* During a resize */
+    _Atomic(struct pv_venus_slot_map *) types[PV_VENUS_OBJECT_TYPE_COUNT]; /* NULL until used */
+    atomic_uint sequence;              /* Odd while a writer is mid-update */
+
+    /* Write side (under @lock) */
+    pthread_mutex_t lock;
+    size_t count;                      /* Live objects (both arrays) */
+    size_t min_capacity;               /* Never shrink below this */
+    size_t old_count;                  /* Live objects not yet moved */
+    size_t migrate_pos;                /* Next old slot to move (walks down) */
+    size_t migrate_left;               /* Old slots not yet visited */
+
+    /* Statistics */
+    uint64_t grows;
+    uint64_t shrinks;
+};
+
+/* Maximum live objects for a table with @capacity slots */
+#define PV_VENUS_OBJECT_TABLE_MAX_LOAD(capacity) ((capacity) - (capacity) / 8)
+
+/* Old slots moved per add/remove during a resize */
+#define PV_VENUS_OBJECT_TABLE_MIGRATE_STEP 32
+
+/*
+ * Object released by a subtree teardown
+ */
+struct pv_venus_object_release {
+    pv_venus_object_id guest_id;
+    void *host_handle;
+    void *parent_handle;               /* Parent's host handle (NULL = root) */
+    pv_venus_object_type type;
+};
+
+/*
+ * Initialize an object table
+ *
+ * @table: Table to initialize
+ * @max_objects: Live objects to hold before the first resize
+ * Returns: 0 on success, negative on allocation failure
+ */
+int pv_venus_object_table_init(struct pv_venus_object_table *table, size_t max_objects);
+
+/*
+ * Release an object table's storage
+ *
+ * No other thread may be using the table.
+ *
+ * @table: Table to release (host handles are not destroyed)
+ */
+void pv_venus_object_table_destroy(struct pv_venus_object_table *table);
+
+/*
+ * Object table operations
+ *
+ * Safe to call from any thread: add/remove serialize on the table lock,
+ * get/lookup/resolve never block.
+ */
+
+/*
+ * Add object to table
+ *
+ * Fails if @guest_id is already live (its host object would leak) or if
+ * the table needs to grow and memory is exhausted.
+ */
+int pv_venus_object_add(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id,
+    void *host_handle,
+    pv_venus_object_type type
+);
+
+/*
+ * Add object owned by @parent_id (destroyed with it by
+ * pv_venus_object_remove_tree)
+ *
+ * Fails like pv_venus_object_add, or if the parent is not in the table.
+ */
+int pv_venus_object_add_child(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id,
+    void *host_handle,
+    pv_venus_object_type type,
+    pv_venus_object_id parent_id
+);
+
+/* Get object from table */
+void *pv_venus_object_get(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id
+);
+
+/* Remove object from table (its children become roots) */
+void pv_venus_object_remove(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id
+);
+
+/*
+ * Remove an object and everything it owns
+ *
+ * The subtree is walked and removed in one pass under a single hold of
+ * the table lock. Host handles are not destroyed: the caller gets them
+ * back children-first, the order Vulkan needs them destroyed in.
+ *
+ * @releases: Set to a malloc'd array the caller frees (NULL if none)
+ * Returns: Number of objects removed (0 if not present or out of memory)
+ */
+size_t pv_venus_object_remove_tree(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id,
+    struct pv_venus_object_release **releases
+);
+
+/*
+ * Get the slot map handle of a guest object
+ *
+ * Returns: Handle, or PV_VENUS_OBJECT_HANDLE_NULL if not present
+ */
+pv_venus_object_handle pv_venus_object_lookup(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id
+);
+
+/*
+ * Resolve a slot map handle to the host handle
+ *
+ * Returns: Host handle, or NULL if the object has been removed
+ */
+void *pv_venus_object_resolve(
+    struct pv_venus_object_table *table,
+    pv_venus_object_handle handle
+);
+
+/*
+ * Get the guest ID of any live object of @type
+ *
+ * For draining a table: which object is returned is unspecified.
+ *
+ * Returns: true and sets @guest_id, or false if there is none
+ */
+bool pv_venus_object_any(
+    struct pv_venus_object_table *table,
+    pv_venus_object_type type,
+    pv_venus_object_id *guest_id
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PV_VENUS_OBJECTS_H */
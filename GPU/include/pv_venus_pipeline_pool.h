@@ -0,0 +1,141 @@
+/*
+ * PearVisor - Venus Asynchronous Pipeline Compilation
+ *
+ * Pipeline creation can take tens of milliseconds, which would stall
+ * every later command from the guest if done on the ring thread. The
+ * handlers instead queue the compile and hand the guest a placeholder;
+ * the first command that needs the real pipeline (a bind, a destroy)
+ * resolves it, waiting only if the compile hasn't finished by then.
+ */
+
+#ifndef PV_VENUS_PIPELINE_POOL_H
+#define PV_VENUS_PIPELINE_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Upper bound on worker threads (0 at init = online CPUs - 1, capped here) */
+#define PV_VENUS_PIPELINE_POOL_MAX_THREADS 8
+
+/*
+ * Compile callback
+ *
+ * Runs on a worker, or on the resolving thread if it gets there first.
+ * Called exactly once per job and owns @job (frees it).
+ *
+ * Returns: 0 and the pipeline in *pipeline, or negative on failure
+ */
+typedef int (*pv_venus_pipeline_compile_t)(void *job, void **pipeline);
+
+enum pv_venus_pipeline_state {
+    PV_VENUS_PIPELINE_PENDING = 0,
+    PV_VENUS_PIPELINE_READY,
+    PV_VENUS_PIPELINE_FAILED,
+};
+
+/*
+ * Placeholder for a pipeline being compiled
+ */
+struct pv_venus_pipeline {
+    _Atomic int state;                /* enum pv_venus_pipeline_state */
+    void *pipeline;                   /* VkPipeline, valid once READY */
+
+    /* Queued job (owned by the pool until it runs) */
+    pv_venus_pipeline_compile_t compile;
+    void *job;
+    bool queued;
+    struct pv_venus_pipeline *prev;
+    struct pv_venus_pipeline *next;
+};
+
+/* Pool statistics */
+struct pv_venus_pipeline_pool_stats {
+    uint64_t submitted;
+    uint64_t compiled;                /* Includes failures */
+    uint64_t failed;
+    uint64_t inline_compiles;         /* Run by a resolver that got there first */
+    uint64_t waits;                   /* Resolves that had to block */
+    uint64_t wait_ns;                 /* Total time blocked in resolve */
+    uint64_t max_queued;              /* Deepest the queue got */
+};
+
+/*
+ * Worker pool
+ */
+struct pv_venus_pipeline_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t work;              /* Jobs queued, or stop */
+    pthread_cond_t done;              /* A job finished */
+
+    /* FIFO of jobs not yet started */
+    struct pv_venus_pipeline *head;
+    struct pv_venus_pipeline *tail;
+    uint64_t queued;
+
+    pthread_t threads[PV_VENUS_PIPELINE_POOL_MAX_THREADS];
+    unsigned thread_count;
+    bool stop;
+
+    struct pv_venus_pipeline_pool_stats stats;
+};
+
+/*
+ * Start a pool
+ *
+ * @pool: Pool to initialize
+ * @threads: Worker count (0 = online CPUs - 1, at least 1), capped at
+ *           PV_VENUS_PIPELINE_POOL_MAX_THREADS
+ * Returns: 0 on success, negative on error
+ */
+int pv_venus_pipeline_pool_init(struct pv_venus_pipeline_pool *pool, unsigned threads);
+
+/*
+ * Finish every queued job and stop the workers
+ *
+ * Placeholders stay valid (resolved) until freed.
+ */
+void pv_venus_pipeline_pool_destroy(struct pv_venus_pipeline_pool *pool);
+
+/*
+ * Queue a compile
+ *
+ * @compile: Compile callback
+ * @job: Callback argument, owned by the callback from here on
+ * Returns: Pending placeholder, or NULL on failure (@job not consumed)
+ */
+struct pv_venus_pipeline *pv_venus_pipeline_compile_async(struct pv_venus_pipeline_pool *pool,
+                                                          pv_venus_pipeline_compile_t compile,
+                                                          void *job);
+
+/*
+ * Get the real pipeline, waiting for (or running) its compile
+ *
+ * A single acquire load once the pipeline is ready.
+ *
+ * Returns: Pipeline, or NULL if the compile failed
+ */
+void *pv_venus_pipeline_resolve(struct pv_venus_pipeline_pool *pool,
+                                struct pv_venus_pipeline *pipeline);
+
+/*
+ * Free a resolved placeholder (the caller destroys the pipeline itself)
+ */
+void pv_venus_pipeline_free(struct pv_venus_pipeline *pipeline);
+
+/*
+ * Get pool statistics
+ */
+void pv_venus_pipeline_pool_get_stats(struct pv_venus_pipeline_pool *pool,
+                                      struct pv_venus_pipeline_pool_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PV_VENUS_PIPELINE_POOL_H */
@@ -10,11 +10,19 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdio.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Per-command logging is too costly for the ring thread; opt in with PV_VENUS_TRACE */
+#ifdef PV_VENUS_TRACE
+#define pv_venus_trace(...) printf(__VA_ARGS__)
+#else
+#define pv_venus_trace(...) ((void)0)
+#endif
+
 /*
  * Venus Protocol Version
  */
@@ -44,7 +52,7 @@ struct pv_venus_command_header {
 
 /* Physical Device Queries */
 #define PV_VK_COMMAND_vkGetPhysicalDeviceFeatures              3   /* * */
-#define PV_VK_COMMAND_vkGetPhysicalDeviceFormatProperties      4
+#define PV_VK_COMMAND_vkGetPhysicalDeviceFormatProperties      4   /* * */
 #define PV_VK_COMMAND_vkGetPhysicalDeviceImageFormatProperties 5
 #define PV_VK_COMMAND_vkGetPhysicalDeviceProperties            6   /* * */
 #define PV_VK_COMMAND_vkGetPhysicalDeviceQueueFamilyProperties 7   /* * */
@@ -72,9 +80,9 @@ struct pv_venus_command_header {
 
 /* Synchronization */
 #define PV_VK_COMMAND_vkCreateFence                           35   /* * */
-#define PV_VK_COMMAND_vkDestroyFence                          36
-#define PV_VK_COMMAND_vkResetFences                           37
-#define PV_VK_COMMAND_vkGetFenceStatus                        38
+#define PV_VK_COMMAND_vkDestroyFence                          36   /* * */
+#define PV_VK_COMMAND_vkResetFences                           37   /* * */
+#define PV_VK_COMMAND_vkGetFenceStatus                        38   /* * */
 #define PV_VK_COMMAND_vkWaitForFences                         39   /* * */
 #define PV_VK_COMMAND_vkCreateSemaphore                       40   /* * */
 #define PV_VK_COMMAND_vkDestroySemaphore                      41
@@ -118,6 +126,138 @@ struct pv_venus_command_header {
 #define PV_VK_COMMAND_vkCmdBeginRenderPass                   133
 #define PV_VK_COMMAND_vkCmdEndRenderPass                     135
 
+/*
+ * vkCreateShaderModule payload
+ * 
+ * Followed by code_size bytes of SPIR-V.
+ */
+struct pv_venus_create_shader_module {
+    uint64_t shader_module_id;  /* Guest handle */
+    uint64_t code_size;         /* Bytes, a multiple of 4 */
+};
+
+/*
+ * vkDestroyShaderModule payload
+ */
+struct pv_venus_destroy_shader_module {
+    uint64_t shader_module_id;
+};
+
+/*
+ * vkCreateComputePipelines payload (one pipeline, entry point "main")
+ */
+struct pv_venus_create_compute_pipeline {
+    uint64_t pipeline_id;       /* Guest handle */
+    uint64_t shader_module_id;
+};
+
+/*
+ * vkDestroyPipeline payload
+ */
+struct pv_venus_destroy_pipeline {
+    uint64_t pipeline_id;
+};
+
+/*
+ * vkCmdBindPipeline payload
+ */
+struct pv_venus_cmd_bind_pipeline {
+    uint64_t command_buffer_id;
+    uint64_t pipeline_id;
+    uint32_t bind_point;        /* VkPipelineBindPoint */
+    uint32_t _padding;
+};
+
+/*
+ * vkGetPhysicalDeviceFormatProperties payload (reply: VkFormatProperties)
+ */
+struct pv_venus_get_format_properties {
+    uint32_t format;            /* VkFormat */
+    uint32_t _padding;
+};
+
+/*
+ * vkGetPhysicalDeviceQueueFamilyProperties reply
+ *
+ * Followed by count VkQueueFamilyProperties.
+ */
+struct pv_venus_queue_family_properties {
+    uint32_t count;
+    uint32_t _padding;
+};
+
+/*
+ * vkGetDeviceQueue payload
+ */
+struct pv_venus_get_device_queue {
+    uint64_t queue_id;          /* Guest handle */
+    uint32_t queue_family_index;
+    uint32_t queue_index;
+};
+
+/*
+ * vkQueueSubmit payload (one batch)
+ * 
+ * Followed by command_buffer_count command buffer IDs (uint64_t), then
+ * wait_semaphore_count pv_venus_submit_wait entries, then
+ * signal_semaphore_count semaphore IDs (uint64_t). An empty payload
+ * submits the fixed command buffer 0x9000, as before batching. Until
+ * semaphores are tracked, both semaphore counts must be 0.
+ * 
+ * Each vkQueueSubmit command is numbered (from 1, per context); the
+ * completion page reports progress in those numbers.
+ */
+struct pv_venus_queue_submit {
+    uint64_t queue_id;          /* 0 = graphics queue */
+    uint64_t fence_id;          /* 0 = no fence */
+    uint32_t command_buffer_count;
+    uint32_t wait_semaphore_count;
+    uint32_t signal_semaphore_count;
+    uint32_t _padding;
+};
+
+struct pv_venus_submit_wait {
+    uint64_t semaphore_id;
+    uint32_t stage_mask;        /* VkPipelineStageFlags */
+    uint32_t _padding;
+};
+
+/*
+ * vkCreateFence payload
+ * 
+ * The guest picks the fence's slot in its completion page.
+ */
+struct pv_venus_create_fence {
+    uint64_t fence_id;          /* Guest handle */
+    uint32_t slot;              /* Index into pv_venus_completion_page.fences */
+    uint32_t flags;             /* VkFenceCreateFlags */
+};
+
+/*
+ * vkDestroyFence / vkGetFenceStatus payload
+ */
+struct pv_venus_fence_command {
+    uint64_t fence_id;
+};
+
+/*
+ * vkResetFences / vkWaitForFences payload
+ * 
+ * Followed by fence_count fence IDs (uint64_t). vkResetFences ignores
+ * wait_all and timeout_ns.
+ * 
+ * The host waits at most PV_VENUS_FENCE_WAIT_MAX_NS of timeout_ns, since
+ * nothing else is decoded meanwhile; VK_TIMEOUT before the guest's own
+ * deadline means keep waiting on the fences' completion page slots.
+ */
+#define PV_VENUS_FENCE_WAIT_MAX_NS  (2ull * 1000 * 1000)
+
+struct pv_venus_fence_list {
+    uint32_t fence_count;
+    uint32_t wait_all;          /* VkBool32 */
+    uint64_t timeout_ns;
+};
+
 /*
  * Maximum command ID we support (for array bounds)
  */
@@ -125,6 +265,9 @@ struct pv_venus_command_header {
 
 /*
  * Command handler function type
+ * 
+ * @data usually points directly into ring memory and is only valid
+ * for the duration of the call. Handlers must copy anything they keep.
  */
 typedef int (*pv_venus_command_handler_t)(
     void *context,
@@ -0,0 +1,131 @@
+/*
+ * PearVisor - Venus Physical Device Query Cache
+ *
+ * Guest drivers re-query the physical device all the time: properties
+ * and features on every instance, and every format one by one while
+ * building their format tables. None of it changes once the device is
+ * picked, so every reply is serialized once, when the physical device is
+ * selected, into a single allocation. Answering a query is then a lookup
+ * and a memcpy into the reply ring, with no driver call.
+ *
+ * vkGetPhysicalDeviceFormatProperties is served from a table covering
+ * every core format. Formats past it (extensions) miss and fall back to
+ * the driver.
+ */
+
+#ifndef PV_VENUS_QUERY_CACHE_H
+#define PV_VENUS_QUERY_CACHE_H
+
+#include "pv_venus_protocol.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <vulkan/vulkan.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Every Vulkan 1.0 format: the table is indexed by VkFormat */
+#define PV_VENUS_QUERY_FORMAT_COUNT   (VK_FORMAT_ASTC_12x12_SRGB_BLOCK + 1)
+
+/* Query commands are the low command IDs; replies are indexed by them */
+#define PV_VENUS_QUERY_COMMAND_COUNT  (PV_VK_COMMAND_vkGetPhysicalDeviceMemoryProperties + 1)
+
+/*
+ * Format backend: the real vkGetPhysicalDeviceFormatProperties (faked by
+ * the tests), called once per format while building
+ */
+struct pv_venus_query_backend {
+    void (*format_properties)(void *user_data, VkFormat format, VkFormatProperties *properties);
+    void *user_data;
+};
+
+/*
+ * What the selected physical device reported
+ */
+struct pv_venus_query_device {
+    const VkPhysicalDeviceProperties *properties;
+    const VkPhysicalDeviceFeatures *features;
+    const VkPhysicalDeviceMemoryProperties *memory_properties;
+    const VkQueueFamilyProperties *queue_families;
+    uint32_t queue_family_count;
+};
+
+/* One serialized reply */
+struct pv_venus_query_blob {
+    const void *data;
+    size_t size;
+};
+
+/* Cache statistics */
+struct pv_venus_query_cache_stats {
+    uint64_t hits;                    /* Queries answered from the cache */
+    uint64_t misses;                  /* Queries left to the driver */
+    uint64_t bytes_served;
+    uint64_t bytes_cached;            /* Size of every serialized reply */
+};
+
+/*
+ * Reply cache for one physical device
+ *
+ * Zero-initialized is a valid, empty cache (every lookup misses).
+ */
+struct pv_venus_query_cache {
+    uint8_t *storage;                 /* Every reply, one allocation */
+    size_t storage_size;
+
+    /* Fixed replies by command ID (size 0 = not cached) */
+    struct pv_venus_query_blob replies[PV_VENUS_QUERY_COMMAND_COUNT];
+
+    /* vkGetPhysicalDeviceFormatProperties replies, by VkFormat */
+    const VkFormatProperties *formats;
+
+    struct pv_venus_query_cache_stats stats;
+};
+
+/*
+ * Serialize every query reply for a physical device
+ *
+ * Replaces whatever the cache held before.
+ *
+ * @cache: Cache (zero-initialized or previously built)
+ * @device: Captured device state (copied)
+ * @backend: Format query, called PV_VENUS_QUERY_FORMAT_COUNT times
+ * Returns: 0 on success, negative on error (cache left empty)
+ */
+int pv_venus_query_cache_build(struct pv_venus_query_cache *cache,
+                               const struct pv_venus_query_device *device,
+                               const struct pv_venus_query_backend *backend);
+
+/*
+ * Free the serialized replies (cache is empty again)
+ */
+void pv_venus_query_cache_destroy(struct pv_venus_query_cache *cache);
+
+/*
+ * Find the reply to a query command
+ *
+ * @command_id: Query command
+ * @data: Command payload (pv_venus_get_format_properties for formats)
+ * @data_size: Payload size
+ * @blob: Reply to copy out on a hit (valid until the next build/destroy)
+ * Returns: 0 on a hit, -1 on a miss
+ */
+int pv_venus_query_cache_lookup(struct pv_venus_query_cache *cache,
+                                uint32_t command_id,
+                                const void *data,
+                                size_t data_size,
+                                struct pv_venus_query_blob *blob);
+
+/*
+ * Get cache statistics
+ */
+void pv_venus_query_cache_get_stats(const struct pv_venus_query_cache *cache,
+                                    struct pv_venus_query_cache_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PV_VENUS_QUERY_CACHE_H */
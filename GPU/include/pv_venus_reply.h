@@ -0,0 +1,207 @@
+/*
+ * PearVisor - Venus Reply Ring
+ *
+ * Host-to-guest ring carrying results of query commands
+ * (vkGetPhysicalDeviceProperties etc.) back to the guest.
+ */
+
+#ifndef PV_VENUS_REPLY_H
+#define PV_VENUS_REPLY_H
+
+#include "pv_venus_ring.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Replies are padded to this alignment (and never straddle the wrap) */
+#define PV_VENUS_REPLY_ALIGN            16
+
+/* command_id of a filler record: skip reply_size bytes to reach offset 0 */
+#define PV_VENUS_REPLY_PADDING          0xFFFFFFFFu
+
+/*
+ * Reply header
+ *
+ * Every reply starts with this header, followed by the payload. A reply
+ * is always contiguous in the buffer, so the guest copies it out with a
+ * single memcpy.
+ */
+struct pv_venus_reply_header {
+    uint32_t command_id;      /* Command being answered */
+    uint32_t reply_size;      /* Total size including header, aligned */
+    uint32_t sequence;        /* Reply number, for in-order matching */
+    int32_t result;           /* VkResult (or negative handler error) */
+};
+
+/* Reply ring statistics */
+struct pv_venus_reply_stats {
+    uint64_t replies;                /* Replies published */
+    uint64_t bytes_written;          /* Bytes published, including padding */
+    uint64_t paddings;               /* Filler records emitted at the wrap */
+    uint64_t overflows;              /* Replies dropped for lack of space */
+    uint64_t doorbells;              /* Doorbells rung */
+};
+
+/*
+ * Doorbell callback
+ *
+ * Rung after a reply is published while the guest has set
+ * PV_VENUS_RING_STATUS_NEED_NOTIFY (i.e. it is asleep waiting for one).
+ */
+typedef void (*pv_venus_reply_doorbell_t)(void *user_data);
+
+/*
+ * Venus reply ring
+ *
+ * Same control layout as the command ring (pv_venus_ring_layout) with the
+ * roles swapped: the host produces at tail, the guest consumes at head.
+ * Both are free-running sequences.
+ */
+struct pv_venus_reply_ring {
+    /* Control words in shared memory */
+    const volatile atomic_uint *head;/* Guest read sequence (guest writes) */
+    volatile atomic_uint *tail;      /* Host write sequence (we write) */
+    volatile atomic_uint *status;    /* NEED_NOTIFY set by a waiting guest */
+
+    /* Data region */
+    uint8_t *data;
+    uint32_t size;                   /* Power of 2 */
+    uint32_t mask;
+
+    /* Next reply number */
+    uint32_t sequence;
+
+    /* Guest notification */
+    pv_venus_reply_doorbell_t doorbell;
+    void *doorbell_data;
+
+    /* Statistics */
+    struct pv_venus_reply_stats stats;
+};
+
+/*
+ * Reply encoder
+ *
+ * Serializes one reply in place. Between begin and end the reply is
+ * invisible to the guest; end publishes it with a single tail store.
+ */
+struct pv_venus_reply_encoder {
+    struct pv_venus_reply_ring *ring;
+    struct pv_venus_reply_header *header;  /* Header slot in ring memory */
+    uint8_t *payload;                      /* Payload start in ring memory */
+    size_t capacity;                       /* Payload bytes reserved */
+    size_t size;                           /* Payload bytes encoded so far */
+    uint32_t start;                        /* Sequence of header (after padding) */
+};
+
+/*
+ * Create a reply ring
+ *
+ * Uses head/tail/status/buffer from @layout; the extra region, wait
+ * policy and head batching fields are ignored.
+ *
+ * @layout: Memory layout (see pv_venus_ring_layout_init)
+ * Returns: Allocated reply ring, or NULL on failure
+ */
+struct pv_venus_reply_ring *pv_venus_reply_ring_create(
+    const struct pv_venus_ring_layout *layout
+);
+
+/*
+ * Destroy a reply ring
+ *
+ * @ring: Reply ring to destroy
+ */
+void pv_venus_reply_ring_destroy(struct pv_venus_reply_ring *ring);
+
+/*
+ * Set the doorbell used to wake a waiting guest
+ *
+ * @ring: Reply ring
+ * @doorbell: Callback (NULL = guest polls)
+ * @user_data: Passed to @doorbell
+ */
+void pv_venus_reply_set_doorbell(
+    struct pv_venus_reply_ring *ring,
+    pv_venus_reply_doorbell_t doorbell,
+    void *user_data
+);
+
+/*
+ * Begin a reply
+ *
+ * Reserves a contiguous slot for a header plus up to @max_size payload
+ * bytes. If the slot would straddle the wrap, a padding record fills the
+ * rest of the buffer and the reply starts at offset 0.
+ *
+ * @ring: Reply ring
+ * @encoder: Encoder to initialize
+ * @command_id: Command being answered
+ * @max_size: Maximum payload size
+ * Returns: 0 on success, negative if the guest has not freed enough space
+ */
+int pv_venus_reply_begin(
+    struct pv_venus_reply_ring *ring,
+    struct pv_venus_reply_encoder *encoder,
+    uint32_t command_id,
+    size_t max_size
+);
+
+/*
+ * Reserve payload bytes for in-place serialization
+ *
+ * @encoder: Encoder from pv_venus_reply_begin
+ * @size: Number of bytes
+ * Returns: Pointer into guest-visible ring memory, or NULL if the
+ *          reply's capacity would be exceeded
+ */
+void *pv_venus_reply_reserve(struct pv_venus_reply_encoder *encoder, size_t size);
+
+/*
+ * Append bytes to the payload
+ *
+ * @encoder: Encoder from pv_venus_reply_begin
+ * @data: Source bytes
+ * @size: Number of bytes
+ * Returns: 0 on success, negative if capacity would be exceeded
+ */
+int pv_venus_reply_write(
+    struct pv_venus_reply_encoder *encoder,
+    const void *data,
+    size_t size
+);
+
+/*
+ * Finish and publish a reply
+ *
+ * Fills in the header, publishes tail and rings the doorbell if the
+ * guest asked for one.
+ *
+ * @encoder: Encoder from pv_venus_reply_begin
+ * @result: Result reported to the guest
+ */
+void pv_venus_reply_end(struct pv_venus_reply_encoder *encoder, int32_t result);
+
+/*
+ * Get number of bytes the host may still write
+ *
+ * @ring: Reply ring
+ * Returns: Free space in bytes
+ */
+static inline uint32_t pv_venus_reply_space(const struct pv_venus_reply_ring *ring)
+{
+    uint32_t head = atomic_load_explicit(ring->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(ring->tail, memory_order_relaxed);
+    return ring->size - (tail - head);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PV_VENUS_REPLY_H */
@@ -12,6 +12,7 @@
 #include <stdatomic.h>
 #include <stdbool.h>
 #include <pthread.h>
+#include "pv_venus_latency.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,11 +22,50 @@ extern "C" {
 #define PV_VENUS_RING_STATUS_IDLE       0x0
 #define PV_VENUS_RING_STATUS_RUNNING    0x1
 #define PV_VENUS_RING_STATUS_ERROR      0x2
+#define PV_VENUS_RING_STATUS_NEED_NOTIFY 0x4 /* Renderer parked, guest must notify */
 
-/* Ring buffer control region */
+/*
+ * Error reset protocol
+ * 
+ * The renderer sets PV_VENUS_RING_STATUS_ERROR when a command can't be
+ * framed and decodes nothing more. To reset, the guest stops writing,
+ * clears the bit and notifies. The renderer then drops everything up to
+ * the tail it sees and publishes that as the head; the guest writes again
+ * once head has caught up with its tail.
+ */
+
+/*
+ * Control region layout versions
+ * 
+ * PACKED puts head, tail and status in the first 12 bytes, so the guest
+ * writing tail and the host writing head bounce the same cache line.
+ * ISOLATED gives each word its own cache line. The gain has not been
+ * measured yet; bench_venus_ring_layout compares the two on 2+ cores.
+ */
+#define PV_VENUS_RING_LAYOUT_PACKED     1
+#define PV_VENUS_RING_LAYOUT_ISOLATED   2
+
+/* Destructive interference size (Apple cores use 128-byte lines) */
+#if defined(__APPLE__) && defined(__aarch64__)
+#define PV_VENUS_RING_CACHE_LINE_SIZE   128
+#else
+#define PV_VENUS_RING_CACHE_LINE_SIZE   64
+#endif
+
+/* Control words ahead of the buffer in an ISOLATED layout: one line each */
+#define PV_VENUS_RING_ISOLATED_CONTROL_SIZE  (3 * PV_VENUS_RING_CACHE_LINE_SIZE)
+
+/*
+ * Ring buffer control region
+ * 
+ * head and tail are free-running 32-bit byte counters: they only ever
+ * increase (wrapping at 2^32) and are masked with buffer.mask at access
+ * time. tail - head is the occupancy, so a full ring (tail - head ==
+ * size) is distinct from an empty one and the guest may fill all of it.
+ */
 struct pv_venus_ring_control {
-    volatile atomic_uint *head;      /* Renderer position (we write) */
-    const volatile atomic_uint *tail;/* Guest position (guest writes) */
+    volatile atomic_uint *head;      /* Renderer sequence (we write) */
+    const volatile atomic_uint *tail;/* Guest sequence (guest writes) */
     volatile atomic_uint *status;    /* Ring status flags */
 };
 
@@ -33,8 +73,9 @@ struct pv_venus_ring_control {
 struct pv_venus_ring_buffer {
     uint32_t size;                   /* Buffer size (must be power of 2) */
     uint32_t mask;                   /* size - 1, for fast wrapping */
-    uint32_t current_pos;            /* Current read position */
+    uint32_t current_pos;            /* Current read sequence (free-running) */
     const uint8_t *data;             /* Pointer to buffer data */
+    bool mirrored;                   /* data[size..2*size) aliases data[0..size) */
 };
 
 /* Ring buffer extra region (for large structures) */
@@ -44,12 +85,101 @@ struct pv_venus_ring_extra {
     size_t offset;                   /* Current offset */
 };
 
+/*
+ * Per-ring scratch arena (host-private)
+ * 
+ * Handlers carve large temporaries (pNext chains, handle arrays) out of
+ * it instead of the heap: reserve an upper bound, commit what was used.
+ * Everything is released at once when pv_venus_decode_all finishes a
+ * drain. Host memory, never the guest-shared extra region, so nothing
+ * placed here is visible to or writable by the guest. Allocated on first
+ * use and never grown; a request that doesn't fit fails and the caller
+ * falls back to malloc.
+ */
+#define PV_VENUS_RING_ARENA_SIZE        (64 * 1024)
+
+struct pv_venus_ring_arena {
+    uint8_t *data;                   /* NULL until first reserve */
+    size_t size;                     /* Bytes allocated */
+    size_t offset;                   /* Bump pointer */
+    size_t reserved_offset;          /* Aligned start of pending reservation */
+    size_t reserved;                 /* Bytes reserved but not yet committed */
+    size_t high_water;               /* Largest offset reached */
+    uint64_t allocations;            /* Commits */
+    uint64_t exhausted;              /* Reservations that didn't fit */
+    uint64_t resets;                 /* Resets that released something */
+};
+
 /* Ring buffer statistics */
 struct pv_venus_ring_stats {
     uint64_t commands_processed;     /* Total commands processed */
     uint64_t bytes_read;             /* Total bytes read from ring */
     uint64_t errors;                 /* Number of errors encountered */
     uint64_t waits;                  /* Number of times we waited for data */
+    uint64_t zero_copy_views;        /* Views served directly from ring memory */
+    uint64_t wrap_copies;            /* Views that straddled the wrap and were copied */
+    uint64_t spins;                  /* Waits satisfied while spinning */
+    uint64_t yields;                 /* Waits satisfied after yielding the CPU */
+    uint64_t parks;                  /* Times the thread blocked in the kernel */
+    
+    /* Bumped by whichever thread rings the doorbell: relaxed atomics */
+    _Atomic uint64_t notifies;       /* Notifications that woke the thread */
+    _Atomic uint64_t notifies_suppressed; /* Notifications skipped (thread awake) */
+    
+    uint64_t head_publishes;         /* Head updates made visible to the guest */
+    uint64_t recoveries;             /* Error resets honoured */
+    
+    /* Tail observed -> handler returned, all commands */
+    struct pv_venus_latency_histogram queue_latency;
+};
+
+/*
+ * Ring wait policy
+ * 
+ * When the ring is empty the processing thread spins on the tail with CPU
+ * pause hints, then polls with sched_yield(), and only then parks in the
+ * kernel (futex on the tail word on Linux, condition variable elsewhere).
+ * 
+ * Zero spin or yield iterations skip that phase, so {0, 0, timeout}
+ * parks straight away (PV_VENUS_RING_WAIT_POLICY_PARK). A zero park
+ * timeout is never valid, so it marks an unset policy: any policy with
+ * park_timeout_ms == 0, a zeroed one included, selects
+ * PV_VENUS_RING_WAIT_POLICY_DEFAULT.
+ */
+struct pv_venus_ring_wait_policy {
+    uint32_t spin_iterations;        /* Busy-poll iterations before yielding */
+    uint32_t yield_iterations;       /* sched_yield() polls before parking */
+    uint32_t park_timeout_ms;        /* Max time parked before re-checking (0 = unset) */
+};
+
+#define PV_VENUS_RING_WAIT_POLICY_DEFAULT \
+    ((struct pv_venus_ring_wait_policy){  \
+        .spin_iterations = 2000,          \
+        .yield_iterations = 64,           \
+        .park_timeout_ms = 1000,          \
+    })
+
+/* No spinning or yielding: for hosts where a polling thread costs more than a wakeup */
+#define PV_VENUS_RING_WAIT_POLICY_PARK    \
+    ((struct pv_venus_ring_wait_policy){  \
+        .spin_iterations = 0,             \
+        .yield_iterations = 0,            \
+        .park_timeout_ms = 1000,          \
+    })
+
+/*
+ * Ring buffer view
+ *
+ * Read-only window onto the next bytes of the ring. When the range is
+ * contiguous in the data region, data points straight into ring memory;
+ * when it straddles the wrap point the bytes are linearized into the
+ * ring's scratch buffer instead. Valid until the next acquire or until
+ * head is published past it.
+ */
+struct pv_venus_ring_view {
+    const void *data;                /* Contiguous bytes */
+    size_t size;                     /* Number of bytes in view */
+    bool copied;                     /* True if served from scratch buffer */
 };
 
 /* Venus ring buffer */
@@ -65,10 +195,32 @@ struct pv_venus_ring {
     pthread_cond_t cond;
     bool running;
     
+    /* Idle wait behaviour */
+    struct pv_venus_ring_wait_policy wait_policy;
+    
+    /* Head publication granularity during a drain (0 = criterion unused) */
+    uint32_t head_batch_bytes;
+    uint32_t head_batch_commands;
+    
+    /* Shared memory owned by the ring (NULL if caller-provided) */
+    void *mapping;
+    size_t mapping_size;
+    int mapping_fd;
+    
+    /* Linearization buffer for views that straddle the wrap */
+    uint8_t *scratch;
+    size_t scratch_size;
+    
+    /* Decoding lost its place; cleared by pv_venus_ring_recover */
+    bool framing_lost;
+    
+    /* Handler temporaries, reset after every drain */
+    struct pv_venus_ring_arena arena;
+    
     /* Statistics */
     struct pv_venus_ring_stats stats;
     
-    /* Context for command dispatch */
+    /* Context for command dispatch (struct pv_venus_dispatch_context) */
     void *dispatch_context;
 };
 
@@ -78,16 +230,54 @@ struct pv_venus_ring_layout {
     void *shared_memory;
     size_t shared_memory_size;
     
+    /* Control region layout (0 = PACKED) and its cache line size */
+    uint32_t version;
+    uint32_t cache_line_size;
+    
     /* Region offsets in shared memory */
     size_t head_offset;
     size_t tail_offset;
     size_t status_offset;
     size_t buffer_offset;
     size_t buffer_size;
+    bool buffer_mirrored;            /* Buffer is mapped twice back to back */
     size_t extra_offset;
     size_t extra_size;
+    
+    /* Processing thread wait policy (park_timeout_ms == 0 = default) */
+    struct pv_venus_ring_wait_policy wait_policy;
+    
+    /*
+     * Publish head every head_batch_bytes bytes or head_batch_commands
+     * commands, whichever comes first, so the guest can reuse ring space
+     * during long drains. Both zero = buffer_size / 4 bytes.
+     */
+    uint32_t head_batch_bytes;
+    uint32_t head_batch_commands;
 };
 
+/*
+ * Compute region offsets for a layout version
+ * 
+ * Fills @layout for a region of @size bytes at @memory: the control
+ * words first (packed or one per cache line), then the largest
+ * power-of-2 buffer that fits. Other fields are left zeroed.
+ * 
+ * @layout: Layout to fill
+ * @memory: Shared memory region
+ * @size: Size of region in bytes
+ * @version: PV_VENUS_RING_LAYOUT_PACKED or PV_VENUS_RING_LAYOUT_ISOLATED
+ * @cache_line_size: Line size for ISOLATED (0 = PV_VENUS_RING_CACHE_LINE_SIZE)
+ * Returns: 0 on success, negative if the region is too small
+ */
+int pv_venus_ring_layout_init(
+    struct pv_venus_ring_layout *layout,
+    void *memory,
+    size_t size,
+    uint32_t version,
+    uint32_t cache_line_size
+);
+
 /*
  * Create a Venus ring buffer
  * 
@@ -100,6 +290,23 @@ struct pv_venus_ring *pv_venus_ring_create(
     void *dispatch_context
 );
 
+/*
+ * Create a Venus ring buffer in a mirror-mapped shared memory region
+ * 
+ * Allocates [control page][buffer][buffer again], where the second copy
+ * of the buffer is a second mapping of the same pages. Any range of up
+ * to buffer_size bytes is then contiguous, so no command ever straddles
+ * the wrap. Falls back to the plain layout if the platform refuses the
+ * double mapping.
+ * 
+ * The ring owns the region and releases it in pv_venus_ring_destroy.
+ * ring->mapping_fd can be handed to the VMM to share it with the guest.
+ * 
+ * @buffer_size: Buffer size in bytes (power of 2, multiple of page size)
+ * Returns: Ring buffer, or NULL on failure
+ */
+struct pv_venus_ring *pv_venus_ring_create_mirrored(uint32_t buffer_size);
+
 /*
  * Destroy a Venus ring buffer
  * 
@@ -110,6 +317,9 @@ void pv_venus_ring_destroy(struct pv_venus_ring *ring);
 /*
  * Start ring buffer processing thread
  * 
+ * The thread decodes and dispatches commands through dispatch_context.
+ * Without a dispatch context, incoming data is discarded.
+ * 
  * @ring: Ring buffer to start
  * Returns: 0 on success, negative on failure
  */
@@ -123,9 +333,24 @@ int pv_venus_ring_start(struct pv_venus_ring *ring);
  */
 int pv_venus_ring_stop(struct pv_venus_ring *ring);
 
+/*
+ * Resume decoding after the guest resets an error
+ * 
+ * Once PV_VENUS_RING_STATUS_ERROR is cleared, realigns head to the tail
+ * if a framing error left the decode position inside garbage. Called by
+ * the processing thread before every drain.
+ * 
+ * @ring: Ring buffer
+ * Returns: true if the ring can be decoded, false while it is in error
+ */
+bool pv_venus_ring_recover(struct pv_venus_ring *ring);
+
 /*
  * Notify ring that new commands are available
  * 
+ * A no-op while the processing thread is awake: it only wakes the thread
+ * (one syscall) if PV_VENUS_RING_STATUS_NEED_NOTIFY is set in status.
+ * 
  * @ring: Ring buffer to notify
  */
 void pv_venus_ring_notify(struct pv_venus_ring *ring);
@@ -140,6 +365,24 @@ void pv_venus_ring_notify(struct pv_venus_ring *ring);
  */
 int pv_venus_ring_read(struct pv_venus_ring *ring, void *data, size_t size);
 
+/*
+ * Acquire a zero-copy view of the next bytes in the ring
+ * 
+ * Consumes @size bytes (advances the read position) and fills @view with
+ * a pointer to them. No copy is made unless the range wraps, and never
+ * on a mirrored buffer.
+ * 
+ * @ring: Ring buffer to read from
+ * @size: Number of bytes to view
+ * @view: Filled on success
+ * Returns: 0 on success, negative if @size exceeds available data
+ */
+int pv_venus_ring_view_acquire(
+    struct pv_venus_ring *ring,
+    size_t size,
+    struct pv_venus_ring_view *view
+);
+
 /*
  * Get pointer to data in extra region
  * 
@@ -154,6 +397,48 @@ const void *pv_venus_ring_get_extra(
     size_t size
 );
 
+/*
+ * Reserve space in a ring arena
+ * 
+ * Returns a pointer to at least @size bytes aligned to @align, without
+ * consuming them. Follow with pv_venus_ring_arena_commit() for the bytes
+ * actually used. A new reserve replaces any uncommitted one.
+ * 
+ * @arena: Arena (from the ring being decoded)
+ * @size: Maximum number of bytes needed
+ * @align: Alignment (power of 2, 0 = 16)
+ * Returns: Pointer valid until the next reset, or NULL if it doesn't fit
+ */
+void *pv_venus_ring_arena_reserve(
+    struct pv_venus_ring_arena *arena,
+    size_t size,
+    size_t align
+);
+
+/*
+ * Commit bytes from the last reservation
+ * 
+ * @arena: Arena
+ * @size: Bytes used (at most the reserved size)
+ */
+void pv_venus_ring_arena_commit(struct pv_venus_ring_arena *arena, size_t size);
+
+/*
+ * Allocate from a ring arena (reserve + commit)
+ * 
+ * Returns: Pointer valid until the next reset, or NULL if it doesn't fit
+ */
+void *pv_venus_ring_arena_alloc(
+    struct pv_venus_ring_arena *arena,
+    size_t size,
+    size_t align
+);
+
+/*
+ * Release everything allocated from a ring arena (keeps the memory)
+ */
+void pv_venus_ring_arena_reset(struct pv_venus_ring_arena *arena);
+
 /*
  * Get current head position
  * 
@@ -187,23 +472,73 @@ static inline void pv_venus_ring_set_head(struct pv_venus_ring *ring, uint32_t n
     atomic_store_explicit(ring->control.head, new_head, memory_order_release);
 }
 
+/*
+ * Check whether the guest needs to notify after publishing a new tail
+ * 
+ * The renderer sets PV_VENUS_RING_STATUS_NEED_NOTIFY only while parked;
+ * while it is draining, doorbells can be skipped entirely. The caller
+ * must order its tail store before this load (seq_cst fence).
+ * 
+ * @ring: Ring buffer
+ * Returns: true if pv_venus_ring_notify must be called
+ */
+static inline bool pv_venus_ring_needs_notify(const struct pv_venus_ring *ring)
+{
+    return atomic_load_explicit(ring->control.status, memory_order_relaxed) &
+           PV_VENUS_RING_STATUS_NEED_NOTIFY;
+}
+
+/*
+ * Wrap-safe sequence arithmetic
+ * 
+ * All correct as long as the two sequences are less than 2^31 apart,
+ * which always holds since the ring is at most 2^31 bytes.
+ */
+
+/* Bytes from sequence @from to sequence @to */
+static inline uint32_t pv_venus_ring_seq_distance(uint32_t from, uint32_t to)
+{
+    return to - from;
+}
+
+/* True if sequence @a comes before sequence @b */
+static inline bool pv_venus_ring_seq_before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+/* Offset of sequence @seq within the buffer */
+static inline uint32_t pv_venus_ring_seq_offset(const struct pv_venus_ring *ring,
+                                                uint32_t seq)
+{
+    return seq & ring->buffer.mask;
+}
+
 /*
  * Get number of bytes available to read
  * 
  * @ring: Ring buffer
- * Returns: Number of bytes available
+ * Returns: Number of bytes available (buffer.size when full)
  */
 static inline uint32_t pv_venus_ring_available(const struct pv_venus_ring *ring)
 {
-    uint32_t tail = pv_venus_ring_get_tail(ring);
-    uint32_t head = ring->buffer.current_pos;
-    
-    /* Handle wrapping */
-    if (tail >= head) {
-        return tail - head;
-    } else {
-        return ring->buffer.size - head + tail;
-    }
+    return pv_venus_ring_seq_distance(ring->buffer.current_pos,
+                                      pv_venus_ring_get_tail(ring));
+}
+
+/*
+ * Get number of bytes the guest may still write
+ * 
+ * Computed from the published head, i.e. what the guest can see.
+ * 
+ * @ring: Ring buffer
+ * Returns: Free space in bytes (buffer.size when empty)
+ */
+static inline uint32_t pv_venus_ring_space(const struct pv_venus_ring *ring)
+{
+    return ring->buffer.size -
+           pv_venus_ring_seq_distance(pv_venus_ring_get_head(ring),
+                                      pv_venus_ring_get_tail(ring));
 }
 
 #ifdef __cplusplus
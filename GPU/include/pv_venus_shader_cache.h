@@ -0,0 +1,136 @@
+/*
+ * PearVisor - Venus Shader Module Cache
+ *
+ * Content-addressed SPIR-V cache: identical code uploaded on the same
+ * VkDevice maps to one refcounted host shader module. Every guest context
+ * currently opens its own device, so this dedupes repeated uploads within
+ * a context (apps and engines re-create the same modules freely); it is
+ * not shared across guests.
+ * Entries are keyed by a 64-bit hash of the code and confirmed with a
+ * full compare, so a hash collision costs a second module, never a wrong
+ * one.
+ */
+
+#ifndef PV_VENUS_SHADER_CACHE_H
+#define PV_VENUS_SHADER_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Initial bucket count (power of 2); doubles when the load passes 1 */
+#define PV_VENUS_SHADER_CACHE_BUCKETS 256
+
+/*
+ * Host module backend
+ *
+ * Implemented with vkCreateShaderModule / vkDestroyShaderModule by the
+ * handlers, and with fakes by the tests.
+ */
+struct pv_venus_shader_cache_backend {
+    /* Returns: 0 and the module in *module, or negative on failure */
+    int (*create)(void *user_data, void *device, const uint32_t *code, size_t code_size,
+                  void **module);
+    void (*destroy)(void *user_data, void *device, void *module);
+    void *user_data;
+};
+
+/*
+ * One host shader module
+ */
+struct pv_venus_shader {
+    void *module;                     /* VkShaderModule */
+    void *device;                     /* VkDevice it belongs to */
+    uint64_t hash;
+    size_t code_size;
+    uint32_t *code;                   /* Private copy, for compares */
+    uint32_t refs;                    /* Guest modules using it */
+    struct pv_venus_shader *next;     /* Bucket chain */
+};
+
+/* Cache statistics */
+struct pv_venus_shader_cache_stats {
+    uint64_t lookups;                 /* vkCreateShaderModule calls */
+    uint64_t hits;                    /* Served by an existing module */
+    uint64_t bytes_saved;             /* SPIR-V not recompiled thanks to hits */
+    uint64_t modules;                 /* Live host modules */
+    uint64_t code_bytes;              /* SPIR-V held by live modules */
+};
+
+/*
+ * Shader module cache
+ *
+ * Thread-safe. The lock covers only the table; driver calls to create and
+ * destroy modules run outside it. Two threads missing on the same code at
+ * once both compile, and the loser's module is destroyed in favour of the
+ * one already inserted.
+ */
+struct pv_venus_shader_cache {
+    struct pv_venus_shader_cache_backend backend;
+    pthread_mutex_t lock;
+    struct pv_venus_shader **buckets;
+    size_t bucket_count;
+    struct pv_venus_shader_cache_stats stats;
+};
+
+/*
+ * Hash SPIR-V (or any bytes)
+ *
+ * Fast and non-cryptographic: a multiply-rotate mix over 64-bit words.
+ */
+uint64_t pv_venus_shader_hash(const void *code, size_t size);
+
+/*
+ * Initialize a cache
+ *
+ * @cache: Cache to initialize
+ * @backend: Module functions (copied)
+ * Returns: 0 on success, negative on error
+ */
+int pv_venus_shader_cache_init(struct pv_venus_shader_cache *cache,
+                               const struct pv_venus_shader_cache_backend *backend);
+
+/*
+ * Destroy every module still cached and free the cache
+ */
+void pv_venus_shader_cache_destroy(struct pv_venus_shader_cache *cache);
+
+/*
+ * Get the module for @code on @device, creating it on a miss
+ *
+ * @code: SPIR-V (any alignment; only read during the call)
+ * @code_size: Bytes of code, a multiple of 4
+ * Returns: Referenced entry, or NULL on failure
+ */
+struct pv_venus_shader *pv_venus_shader_cache_acquire(struct pv_venus_shader_cache *cache,
+                                                      void *device,
+                                                      const void *code,
+                                                      size_t code_size);
+
+/*
+ * Take another reference (e.g. for a compile still using the module)
+ */
+void pv_venus_shader_cache_retain(struct pv_venus_shader_cache *cache,
+                                  struct pv_venus_shader *shader);
+
+/*
+ * Drop a reference; the module is destroyed with the last one
+ */
+void pv_venus_shader_cache_release(struct pv_venus_shader_cache *cache,
+                                   struct pv_venus_shader *shader);
+
+/*
+ * Get cache statistics
+ */
+void pv_venus_shader_cache_get_stats(struct pv_venus_shader_cache *cache,
+                                     struct pv_venus_shader_cache_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PV_VENUS_SHADER_CACHE_H */
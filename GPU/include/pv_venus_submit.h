@@ -0,0 +1,177 @@
+/*
+ * PearVisor - Venus Queue Submit Coalescing
+ *
+ * Every vkQueueSubmit costs a driver round trip (on MoltenVK, a Metal
+ * command buffer commit). Guests that submit many small batches pay that
+ * each time, so consecutive guest submits to one queue are held and sent
+ * as the batches of a single vkQueueSubmit.
+ *
+ * Batches keep their order and their own semaphores, so the queue sees
+ * exactly the same dependency graph. A guest fence rides on the merged
+ * submit: it signals once every batch up to and including the last merged
+ * one completes, which is later than strictly needed but never early.
+ * Only one fence fits per submit, so a second one forces a flush.
+ */
+
+#ifndef PV_VENUS_SUBMIT_H
+#define PV_VENUS_SUBMIT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <vulkan/vulkan.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Default flush budgets */
+#define PV_VENUS_SUBMIT_MAX_BYTES      (16u * 1024)   /* Guest submit commands held */
+#define PV_VENUS_SUBMIT_MAX_DELAY_US   500            /* Oldest held batch */
+#define PV_VENUS_SUBMIT_MAX_BATCHES    64             /* Batches per vkQueueSubmit */
+
+/*
+ * Why a flush happened
+ */
+enum pv_venus_submit_flush_reason {
+    PV_VENUS_SUBMIT_FLUSH_EXPLICIT = 0,   /* Fence wait, present, queue idle, teardown */
+    PV_VENUS_SUBMIT_FLUSH_BUDGET,         /* Byte or batch budget reached */
+    PV_VENUS_SUBMIT_FLUSH_TIMER,          /* Oldest batch held too long */
+    PV_VENUS_SUBMIT_FLUSH_ORDERING,       /* Other queue, or a second fence */
+    PV_VENUS_SUBMIT_FLUSH_REASON_COUNT
+};
+
+/*
+ * Backend: the real vkQueueSubmit (faked by the tests)
+ *
+ * @seqno is the last guest submit in @submits (guest submits are numbered
+ * from 1 in enqueue order).
+ * Returns: 0 on success, negative on failure
+ */
+struct pv_venus_submit_backend {
+    int (*submit)(void *user_data, VkQueue queue, uint32_t count,
+                  const VkSubmitInfo *submits, VkFence fence, uint64_t seqno);
+    void *user_data;
+};
+
+/* One held guest batch: ranges into the coalescer's arrays */
+struct pv_venus_submit_batch {
+    uint32_t first_command_buffer;
+    uint32_t command_buffer_count;
+    uint32_t first_wait;
+    uint32_t wait_count;
+    uint32_t first_signal;
+    uint32_t signal_count;
+};
+
+/* Coalescer statistics */
+struct pv_venus_submit_stats {
+    uint64_t guest_submits;           /* Batches the guest submitted */
+    uint64_t host_submits;            /* vkQueueSubmit calls made */
+    uint64_t failed_submits;
+    uint64_t flushes[PV_VENUS_SUBMIT_FLUSH_REASON_COUNT];
+};
+
+/*
+ * Submit coalescer for one guest context
+ *
+ * Thread-safe; a timer thread enforces the delay budget.
+ */
+struct pv_venus_submit_coalescer {
+    struct pv_venus_submit_backend backend;
+    uint64_t max_bytes;
+    uint64_t max_delay_ns;
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;              /* First batch held, or stop */
+    pthread_t timer;
+    bool timer_running;
+    bool stop;
+
+    /* Held batches, all for one queue */
+    VkQueue queue;
+    VkFence fence;                    /* VK_NULL_HANDLE = none yet */
+    struct pv_venus_submit_batch batches[PV_VENUS_SUBMIT_MAX_BATCHES];
+    uint32_t batch_count;
+    uint64_t bytes;
+    uint64_t oldest_ns;               /* When the first held batch arrived */
+
+    /* Handles referenced by the batches (grown as needed) */
+    VkCommandBuffer *command_buffers;
+    uint32_t command_buffer_count;
+    uint32_t command_buffer_capacity;
+    VkSemaphore *semaphores;          /* Waits and signals */
+    VkPipelineStageFlags *wait_stages;    /* Parallel to semaphores (waits only) */
+    uint32_t semaphore_count;
+    uint32_t semaphore_capacity;
+    uint32_t wait_stage_capacity;     /* Grown separately, so a failed grow can't desync */
+
+    struct pv_venus_submit_stats stats;
+};
+
+/*
+ * Initialize a coalescer
+ *
+ * @coalescer: Coalescer to initialize
+ * @backend: Submit function (copied)
+ * @max_bytes: Flush once this many guest bytes are held (0 = default)
+ * @max_delay_us: Flush once a batch is held this long (0 = default)
+ * Returns: 0 on success, negative on error
+ */
+int pv_venus_submit_init(struct pv_venus_submit_coalescer *coalescer,
+                         const struct pv_venus_submit_backend *backend,
+                         uint64_t max_bytes,
+                         uint32_t max_delay_us);
+
+/*
+ * Flush whatever is held and stop the timer
+ */
+void pv_venus_submit_destroy(struct pv_venus_submit_coalescer *coalescer);
+
+/*
+ * Hold one guest batch for submission
+ *
+ * May flush first (other queue, second fence) or after (budget).
+ *
+ * @queue: Host queue
+ * @batch: Guest batch (copied; pNext is ignored)
+ * @fence: Guest fence, or VK_NULL_HANDLE
+ * @bytes: Size of the guest command, charged against the byte budget
+ * @seqno: Receives the batch's guest submit number (may be NULL)
+ * Returns: 0 on success, negative if a flush this caused failed
+ */
+int pv_venus_submit_enqueue(struct pv_venus_submit_coalescer *coalescer,
+                            VkQueue queue,
+                            const VkSubmitInfo *batch,
+                            VkFence fence,
+                            size_t bytes,
+                            uint64_t *seqno);
+
+/*
+ * Send everything held now
+ *
+ * Call before anything that observes submitted work: fence waits,
+ * presents, queue/device idle, destroying objects a batch may use.
+ *
+ * Returns: 0 on success (or nothing held), negative if the submit failed
+ */
+int pv_venus_submit_flush(struct pv_venus_submit_coalescer *coalescer,
+                          enum pv_venus_submit_flush_reason reason);
+
+/*
+ * Get coalescer statistics
+ */
+void pv_venus_submit_get_stats(struct pv_venus_submit_coalescer *coalescer,
+                               struct pv_venus_submit_stats *stats);
+
+/*
+ * Guest submits per vkQueueSubmit (1.0 = no merging, 0 before any submit)
+ */
+double pv_venus_submit_merge_ratio(const struct pv_venus_submit_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PV_VENUS_SUBMIT_H */
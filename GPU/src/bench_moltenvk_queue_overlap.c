@@ -0,0 +1,355 @@
+/*
+ * PearVisor - MoltenVK Queue Overlap Benchmark
+ *
+ * Times a copy workload (large vkCmdCopyBuffer) and a render-side
+ * workload (full-image clears) alone, back to back on the graphics
+ * queue, and side by side on the graphics and transfer queues. With a
+ * real second queue the side-by-side time should approach the longer of
+ * the two instead of their sum.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pv_moltenvk.h"
+
+#define COPY_BYTES      (128ull * 1024 * 1024)
+#define COPIES          8
+#define IMAGE_SIZE      4096
+#define CLEARS          32
+#define ITERATIONS      10
+
+struct workload {
+    struct pv_moltenvk_context *vk;
+    VkDeviceMemory memory[3];
+    VkBuffer src;
+    VkBuffer dst;
+    VkImage image;
+    VkCommandPool graphics_pool;
+    VkCommandPool transfer_pool;
+    VkCommandBuffer copy_on_graphics;
+    VkCommandBuffer copy_on_transfer;
+    VkCommandBuffer render;
+    VkFence fences[2];
+};
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Device-local memory type among @type_bits, or -1 */
+static int find_device_local(const struct pv_moltenvk_context *vk, uint32_t type_bits)
+{
+    for (uint32_t i = 0; i < vk->memory_properties.memoryTypeCount; i++) {
+        if ((type_bits & (1u << i)) &&
+            (vk->memory_properties.memoryTypes[i].propertyFlags &
+             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static int bind_memory(struct workload *w, uint32_t slot, const VkMemoryRequirements *req,
+                       VkBuffer buffer, VkImage image)
+{
+    int type = find_device_local(w->vk, req->memoryTypeBits);
+    if (type < 0) {
+        return -1;
+    }
+
+    VkMemoryAllocateInfo alloc_info = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = req->size,
+        .memoryTypeIndex = (uint32_t)type,
+    };
+    if (vkAllocateMemory(w->vk->device, &alloc_info, NULL, &w->memory[slot]) != VK_SUCCESS) {
+        return -1;
+    }
+    VkResult result = buffer ? vkBindBufferMemory(w->vk->device, buffer, w->memory[slot], 0)
+                             : vkBindImageMemory(w->vk->device, image, w->memory[slot], 0);
+    return result == VK_SUCCESS ? 0 : -1;
+}
+
+static int create_buffer(struct workload *w, uint32_t slot, VkBufferUsageFlagBits usage,
+                         VkBuffer *buffer)
+{
+    /* Both queues touch the data; concurrent sharing skips ownership transfers */
+    uint32_t families[2] = { w->vk->graphics_queue_family, w->vk->transfer_queue_family };
+    bool shared = families[0] != families[1];
+
+    VkBufferCreateInfo info = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = COPY_BYTES,
+        .usage = usage,
+        .sharingMode = shared ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = shared ? 2 : 0,
+        .pQueueFamilyIndices = shared ? families : NULL,
+    };
+    if (vkCreateBuffer(w->vk->device, &info, NULL, buffer) != VK_SUCCESS) {
+        return -1;
+    }
+
+    VkMemoryRequirements req;
+    vkGetBufferMemoryRequirements(w->vk->device, *buffer, &req);
+    return bind_memory(w, slot, &req, *buffer, VK_NULL_HANDLE);
+}
+
+static int create_image(struct workload *w)
+{
+    VkImageCreateInfo info = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = VK_FORMAT_R8G8B8A8_UNORM,
+        .extent = { IMAGE_SIZE, IMAGE_SIZE, 1 },
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+    if (vkCreateImage(w->vk->device, &info, NULL, &w->image) != VK_SUCCESS) {
+        return -1;
+    }
+
+    VkMemoryRequirements req;
+    vkGetImageMemoryRequirements(w->vk->device, w->image, &req);
+    return bind_memory(w, 2, &req, VK_NULL_HANDLE, w->image);
+}
+
+static int create_pool(struct workload *w, uint32_t family, VkCommandPool *pool)
+{
+    VkCommandPoolCreateInfo info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex = family,
+    };
+    return vkCreateCommandPool(w->vk->device, &info, NULL, pool) == VK_SUCCESS ? 0 : -1;
+}
+
+static int begin(struct workload *w, VkCommandPool pool, VkCommandBuffer *command_buffer)
+{
+    VkCommandBufferAllocateInfo alloc_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1,
+    };
+    VkCommandBufferBeginInfo begin_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+    };
+    if (vkAllocateCommandBuffers(w->vk->device, &alloc_info, command_buffer) != VK_SUCCESS ||
+        vkBeginCommandBuffer(*command_buffer, &begin_info) != VK_SUCCESS) {
+        return -1;
+    }
+    return 0;
+}
+
+static int record_copy(struct workload *w, VkCommandPool pool, VkCommandBuffer *command_buffer)
+{
+    if (begin(w, pool, command_buffer) != 0) {
+        return -1;
+    }
+    VkBufferCopy region = { 0, 0, COPY_BYTES };
+    for (int i = 0; i < COPIES; i++) {
+        vkCmdCopyBuffer(*command_buffer, w->src, w->dst, 1, &region);
+    }
+    return vkEndCommandBuffer(*command_buffer) == VK_SUCCESS ? 0 : -1;
+}
+
+static int record_render(struct workload *w)
+{
+    if (begin(w, w->graphics_pool, &w->render) != 0) {
+        return -1;
+    }
+
+    VkImageSubresourceRange range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    VkImageMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = 0,
+        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,     /* Contents are overwritten anyway */
+        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = w->image,
+        .subresourceRange = range,
+    };
+    vkCmdPipelineBarrier(w->render, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+
+    for (int i = 0; i < CLEARS; i++) {
+        VkClearColorValue color = { .float32 = { (float)i / CLEARS, 0.5f, 0.25f, 1.0f } };
+        vkCmdClearColorImage(w->render, w->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             &color, 1, &range);
+    }
+    return vkEndCommandBuffer(w->render) == VK_SUCCESS ? 0 : -1;
+}
+
+static int setup(struct workload *w)
+{
+    if (create_buffer(w, 0, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, &w->src) != 0 ||
+        create_buffer(w, 1, VK_BUFFER_USAGE_TRANSFER_DST_BIT, &w->dst) != 0 ||
+        create_image(w) != 0 ||
+        create_pool(w, w->vk->graphics_queue_family, &w->graphics_pool) != 0 ||
+        create_pool(w, w->vk->transfer_queue_family, &w->transfer_pool) != 0 ||
+        record_copy(w, w->graphics_pool, &w->copy_on_graphics) != 0 ||
+        record_copy(w, w->transfer_pool, &w->copy_on_transfer) != 0 ||
+        record_render(w) != 0) {
+        return -1;
+    }
+
+    VkFenceCreateInfo fence_info = { .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    for (int i = 0; i < 2; i++) {
+        if (vkCreateFence(w->vk->device, &fence_info, NULL, &w->fences[i]) != VK_SUCCESS) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void teardown(struct workload *w)
+{
+    VkDevice device = w->vk->device;
+    vkDeviceWaitIdle(device);
+    for (int i = 0; i < 2; i++) {
+        vkDestroyFence(device, w->fences[i], NULL);
+    }
+    vkDestroyCommandPool(device, w->graphics_pool, NULL);
+    vkDestroyCommandPool(device, w->transfer_pool, NULL);
+    vkDestroyImage(device, w->image, NULL);
+    vkDestroyBuffer(device, w->src, NULL);
+    vkDestroyBuffer(device, w->dst, NULL);
+    for (int i = 0; i < 3; i++) {
+        vkFreeMemory(device, w->memory[i], NULL);
+    }
+}
+
+/*
+ * Submit up to two command buffers, each to its own queue (or both to
+ * @queues[0] when @queues[1] is NULL), and wait for all of them
+ *
+ * Returns: Seconds from first submit to last completion, negative on error
+ */
+static double run(struct workload *w, VkQueue queues[2], VkCommandBuffer command_buffers[2],
+                  uint32_t count)
+{
+    VkSubmitInfo submits[2];
+    for (uint32_t i = 0; i < count; i++) {
+        submits[i] = (VkSubmitInfo){
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &command_buffers[i],
+        };
+    }
+
+    uint32_t fence_count = queues[1] ? count : 1;
+    vkResetFences(w->vk->device, fence_count, w->fences);
+
+    double start = now_seconds();
+    VkResult result;
+    if (queues[1]) {
+        result = vkQueueSubmit(queues[0], 1, &submits[0], w->fences[0]);
+        if (result == VK_SUCCESS && count > 1) {
+            result = vkQueueSubmit(queues[1], 1, &submits[1], w->fences[1]);
+        }
+    } else {
+        result = vkQueueSubmit(queues[0], count, submits, w->fences[0]);
+    }
+    if (result != VK_SUCCESS ||
+        vkWaitForFences(w->vk->device, fence_count, w->fences, VK_TRUE, UINT64_MAX) !=
+            VK_SUCCESS) {
+        return -1.0;
+    }
+    return now_seconds() - start;
+}
+
+/* Average of ITERATIONS runs, after one warm-up */
+static double measure(struct workload *w, VkQueue queue0, VkQueue queue1,
+                      VkCommandBuffer command_buffer0, VkCommandBuffer command_buffer1)
+{
+    VkQueue queues[2] = { queue0, queue1 };
+    VkCommandBuffer command_buffers[2] = { command_buffer0, command_buffer1 };
+    uint32_t count = command_buffer1 ? 2 : 1;
+
+    if (run(w, queues, command_buffers, count) < 0) {
+        return -1.0;
+    }
+    double total = 0.0;
+    for (int i = 0; i < ITERATIONS; i++) {
+        double seconds = run(w, queues, command_buffers, count);
+        if (seconds < 0) {
+            return -1.0;
+        }
+        total += seconds;
+    }
+    return total / ITERATIONS;
+}
+
+int main(void)
+{
+    printf("=== PearVisor MoltenVK Queue Overlap Benchmark ===\n\n");
+
+    struct pv_moltenvk_context *vk = pv_moltenvk_init();
+    if (!vk ||
+        pv_moltenvk_create_instance(vk, "PearVisor Queue Overlap") != VK_SUCCESS ||
+        pv_moltenvk_select_physical_device(vk) != VK_SUCCESS ||
+        pv_moltenvk_create_device(vk) != VK_SUCCESS) {
+        fprintf(stderr, "No Vulkan device\n");
+        pv_moltenvk_cleanup(vk);
+        return 1;
+    }
+
+    struct workload w = { .vk = vk };
+    if (setup(&w) != 0) {
+        fprintf(stderr, "Workload setup failed\n");
+        teardown(&w);
+        pv_moltenvk_cleanup(vk);
+        return 1;
+    }
+
+    bool separate = vk->transfer_queue != vk->graphics_queue;
+    printf("copy:   %d x %llu MiB vkCmdCopyBuffer\n", COPIES,
+           (unsigned long long)(COPY_BYTES >> 20));
+    printf("render: %d x %ux%u RGBA8 vkCmdClearColorImage\n", CLEARS, IMAGE_SIZE, IMAGE_SIZE);
+    printf("transfer queue: family %u index %u%s\n\n", vk->transfer_queue_family,
+           vk->transfer_queue_index, separate ? "" : " (shares the graphics queue)");
+
+    VkQueue graphics = vk->graphics_queue;
+    double copy = measure(&w, graphics, VK_NULL_HANDLE, w.copy_on_graphics, VK_NULL_HANDLE);
+    double render = measure(&w, graphics, VK_NULL_HANDLE, w.render, VK_NULL_HANDLE);
+    double serial = measure(&w, graphics, VK_NULL_HANDLE, w.render, w.copy_on_graphics);
+    double overlapped = separate
+        ? measure(&w, graphics, vk->transfer_queue, w.render, w.copy_on_transfer)
+        : serial;
+
+    if (copy < 0 || render < 0 || serial < 0 || overlapped < 0) {
+        fprintf(stderr, "Submit failed\n");
+        teardown(&w);
+        pv_moltenvk_cleanup(vk);
+        return 1;
+    }
+
+    printf("%-28s %10.2f ms\n", "copy alone", copy * 1e3);
+    printf("%-28s %10.2f ms\n", "render alone", render * 1e3);
+    printf("%-28s %10.2f ms\n", "serial (graphics queue)", serial * 1e3);
+    if (separate) {
+        printf("%-28s %10.2f ms\n", "overlapped (graphics+copy)", overlapped * 1e3);
+        /* Share of the shorter workload hidden behind the longer one */
+        double shorter = copy < render ? copy : render;
+        printf("\noverlap: %.0f%% of the shorter workload hidden, %.2fx vs serial\n",
+               shorter > 0 ? 100.0 * (serial - overlapped) / shorter : 0.0,
+               serial / overlapped);
+    } else {
+        printf("\noverlap: no dedicated queue, copy and render serialize\n");
+    }
+
+    teardown(&w);
+    pv_moltenvk_cleanup(vk);
+    return 0;
+}
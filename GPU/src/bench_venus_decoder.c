@@ -0,0 +1,193 @@
+/*
+ * PearVisor - Venus Decoder Benchmark
+ * 
+ * Measures command decode throughput (commands/sec) for the legacy
+ * malloc + copy payload path versus the zero-copy ring view path.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pv_venus_ring.h"
+#include "pv_venus_protocol.h"
+
+#define RING_SIZE   (1024 * 1024)
+#define TOTAL_BYTES (512ull * 1024 * 1024)
+
+/* Sink so the compiler cannot discard payload reads */
+static volatile uint64_t checksum_sink;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Stand-in for a handler: touch one byte per cache line */
+static void consume_payload(const void *data, size_t size)
+{
+    const uint8_t *p = data;
+    uint64_t sum = p[size - 1];
+    for (size_t i = 0; i < size; i += 64) {
+        sum += p[i];
+    }
+    checksum_sink += sum;
+}
+
+/* Write one command at the current tail (splitting at the wrap) */
+static void write_command(struct pv_venus_ring *ring, uint32_t *tail,
+                          const uint8_t *command, size_t size)
+{
+    uint8_t *data = (uint8_t *)ring->buffer.data;
+    uint32_t pos = *tail & ring->buffer.mask;
+    size_t first = ring->buffer.size - pos;
+
+    if (size <= first) {
+        memcpy(data + pos, command, size);
+    } else {
+        memcpy(data + pos, command, first);
+        memcpy(data, command + first, size - first);
+    }
+    *tail += size;
+}
+
+/* Fill the ring with as many whole commands as fit (full ring allowed) */
+static uint32_t fill_ring(struct pv_venus_ring *ring, const uint8_t *command,
+                          size_t size)
+{
+    uint32_t tail = pv_venus_ring_get_tail(ring);
+    uint32_t count = 0;
+
+    while (pv_venus_ring_seq_distance(ring->buffer.current_pos, tail) + size <=
+           ring->buffer.size) {
+        write_command(ring, &tail, command, size);
+        count++;
+    }
+
+    atomic_store_explicit((atomic_uint *)ring->control.tail, tail,
+                         memory_order_release);
+    return count;
+}
+
+/* Legacy decode: malloc + copy + free per command */
+static int decode_copy(struct pv_venus_ring *ring)
+{
+    struct pv_venus_command_header header;
+    if (pv_venus_ring_read(ring, &header, sizeof(header)) != 0) {
+        return -1;
+    }
+
+    size_t data_size = header.command_size - sizeof(header);
+    void *data = malloc(data_size);
+    if (!data) {
+        return -1;
+    }
+
+    pv_venus_ring_read(ring, data, data_size);
+    consume_payload(data, data_size);
+    free(data);
+    return 0;
+}
+
+/* Zero-copy decode: view into ring memory */
+static int decode_view(struct pv_venus_ring *ring)
+{
+    struct pv_venus_command_header header;
+    if (pv_venus_ring_read(ring, &header, sizeof(header)) != 0) {
+        return -1;
+    }
+
+    struct pv_venus_ring_view view;
+    size_t data_size = header.command_size - sizeof(header);
+    if (pv_venus_ring_view_acquire(ring, data_size, &view) != 0) {
+        return -1;
+    }
+
+    consume_payload(view.data, view.size);
+    return 0;
+}
+
+static double run(struct pv_venus_ring *ring, size_t payload_size,
+                  int (*decode)(struct pv_venus_ring *))
+{
+    size_t command_size = sizeof(struct pv_venus_command_header) + payload_size;
+    uint8_t *command = malloc(command_size);
+    struct pv_venus_command_header header = {
+        .command_id = PV_VK_COMMAND_vkCmdDraw,
+        .command_size = (uint32_t)command_size,
+    };
+    memcpy(command, &header, sizeof(header));
+    memset(command + sizeof(header), 0xA5, payload_size);
+
+    uint64_t commands = 0;
+    uint64_t target = TOTAL_BYTES / command_size;
+    double elapsed = 0.0;
+
+    while (commands < target) {
+        uint32_t count = fill_ring(ring, command, command_size);
+
+        double start = now_seconds();
+        for (uint32_t i = 0; i < count; i++) {
+            decode(ring);
+        }
+        elapsed += now_seconds() - start;
+
+        pv_venus_ring_set_head(ring, ring->buffer.current_pos);
+        commands += count;
+    }
+
+    free(command);
+    return (double)commands / elapsed;
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    printf("=== PearVisor Venus Decoder Benchmark ===\n\n");
+
+    const size_t total_size = 16 + RING_SIZE;
+    void *shared_mem = calloc(1, total_size);
+    if (!shared_mem) {
+        fprintf(stderr, "Failed to allocate shared memory\n");
+        return 1;
+    }
+
+    struct pv_venus_ring_layout layout = {
+        .shared_memory = shared_mem,
+        .shared_memory_size = total_size,
+        .head_offset = 0,
+        .tail_offset = 4,
+        .status_offset = 8,
+        .buffer_offset = 16,
+        .buffer_size = RING_SIZE,
+    };
+
+    struct pv_venus_ring *ring = pv_venus_ring_create(&layout, NULL);
+    if (!ring) {
+        fprintf(stderr, "Failed to create ring buffer\n");
+        free(shared_mem);
+        return 1;
+    }
+
+    /* Odd sizes so commands regularly straddle the wrap */
+    static const size_t payload_sizes[] = { 24, 120, 1000, 4090, 65530 };
+
+    printf("%10s %16s %16s %8s\n", "payload", "copy (cmd/s)", "view (cmd/s)", "speedup");
+    for (size_t i = 0; i < sizeof(payload_sizes) / sizeof(payload_sizes[0]); i++) {
+        double copy_rate = run(ring, payload_sizes[i], decode_copy);
+        double view_rate = run(ring, payload_sizes[i], decode_view);
+        printf("%10zu %16.0f %16.0f %7.2fx\n",
+               payload_sizes[i], copy_rate, view_rate, view_rate / copy_rate);
+    }
+
+    printf("\nZero-copy views: %llu, wrap copies: %llu\n",
+           ring->stats.zero_copy_views, ring->stats.wrap_copies);
+
+    pv_venus_ring_destroy(ring);
+    free(shared_mem);
+    return 0;
+}
@@ -0,0 +1,193 @@
+/*
+ * PearVisor - Venus Object Table Benchmark
+ *
+ * Measures add / lookup (hit and miss) / handle resolve / remove+add churn cost per
+ * operation with 1k, 64k and 1M live objects, the worst single add
+ * while growing from an empty table (incremental resize), and tearing
+ * down a device that owns all of them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pv_venus_objects.h"
+
+#define LOOKUPS (4u * 1024 * 1024)
+
+/* Sink so the compiler cannot discard lookups */
+static volatile uintptr_t handle_sink;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* xorshift64, for a lookup order the prefetcher can't follow */
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+/* Guest IDs look like a driver's: sequential, with a type tag above */
+static pv_venus_object_id guest_id(size_t index)
+{
+    return ((pv_venus_object_id)PV_VENUS_OBJECT_TYPE_BUFFER << 48) | (index + 1);
+}
+
+static int bench(size_t live)
+{
+    struct pv_venus_object_table table;
+    if (pv_venus_object_table_init(&table, live) != 0) {
+        return -1;
+    }
+
+    /* Add */
+    double start = now_seconds();
+    for (size_t i = 0; i < live; i++) {
+        if (pv_venus_object_add(&table, guest_id(i), (void *)(uintptr_t)(i + 1),
+                                PV_VENUS_OBJECT_TYPE_BUFFER) != 0) {
+            fprintf(stderr, "Add failed at %zu\n", i);
+            pv_venus_object_table_destroy(&table);
+            return -1;
+        }
+    }
+    double add_ns = (now_seconds() - start) * 1e9 / (double)live;
+
+    /* Lookup hits, random order */
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+    start = now_seconds();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+        handle_sink += (uintptr_t)pv_venus_object_get(&table,
+                                                      guest_id(next_random(&rng) % live));
+    }
+    double hit_ns = (now_seconds() - start) * 1e9 / LOOKUPS;
+
+    /* Lookup misses (IDs never added) */
+    start = now_seconds();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+        handle_sink += (uintptr_t)pv_venus_object_get(&table,
+                                                      guest_id(live + next_random(&rng) % live));
+    }
+    double miss_ns = (now_seconds() - start) * 1e9 / LOOKUPS;
+
+    /* Resolve slot map handles (index + generation compare) */
+    pv_venus_object_handle *handles = malloc(live * sizeof(*handles));
+    if (!handles) {
+        pv_venus_object_table_destroy(&table);
+        return -1;
+    }
+    for (size_t i = 0; i < live; i++) {
+        handles[i] = pv_venus_object_lookup(&table, guest_id(i));
+    }
+    start = now_seconds();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+        handle_sink += (uintptr_t)pv_venus_object_resolve(&table,
+                                                          handles[next_random(&rng) % live]);
+    }
+    double resolve_ns = (now_seconds() - start) * 1e9 / LOOKUPS;
+    free(handles);
+
+    /* Churn: destroy a random object, create a fresh one */
+    size_t next = live;
+    size_t *ids = malloc(live * sizeof(*ids));
+    if (!ids) {
+        pv_venus_object_table_destroy(&table);
+        return -1;
+    }
+    for (size_t i = 0; i < live; i++) {
+        ids[i] = i;
+    }
+    start = now_seconds();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+        size_t slot = next_random(&rng) % live;
+        pv_venus_object_remove(&table, guest_id(ids[slot]));
+        ids[slot] = next++;
+        pv_venus_object_add(&table, guest_id(ids[slot]), (void *)(uintptr_t)next,
+                            PV_VENUS_OBJECT_TYPE_BUFFER);
+    }
+    double churn_ns = (now_seconds() - start) * 1e9 / LOOKUPS;
+
+    /* Every live object must still resolve after churn */
+    int ret = table.count == live ? 0 : -1;
+    for (size_t i = 0; i < live && ret == 0; i++) {
+        if (!pv_venus_object_get(&table, guest_id(ids[i]))) {
+            ret = -1;
+        }
+    }
+    if (ret != 0) {
+        fprintf(stderr, "Table corrupted after churn\n");
+    }
+
+    printf("%8zu objects (%8zu slots): add %6.1f ns  get hit %6.1f ns  "
+           "get miss %6.1f ns  resolve %6.1f ns  remove+add %6.1f ns\n",
+           live, table.index->capacity, add_ns, hit_ns, miss_ns, resolve_ns, churn_ns);
+
+    free(ids);
+    pv_venus_object_table_destroy(&table);
+    if (ret != 0) {
+        return ret;
+    }
+
+    /* Grow from empty: no add should pay for a whole rehash */
+    if (pv_venus_object_table_init(&table, 0) != 0) {
+        return -1;
+    }
+    double worst = 0.0;
+    start = now_seconds();
+    for (size_t i = 0; i < live; i++) {
+        double t = now_seconds();
+        pv_venus_object_add(&table, guest_id(i), (void *)(uintptr_t)(i + 1),
+                            PV_VENUS_OBJECT_TYPE_BUFFER);
+        t = now_seconds() - t;
+        if (t > worst) {
+            worst = t;
+        }
+    }
+    double grow_ns = (now_seconds() - start) * 1e9 / (double)live;
+    printf("%8s growing from %zu slots: add %6.1f ns avg, %8.1f ns worst (%llu grows)\n",
+           "", table.min_capacity, grow_ns, worst * 1e9, table.grows);
+
+    pv_venus_object_table_destroy(&table);
+
+    /* Device teardown: one call releases every child, children-first */
+    if (pv_venus_object_table_init(&table, live + 1) != 0) {
+        return -1;
+    }
+    pv_venus_object_add(&table, 1, (void *)(uintptr_t)1, PV_VENUS_OBJECT_TYPE_DEVICE);
+    for (size_t i = 0; i < live; i++) {
+        pv_venus_object_add_child(&table, guest_id(i), (void *)(uintptr_t)(i + 2),
+                                  PV_VENUS_OBJECT_TYPE_BUFFER, 1);
+    }
+    struct pv_venus_object_release *releases;
+    start = now_seconds();
+    size_t released = pv_venus_object_remove_tree(&table, 1, &releases);
+    double teardown_ms = (now_seconds() - start) * 1e3;
+    free(releases);
+    printf("%8s device teardown: %zu objects in %.2f ms\n", "", released, teardown_ms);
+
+    ret = released == live + 1 && table.count == 0 ? 0 : -1;
+    pv_venus_object_table_destroy(&table);
+    return ret;
+}
+
+int main(void)
+{
+    printf("=== PearVisor Venus Object Table Benchmark ===\n\n");
+
+    static const size_t sizes[] = { 1024, 64 * 1024, 1024 * 1024 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        if (bench(sizes[i]) != 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * PearVisor - Venus Object Table Multi-Threaded Benchmark
+ *
+ * Runs 1..N decoder-like threads against one table: mostly lookups of
+ * shared objects, with a share of remove+add churn on per-thread IDs.
+ * Each mix runs on the seqlock read path and, as a baseline, with
+ * every operation wrapped in one global mutex.
+ *
+ * Usage: bench_venus_object_table_mt [max_threads]  (default: online CPUs)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "pv_venus_objects.h"
+
+#define SHARED_OBJECTS  (64 * 1024)
+#define PRIVATE_OBJECTS 1024
+#define OPS_PER_THREAD  (2u * 1024 * 1024)
+
+struct bench_run {
+    struct pv_venus_object_table table;
+    pthread_mutex_t global_lock;
+    bool locked;                       /* Baseline: serialize every operation */
+    unsigned write_percent;
+    atomic_uint ready;
+    atomic_bool go;
+};
+
+struct bench_thread {
+    struct bench_run *run;
+    pthread_t thread;
+    unsigned index;
+    uintptr_t sink;
+};
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* xorshift64 */
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+static pv_venus_object_id shared_id(size_t index)
+{
+    return ((pv_venus_object_id)PV_VENUS_OBJECT_TYPE_BUFFER << 48) | (index + 1);
+}
+
+/* Each thread churns its own ID range, so removes never race each other's adds */
+static pv_venus_object_id private_id(unsigned thread, size_t index)
+{
+    return ((pv_venus_object_id)PV_VENUS_OBJECT_TYPE_IMAGE << 48) |
+           ((pv_venus_object_id)thread << 32) | index;
+}
+
+static void *bench_thread_main(void *arg)
+{
+    struct bench_thread *self = arg;
+    struct bench_run *run = self->run;
+    uint64_t rng = 0x9E3779B97F4A7C15ull * (self->index + 1);
+    uint64_t generation = PRIVATE_OBJECTS;
+
+    atomic_fetch_add(&run->ready, 1);
+    while (!atomic_load_explicit(&run->go, memory_order_acquire)) {
+    }
+
+    for (uint32_t i = 0; i < OPS_PER_THREAD; i++) {
+        uint64_t r = next_random(&rng);
+        bool write = (r >> 32) % 100 < run->write_percent;
+
+        if (run->locked) {
+            pthread_mutex_lock(&run->global_lock);
+        }
+
+        if (write) {
+            /* Destroy one private object, create its replacement */
+            size_t slot = r % PRIVATE_OBJECTS;
+            pv_venus_object_remove(&run->table, private_id(self->index, slot));
+            pv_venus_object_add(&run->table, private_id(self->index, slot),
+                                (void *)(uintptr_t)++generation,
+                                PV_VENUS_OBJECT_TYPE_IMAGE);
+        } else {
+            self->sink += (uintptr_t)pv_venus_object_get(&run->table,
+                                                         shared_id(r % SHARED_OBJECTS));
+        }
+
+        if (run->locked) {
+            pthread_mutex_unlock(&run->global_lock);
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Run one configuration
+ *
+ * Returns: Million operations per second (all threads), or negative on failure
+ */
+static double bench(unsigned threads, unsigned write_percent, bool locked)
+{
+    struct bench_run run = {
+        .locked = locked,
+        .write_percent = write_percent,
+    };
+    if (pv_venus_object_table_init(&run.table, SHARED_OBJECTS + threads * PRIVATE_OBJECTS) != 0) {
+        return -1.0;
+    }
+    pthread_mutex_init(&run.global_lock, NULL);
+
+    for (size_t i = 0; i < SHARED_OBJECTS; i++) {
+        pv_venus_object_add(&run.table, shared_id(i), (void *)(uintptr_t)(i + 1),
+                            PV_VENUS_OBJECT_TYPE_BUFFER);
+    }
+    for (unsigned t = 0; t < threads; t++) {
+        for (size_t i = 0; i < PRIVATE_OBJECTS; i++) {
+            pv_venus_object_add(&run.table, private_id(t, i), (void *)(uintptr_t)(i + 1),
+                                PV_VENUS_OBJECT_TYPE_IMAGE);
+        }
+    }
+
+    struct bench_thread *workers = calloc(threads, sizeof(*workers));
+    if (!workers) {
+        pv_venus_object_table_destroy(&run.table);
+        return -1.0;
+    }
+
+    for (unsigned t = 0; t < threads; t++) {
+        workers[t].run = &run;
+        workers[t].index = t;
+        pthread_create(&workers[t].thread, NULL, bench_thread_main, &workers[t]);
+    }
+    while (atomic_load(&run.ready) < threads) {
+    }
+
+    double start = now_seconds();
+    atomic_store_explicit(&run.go, true, memory_order_release);
+    for (unsigned t = 0; t < threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    double elapsed = now_seconds() - start;
+
+    /* Shared objects are never written, so all of them must still be there */
+    double result = (double)threads * OPS_PER_THREAD / elapsed / 1e6;
+    if (run.table.count != SHARED_OBJECTS + threads * PRIVATE_OBJECTS) {
+        fprintf(stderr, "Table corrupted: %zu objects\n", run.table.count);
+        result = -1.0;
+    }
+
+    free(workers);
+    pthread_mutex_destroy(&run.global_lock);
+    pv_venus_object_table_destroy(&run.table);
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned max_threads = argc > 1 ? (unsigned)atoi(argv[1]) : (unsigned)(cpus > 0 ? cpus : 1);
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+
+    printf("=== PearVisor Venus Object Table Multi-Threaded Benchmark ===\n");
+    printf("%d shared objects, %u ops/thread, %ld CPUs online\n\n",
+           SHARED_OBJECTS, OPS_PER_THREAD, cpus);
+
+    static const unsigned write_percents[] = { 0, 1, 10 };
+    for (size_t m = 0; m < sizeof(write_percents) / sizeof(write_percents[0]); m++) {
+        printf("--- %u%% remove+add, %u%% get ---\n",
+               write_percents[m], 100 - write_percents[m]);
+        printf("  threads     seqlock Mops/s   global mutex Mops/s\n");
+
+        for (unsigned threads = 1; threads <= max_threads;
+             threads = (threads * 2 > max_threads && threads != max_threads) ? max_threads
+                                                                              : threads * 2) {
+            double lock_free = bench(threads, write_percents[m], false);
+            double locked = bench(threads, write_percents[m], true);
+            if (lock_free < 0.0 || locked < 0.0) {
+                return 1;
+            }
+            printf("  %7u   %16.1f   %19.1f\n", threads, lock_free, locked);
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
@@ -6,12 +6,246 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 /* MoltenVK portability extension flag (may not be in older headers) */
 #ifndef VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR
 #define VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR 0x00000001
 #endif
 
+/*
+ * On-disk pipeline cache
+ *
+ * The driver's own header (VkPipelineCacheHeaderVersionOne) identifies
+ * the device but carries no driver version and no integrity check, so the
+ * file wraps the cache data in a header of its own.
+ */
+#define PIPELINE_CACHE_MAGIC    0x43505650u   /* "PVPC" */
+#define PIPELINE_CACHE_VERSION  1
+
+/* Offset of pipelineCacheUUID in VkPipelineCacheHeaderVersionOne */
+#define PIPELINE_CACHE_UUID_OFFSET  16
+
+struct pipeline_cache_file_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+    uint8_t uuid[VK_UUID_SIZE];
+    uint32_t reserved;
+    uint64_t data_size;
+    uint64_t checksum;                /* FNV-1a of the data */
+};
+
+static uint64_t fnv1a(const void *data, size_t size)
+{
+    const uint8_t *bytes = data;
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static void pipeline_cache_header(const struct pv_moltenvk_context *ctx,
+                                  struct pipeline_cache_file_header *header)
+{
+    memset(header, 0, sizeof(*header));
+    header->magic = PIPELINE_CACHE_MAGIC;
+    header->version = PIPELINE_CACHE_VERSION;
+    header->vendor_id = ctx->device_properties.vendorID;
+    header->device_id = ctx->device_properties.deviceID;
+    header->driver_version = ctx->device_properties.driverVersion;
+    memcpy(header->uuid, ctx->device_properties.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+/*
+ * Cache file path for this device and driver, creating its directory
+ * 
+ * Returns: Allocated path, or NULL if there is nowhere to put it
+ */
+static char *pipeline_cache_path(const struct pv_moltenvk_context *ctx)
+{
+    char dir[1024];
+    const char *cache_dir = getenv("PEARVISOR_CACHE_DIR");
+    const char *home = getenv("HOME");
+
+    if (cache_dir && cache_dir[0]) {
+        snprintf(dir, sizeof(dir), "%s", cache_dir);
+    } else if (home && home[0]) {
+        snprintf(dir, sizeof(dir), "%s/Library/Caches/PearVisor", home);
+    } else {
+        return NULL;
+    }
+
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "[MoltenVK] Cannot create cache directory %s: %s\n",
+                dir, strerror(errno));
+        return NULL;
+    }
+
+    char uuid[2 * VK_UUID_SIZE + 1];
+    for (int i = 0; i < VK_UUID_SIZE; i++) {
+        snprintf(&uuid[2 * i], 3, "%02x", ctx->device_properties.pipelineCacheUUID[i]);
+    }
+
+    size_t size = strlen(dir) + sizeof(uuid) + 64;
+    char *path = malloc(size);
+    if (path) {
+        snprintf(path, size, "%s/pipeline-cache-%s-%08x.bin",
+                 dir, uuid, ctx->device_properties.driverVersion);
+    }
+    return path;
+}
+
+/*
+ * Read and validate the cache file
+ * 
+ * Returns: Cache data (caller frees) and its size in *size, or NULL if
+ *          there is no usable file
+ */
+static void *pipeline_cache_load(const struct pv_moltenvk_context *ctx,
+                                 const char *path,
+                                 size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+
+    struct pipeline_cache_file_header expected, header;
+    pipeline_cache_header(ctx, &expected);
+
+    void *data = NULL;
+    if (fread(&header, sizeof(header), 1, file) == 1 &&
+        header.magic == expected.magic &&
+        header.version == expected.version &&
+        header.vendor_id == expected.vendor_id &&
+        header.device_id == expected.device_id &&
+        header.driver_version == expected.driver_version &&
+        memcmp(header.uuid, expected.uuid, VK_UUID_SIZE) == 0 &&
+        header.data_size >= PIPELINE_CACHE_UUID_OFFSET + VK_UUID_SIZE &&
+        header.data_size <= SIZE_MAX) {
+        data = malloc(header.data_size);
+    }
+
+    /* The driver's header must agree too, and the data must be intact */
+    if (data &&
+        (fread(data, header.data_size, 1, file) != 1 ||
+         memcmp((uint8_t *)data + PIPELINE_CACHE_UUID_OFFSET, expected.uuid, VK_UUID_SIZE) != 0 ||
+         fnv1a(data, header.data_size) != header.checksum)) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+
+    if (!data) {
+        fprintf(stderr, "[MoltenVK] Ignoring stale or corrupt pipeline cache %s\n", path);
+        return NULL;
+    }
+
+    *size = header.data_size;
+    return data;
+}
+
+/*
+ * Create the device's pipeline cache, seeded from disk when possible
+ */
+static void pipeline_cache_open(struct pv_moltenvk_context *ctx)
+{
+    ctx->pipeline_cache_path = pipeline_cache_path(ctx);
+
+    size_t size = 0;
+    void *data = ctx->pipeline_cache_path
+                     ? pipeline_cache_load(ctx, ctx->pipeline_cache_path, &size)
+                     : NULL;
+
+    VkPipelineCacheCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .pNext = NULL,
+        .flags = 0,
+        .initialDataSize = size,
+        .pInitialData = data,
+    };
+
+    VkResult result = vkCreatePipelineCache(ctx->device, &create_info, NULL,
+                                            &ctx->pipeline_cache);
+    if (result != VK_SUCCESS && data) {
+        /* The driver rejected the data after all; start empty */
+        create_info.initialDataSize = 0;
+        create_info.pInitialData = NULL;
+        size = 0;
+        result = vkCreatePipelineCache(ctx->device, &create_info, NULL, &ctx->pipeline_cache);
+    }
+    free(data);
+
+    if (result != VK_SUCCESS) {
+        fprintf(stderr, "[MoltenVK] Failed to create pipeline cache: %d\n", result);
+        ctx->pipeline_cache = VK_NULL_HANDLE;
+        return;
+    }
+
+    ctx->pipeline_cache_saved = size;
+    ctx->pipeline_cache_flushed = time(NULL);
+    printf("[MoltenVK] Pipeline cache: %zu bytes loaded from %s\n", size,
+           ctx->pipeline_cache_path ? ctx->pipeline_cache_path : "(not persisted)");
+}
+
+/*
+ * Write @size bytes of cache data to a temporary file and rename it into place
+ *
+ * The temporary file is unique (mkstemp next to the target), so contexts
+ * flushing the same cache at once each rename a complete file.
+ */
+static int pipeline_cache_write(const struct pv_moltenvk_context *ctx,
+                                const void *data, size_t size)
+{
+    const char *path = ctx->pipeline_cache_path;
+    size_t tmp_size = strlen(path) + sizeof(".XXXXXX");
+    char *tmp_path = malloc(tmp_size);
+    if (!tmp_path) {
+        return -1;
+    }
+    snprintf(tmp_path, tmp_size, "%s.XXXXXX", path);
+
+    struct pipeline_cache_file_header header;
+    pipeline_cache_header(ctx, &header);
+    header.data_size = size;
+    header.checksum = fnv1a(data, size);
+
+    int result = -1;
+    int fd = mkstemp(tmp_path);
+    if (fd < 0) {
+        fprintf(stderr, "[MoltenVK] Failed to create %s: %s\n", tmp_path, strerror(errno));
+        free(tmp_path);
+        return -1;
+    }
+
+    FILE *file = fdopen(fd, "wb");
+    if (!file) {
+        close(fd);
+    } else {
+        bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                       fwrite(data, size, 1, file) == 1 &&
+                       fflush(file) == 0 &&
+                       fsync(fileno(file)) == 0;
+        if (fclose(file) == 0 && written && rename(tmp_path, path) == 0) {
+            result = 0;
+        }
+    }
+
+    if (result != 0) {
+        fprintf(stderr, "[MoltenVK] Failed to write pipeline cache %s: %s\n",
+                path, strerror(errno));
+        unlink(tmp_path);
+    }
+    free(tmp_path);
+    return result;
+}
+
 /*
  * Initialize MoltenVK context
  */
@@ -23,6 +257,18 @@ struct pv_moltenvk_context *pv_moltenvk_init(void)
         return NULL;
     }
 
+    if (pthread_mutex_init(&ctx->queue_lock, NULL) != 0) {
+        fprintf(stderr, "[MoltenVK] Failed to initialize queue lock\n");
+        free(ctx);
+        return NULL;
+    }
+    if (pthread_mutex_init(&ctx->pipeline_cache_lock, NULL) != 0) {
+        fprintf(stderr, "[MoltenVK] Failed to initialize pipeline cache lock\n");
+        pthread_mutex_destroy(&ctx->queue_lock);
+        free(ctx);
+        return NULL;
+    }
+
     printf("[MoltenVK] Context initialized\n");
     return ctx;
 }
@@ -37,10 +283,7 @@ void pv_moltenvk_cleanup(struct pv_moltenvk_context *ctx)
     }
 
     /* Destroy device */
-    if (ctx->device_created && ctx->device) {
-        vkDestroyDevice(ctx->device, NULL);
-        printf("[MoltenVK] Destroyed device\n");
-    }
+    pv_moltenvk_destroy_device(ctx);
 
     /* Destroy instance */
     if (ctx->instance_created && ctx->instance) {
@@ -53,6 +296,8 @@ void pv_moltenvk_cleanup(struct pv_moltenvk_context *ctx)
         free(ctx->queue_families);
     }
 
+    pthread_mutex_destroy(&ctx->queue_lock);
+    pthread_mutex_destroy(&ctx->pipeline_cache_lock);
     free(ctx);
     printf("[MoltenVK] Context cleaned up\n");
 }
@@ -177,6 +422,70 @@ VkResult pv_moltenvk_select_physical_device(
     return VK_SUCCESS;
 }
 
+/*
+ * Take the next queue of @family for a new role, if it has a spare one
+ */
+static bool take_queue(const struct pv_moltenvk_context *ctx, uint32_t *taken,
+                       uint32_t family, uint32_t *index)
+{
+    if (taken[family] >= ctx->queue_families[family].queueCount) {
+        return false;
+    }
+    *index = taken[family]++;
+    return true;
+}
+
+/*
+ * First family with all of @required and none of @excluded that has a spare queue
+ */
+static bool take_family_queue(const struct pv_moltenvk_context *ctx, uint32_t *taken,
+                              VkQueueFlags required, VkQueueFlags excluded,
+                              uint32_t *family, uint32_t *index)
+{
+    for (uint32_t i = 0; i < ctx->queue_family_count; i++) {
+        VkQueueFlags flags = ctx->queue_families[i].queueFlags;
+        if ((flags & required) == required && !(flags & excluded) &&
+            take_queue(ctx, taken, i, index)) {
+            *family = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Pick compute and transfer queues (graphics is already family.0)
+ *
+ * Async compute and copies only overlap graphics work on queues of their
+ * own: prefer families dedicated to the job, then spare queues of the
+ * graphics family (MoltenVK exposes one family with several queues, each
+ * its own Metal command queue), and share the graphics queue last.
+ * @taken counts the queues used per family.
+ */
+static void select_queues(struct pv_moltenvk_context *ctx, uint32_t *taken)
+{
+    uint32_t graphics_family = ctx->graphics_queue_family;
+
+    ctx->compute_queue_family = graphics_family;
+    ctx->compute_queue_index = 0;
+    if (!take_family_queue(ctx, taken, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT,
+                           &ctx->compute_queue_family, &ctx->compute_queue_index)) {
+        take_queue(ctx, taken, graphics_family, &ctx->compute_queue_index);
+    }
+
+    /* Graphics and compute queues take copies too */
+    ctx->transfer_queue_family = graphics_family;
+    ctx->transfer_queue_index = 0;
+    if (!take_family_queue(ctx, taken, VK_QUEUE_TRANSFER_BIT,
+                           VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT,
+                           &ctx->transfer_queue_family, &ctx->transfer_queue_index) &&
+        !take_queue(ctx, taken, graphics_family, &ctx->transfer_queue_index) &&
+        ctx->compute_queue_family != graphics_family &&
+        take_queue(ctx, taken, ctx->compute_queue_family, &ctx->transfer_queue_index)) {
+        ctx->transfer_queue_family = ctx->compute_queue_family;
+    }
+}
+
 /*
  * Create logical device
  */
@@ -206,28 +515,44 @@ VkResult pv_moltenvk_create_device(
         return VK_ERROR_FEATURE_NOT_PRESENT;
     }
 
+    uint32_t *taken = calloc(ctx->queue_family_count, sizeof(*taken));
+    VkDeviceQueueCreateInfo *queue_create_infos =
+        calloc(ctx->queue_family_count, sizeof(*queue_create_infos));
+    if (!taken || !queue_create_infos) {
+        free(taken);
+        free(queue_create_infos);
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    taken[graphics_family] = 1;
     ctx->graphics_queue_family = graphics_family;
-    ctx->compute_queue_family = graphics_family;  /* Same on Apple Silicon */
-    ctx->transfer_queue_family = graphics_family;
+    select_queues(ctx, taken);
 
-    /* Queue create info */
-    float queue_priority = 1.0f;
-    VkDeviceQueueCreateInfo queue_create_info = {
-        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-        .pNext = NULL,
-        .flags = 0,
-        .queueFamilyIndex = graphics_family,
-        .queueCount = 1,
-        .pQueuePriorities = &queue_priority,
-    };
+    /* One create info per family in use; at most three queues each */
+    static const float queue_priorities[3] = { 1.0f, 1.0f, 1.0f };
+    uint32_t queue_create_count = 0;
+    for (uint32_t i = 0; i < ctx->queue_family_count; i++) {
+        if (taken[i] == 0) {
+            continue;
+        }
+        queue_create_infos[queue_create_count++] = (VkDeviceQueueCreateInfo){
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .pNext = NULL,
+            .flags = 0,
+            .queueFamilyIndex = i,
+            .queueCount = taken[i],
+            .pQueuePriorities = queue_priorities,
+        };
+    }
+    free(taken);
 
     /* Device create info */
     VkDeviceCreateInfo create_info = {
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
         .pNext = NULL,
         .flags = 0,
-        .queueCreateInfoCount = 1,
-        .pQueueCreateInfos = &queue_create_info,
+        .queueCreateInfoCount = queue_create_count,
+        .pQueueCreateInfos = queue_create_infos,
         .enabledLayerCount = 0,
         .ppEnabledLayerNames = NULL,
         .enabledExtensionCount = 0,
@@ -238,6 +563,7 @@ VkResult pv_moltenvk_create_device(
     /* Create device */
     VkResult result = vkCreateDevice(ctx->physical_device, &create_info, 
                                       NULL, &ctx->device);
+    free(queue_create_infos);
     if (result != VK_SUCCESS) {
         fprintf(stderr, "[MoltenVK] Failed to create device: %d\n", result);
         return result;
@@ -247,15 +573,124 @@ VkResult pv_moltenvk_create_device(
 
     /* Get queue handles */
     vkGetDeviceQueue(ctx->device, graphics_family, 0, &ctx->graphics_queue);
-    ctx->compute_queue = ctx->graphics_queue;
-    ctx->transfer_queue = ctx->graphics_queue;
+    vkGetDeviceQueue(ctx->device, ctx->compute_queue_family, ctx->compute_queue_index,
+                     &ctx->compute_queue);
+    vkGetDeviceQueue(ctx->device, ctx->transfer_queue_family, ctx->transfer_queue_index,
+                     &ctx->transfer_queue);
 
     printf("[MoltenVK] Device created successfully\n");
-    printf("[MoltenVK] Graphics queue family: %u\n", graphics_family);
+    printf("[MoltenVK] Queues: graphics %u.0, compute %u.%u%s, transfer %u.%u%s\n",
+           graphics_family,
+           ctx->compute_queue_family, ctx->compute_queue_index,
+           ctx->compute_queue == ctx->graphics_queue ? " (shared)" : "",
+           ctx->transfer_queue_family, ctx->transfer_queue_index,
+           ctx->transfer_queue == ctx->graphics_queue ? " (shared)" :
+           ctx->transfer_queue == ctx->compute_queue ? " (shared with compute)" : "");
+
+    /* Without a cache pipelines still work, just compiled from scratch */
+    pipeline_cache_open(ctx);
 
     return VK_SUCCESS;
 }
 
+/*
+ * Map a guest queue request onto a device queue
+ */
+VkQueue pv_moltenvk_get_queue(
+    const struct pv_moltenvk_context *ctx,
+    uint32_t family,
+    uint32_t index)
+{
+    if (!ctx || !ctx->device_created || family >= ctx->queue_family_count) {
+        return VK_NULL_HANDLE;
+    }
+
+    if (family == ctx->compute_queue_family && index == ctx->compute_queue_index) {
+        return ctx->compute_queue;
+    }
+    if (family == ctx->transfer_queue_family && index == ctx->transfer_queue_index) {
+        return ctx->transfer_queue;
+    }
+
+    VkQueueFlags flags = ctx->queue_families[family].queueFlags;
+    if (flags & VK_QUEUE_GRAPHICS_BIT) {
+        return ctx->graphics_queue;
+    }
+    if (flags & VK_QUEUE_COMPUTE_BIT) {
+        return ctx->compute_queue;
+    }
+    return ctx->transfer_queue;
+}
+
+/*
+ * Destroy logical device
+ */
+void pv_moltenvk_destroy_device(struct pv_moltenvk_context *ctx)
+{
+    if (!ctx || !ctx->device_created || !ctx->device) {
+        return;
+    }
+
+    if (ctx->pipeline_cache) {
+        pv_moltenvk_pipeline_cache_flush(ctx, true);
+        vkDestroyPipelineCache(ctx->device, ctx->pipeline_cache, NULL);
+        ctx->pipeline_cache = VK_NULL_HANDLE;
+    }
+    free(ctx->pipeline_cache_path);
+    ctx->pipeline_cache_path = NULL;
+
+    vkDestroyDevice(ctx->device, NULL);
+    ctx->device = VK_NULL_HANDLE;
+    ctx->device_created = false;
+    printf("[MoltenVK] Destroyed device\n");
+}
+
+/*
+ * Flush pipeline cache to disk
+ */
+int pv_moltenvk_pipeline_cache_flush(struct pv_moltenvk_context *ctx, bool force)
+{
+    if (!ctx || !ctx->pipeline_cache || !ctx->pipeline_cache_path) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&ctx->pipeline_cache_lock);
+
+    time_t now = time(NULL);
+    if (!force && now - ctx->pipeline_cache_flushed < PV_MOLTENVK_PIPELINE_CACHE_FLUSH_INTERVAL) {
+        pthread_mutex_unlock(&ctx->pipeline_cache_lock);
+        return 0;
+    }
+    ctx->pipeline_cache_flushed = now;
+
+    /* Caches only grow, so an unchanged size means nothing new to save */
+    size_t size = 0;
+    VkResult result = vkGetPipelineCacheData(ctx->device, ctx->pipeline_cache, &size, NULL);
+    if (result != VK_SUCCESS || size == ctx->pipeline_cache_saved) {
+        pthread_mutex_unlock(&ctx->pipeline_cache_lock);
+        return result == VK_SUCCESS ? 0 : -1;
+    }
+
+    void *data = malloc(size);
+    int written = -1;
+    if (data) {
+        result = vkGetPipelineCacheData(ctx->device, ctx->pipeline_cache, &size, data);
+        if (result == VK_SUCCESS && pipeline_cache_write(ctx, data, size) == 0) {
+            ctx->pipeline_cache_saved = size;
+            written = 0;
+        }
+        free(data);
+    }
+
+    pthread_mutex_unlock(&ctx->pipeline_cache_lock);
+
+    if (written == 0) {
+        printf("[MoltenVK] Pipeline cache: %zu bytes written to %s\n",
+               size, ctx->pipeline_cache_path);
+    }
+    return written;
+}
+
 /*
  * Print Vulkan information
  */
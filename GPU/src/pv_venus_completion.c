@@ -0,0 +1,455 @@
+/*
+ * PearVisor - Venus Submit Completion Tracking Implementation
+ */
+
+#include "pv_venus_completion.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+/*
+ * Make progress visible (lock held)
+ *
+ * The host reads only its own copy; the guest may scribble on its page.
+ */
+static void publish_locked(struct pv_venus_completion_tracker *tracker,
+                           uint64_t submitted, uint64_t completed)
+{
+    if (submitted) {
+        tracker->submitted = submitted;
+        if (tracker->page) {
+            atomic_store_explicit(&tracker->page->submitted, submitted, memory_order_release);
+        }
+    }
+    if (completed) {
+        tracker->completed = completed;
+        if (tracker->page) {
+            atomic_store_explicit(&tracker->page->completed, completed, memory_order_release);
+        }
+    }
+}
+
+/* Mark the context lost at guest submit @seqno (lock held) */
+static void fail_locked(struct pv_venus_completion_tracker *tracker, uint64_t seqno)
+{
+    tracker->stats.errors++;
+    if (tracker->failed == 0 || seqno < tracker->failed) {
+        tracker->failed = seqno;
+        if (tracker->page) {
+            atomic_store_explicit(&tracker->page->failed, seqno, memory_order_release);
+        }
+    }
+}
+
+/* Keep a signalled fence for reuse (lock held) */
+static void recycle_locked(struct pv_venus_completion_tracker *tracker, void *fence)
+{
+    if (tracker->free_count == tracker->free_capacity) {
+        uint32_t capacity = tracker->free_capacity ? tracker->free_capacity * 2 : 16;
+        void **grown = realloc(tracker->free_fences, capacity * sizeof(*grown));
+        if (!grown) {
+            tracker->backend.destroy(tracker->backend.user_data, fence);
+            return;
+        }
+        tracker->free_fences = grown;
+        tracker->free_capacity = capacity;
+    }
+    tracker->free_fences[tracker->free_count++] = fence;
+}
+
+/*
+ * Completion thread: wait on the oldest submission, publish, repeat
+ *
+ * Exits on stop only once nothing is in flight.
+ */
+static void *completion_main(void *arg)
+{
+    struct pv_venus_completion_tracker *tracker = arg;
+
+    pthread_mutex_lock(&tracker->lock);
+    for (;;) {
+        while (tracker->count == 0 && !tracker->stop) {
+            pthread_cond_wait(&tracker->wake, &tracker->lock);
+        }
+        if (tracker->count == 0) {
+            break;
+        }
+
+        /* Only this thread pops, so the copy stays valid unlocked */
+        struct pv_venus_completion_entry entry = tracker->entries[tracker->head];
+        pthread_mutex_unlock(&tracker->lock);
+
+        int result = entry.failed ? -1 :
+                     tracker->backend.wait(tracker->backend.user_data, entry.fence,
+                                           PV_VENUS_COMPLETION_WAIT_NS);
+        if (result == 0) {
+            pthread_mutex_lock(&tracker->lock);
+            continue;
+        }
+        if (result < 0 && !entry.failed) {
+            /* Device lost or similar: nothing will signal, don't strand waiters */
+            fprintf(stderr, "[Venus Completion] Fence wait failed for submit %llu\n",
+                    (unsigned long long)entry.seqno);
+        } else if (entry.owned) {
+            tracker->backend.reset(tracker->backend.user_data, entry.fence);
+        }
+
+        pthread_mutex_lock(&tracker->lock);
+        tracker->head = (tracker->head + 1) % tracker->capacity;
+        tracker->count--;
+        if (result < 0) {
+            fail_locked(tracker, entry.seqno);
+            if (entry.owned) {
+                tracker->backend.destroy(tracker->backend.user_data, entry.fence);
+            }
+        } else if (entry.owned) {
+            recycle_locked(tracker, entry.fence);
+        }
+
+        publish_locked(tracker, 0, entry.seqno);
+        tracker->stats.completions++;
+        pthread_cond_broadcast(&tracker->done);
+    }
+    pthread_mutex_unlock(&tracker->lock);
+
+    return NULL;
+}
+
+/*
+ * Tracker: Initialize
+ */
+int pv_venus_completion_init(struct pv_venus_completion_tracker *tracker,
+                             const struct pv_venus_completion_backend *backend)
+{
+    if (!tracker || !backend || !backend->wait || !backend->reset || !backend->destroy) {
+        return -1;
+    }
+
+    memset(tracker, 0, sizeof(*tracker));
+    tracker->backend = *backend;
+
+    if (pthread_mutex_init(&tracker->lock, NULL) != 0) {
+        return -1;
+    }
+    if (pthread_cond_init(&tracker->wake, NULL) != 0) {
+        pthread_mutex_destroy(&tracker->lock);
+        return -1;
+    }
+    if (pthread_cond_init(&tracker->done, NULL) != 0) {
+        pthread_cond_destroy(&tracker->wake);
+        pthread_mutex_destroy(&tracker->lock);
+        return -1;
+    }
+
+    if (pthread_create(&tracker->thread, NULL, completion_main, tracker) != 0) {
+        fprintf(stderr, "[Venus Completion] Failed to start completion thread\n");
+        pthread_cond_destroy(&tracker->done);
+        pthread_cond_destroy(&tracker->wake);
+        pthread_mutex_destroy(&tracker->lock);
+        return -1;
+    }
+    tracker->thread_running = true;
+    return 0;
+}
+
+/*
+ * Tracker: Destroy
+ */
+void pv_venus_completion_destroy(struct pv_venus_completion_tracker *tracker)
+{
+    if (!tracker || !tracker->thread_running) {
+        return;
+    }
+
+    pthread_mutex_lock(&tracker->lock);
+    tracker->stop = true;
+    pthread_cond_signal(&tracker->wake);
+    pthread_mutex_unlock(&tracker->lock);
+    pthread_join(tracker->thread, NULL);
+
+    for (uint32_t i = 0; i < tracker->free_count; i++) {
+        tracker->backend.destroy(tracker->backend.user_data, tracker->free_fences[i]);
+    }
+
+    printf("[Venus Completion] Final stats: submissions=%llu completions=%llu errors=%llu "
+           "host_waits=%llu\n",
+           tracker->stats.submissions, tracker->stats.completions, tracker->stats.errors,
+           tracker->stats.host_waits);
+
+    free(tracker->entries);
+    free(tracker->free_fences);
+    pthread_cond_destroy(&tracker->done);
+    pthread_cond_destroy(&tracker->wake);
+    pthread_mutex_destroy(&tracker->lock);
+    memset(tracker, 0, sizeof(*tracker));
+}
+
+/*
+ * Tracker: Attach the guest's page
+ */
+int pv_venus_completion_attach_page(struct pv_venus_completion_tracker *tracker,
+                                    struct pv_venus_completion_page *page,
+                                    size_t size)
+{
+    if (!tracker || !page || size < sizeof(*page)) {
+        return -1;
+    }
+
+    size_t slots = (size - sizeof(*page)) / sizeof(page->fences[0]);
+    if (slots > UINT32_MAX) {
+        slots = UINT32_MAX;
+    }
+
+    pthread_mutex_lock(&tracker->lock);
+    page->magic = PV_VENUS_COMPLETION_MAGIC;
+    page->version = PV_VENUS_COMPLETION_VERSION;
+    page->fence_slot_count = (uint32_t)slots;
+    for (size_t i = 0; i < slots; i++) {
+        atomic_store_explicit(&page->fences[i], PV_VENUS_FENCE_UNSIGNALED, memory_order_relaxed);
+    }
+    atomic_store_explicit(&page->submitted, tracker->submitted, memory_order_relaxed);
+    atomic_store_explicit(&page->failed, tracker->failed, memory_order_relaxed);
+    atomic_store_explicit(&page->completed, tracker->completed, memory_order_release);
+    tracker->page = page;
+    tracker->page_fence_slots = (uint32_t)slots;
+    pthread_mutex_unlock(&tracker->lock);
+    return 0;
+}
+
+/*
+ * Tracker: Page attached?
+ */
+bool pv_venus_completion_has_page(struct pv_venus_completion_tracker *tracker)
+{
+    if (!tracker) {
+        return false;
+    }
+
+    pthread_mutex_lock(&tracker->lock);
+    bool attached = tracker->page != NULL;
+    pthread_mutex_unlock(&tracker->lock);
+    return attached;
+}
+
+/*
+ * Tracker: Mirror a fence slot
+ */
+void pv_venus_completion_set_fence(struct pv_venus_completion_tracker *tracker,
+                                   uint32_t slot, uint64_t seqno)
+{
+    if (!tracker) {
+        return;
+    }
+
+    pthread_mutex_lock(&tracker->lock);
+    if (tracker->page && slot < tracker->page_fence_slots) {
+        atomic_store_explicit(&tracker->page->fences[slot], seqno, memory_order_release);
+    }
+    pthread_mutex_unlock(&tracker->lock);
+}
+
+/*
+ * Tracker: Take a pooled fence
+ */
+void *pv_venus_completion_take_fence(struct pv_venus_completion_tracker *tracker)
+{
+    if (!tracker) {
+        return NULL;
+    }
+
+    void *fence = NULL;
+    pthread_mutex_lock(&tracker->lock);
+    if (tracker->free_count > 0) {
+        fence = tracker->free_fences[--tracker->free_count];
+    } else {
+        tracker->stats.fences_created++;
+    }
+    pthread_mutex_unlock(&tracker->lock);
+    return fence;
+}
+
+/* Queue an entry for the completion thread (lock held) */
+static int enqueue_locked(struct pv_venus_completion_tracker *tracker,
+                          struct pv_venus_completion_entry entry)
+{
+    if (tracker->count == tracker->capacity) {
+        /* Unroll the circle into a bigger array */
+        uint32_t capacity = tracker->capacity ? tracker->capacity * 2 : 64;
+        struct pv_venus_completion_entry *grown = malloc(capacity * sizeof(*grown));
+        if (!grown) {
+            return -1;
+        }
+        for (uint32_t i = 0; i < tracker->count; i++) {
+            grown[i] = tracker->entries[(tracker->head + i) % tracker->capacity];
+        }
+        free(tracker->entries);
+        tracker->entries = grown;
+        tracker->capacity = capacity;
+        tracker->head = 0;
+    }
+
+    tracker->entries[(tracker->head + tracker->count) % tracker->capacity] = entry;
+    tracker->count++;
+    tracker->stats.submissions++;
+    if (tracker->count > tracker->stats.max_in_flight) {
+        tracker->stats.max_in_flight = tracker->count;
+    }
+    publish_locked(tracker, entry.seqno, 0);
+
+    pthread_cond_signal(&tracker->wake);
+    return 0;
+}
+
+/*
+ * Tracker: Track a submission
+ */
+int pv_venus_completion_push(struct pv_venus_completion_tracker *tracker,
+                             void *fence, bool owned, uint64_t seqno)
+{
+    if (!tracker || !fence) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&tracker->lock);
+    int result = enqueue_locked(tracker, (struct pv_venus_completion_entry){
+        .fence = fence, .seqno = seqno, .owned = owned });
+    pthread_mutex_unlock(&tracker->lock);
+    return result;
+}
+
+/*
+ * Tracker: Record a failed submission
+ */
+void pv_venus_completion_push_failed(struct pv_venus_completion_tracker *tracker,
+                                     uint64_t seqno)
+{
+    if (!tracker) {
+        return;
+    }
+
+    pthread_mutex_lock(&tracker->lock);
+    if (enqueue_locked(tracker, (struct pv_venus_completion_entry){
+            .seqno = seqno, .failed = true }) != 0) {
+        /* Can't keep it in order: lose the context now, wake every waiter */
+        fail_locked(tracker, seqno);
+        pthread_cond_broadcast(&tracker->done);
+    }
+    pthread_mutex_unlock(&tracker->lock);
+}
+
+/*
+ * Tracker: First failed submit
+ */
+uint64_t pv_venus_completion_failed(struct pv_venus_completion_tracker *tracker)
+{
+    if (!tracker) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&tracker->lock);
+    uint64_t failed = tracker->failed;
+    pthread_mutex_unlock(&tracker->lock);
+    return failed;
+}
+
+/*
+ * Tracker: Block until a submit completes
+ */
+void pv_venus_completion_wait(struct pv_venus_completion_tracker *tracker, uint64_t seqno)
+{
+    pv_venus_completion_wait_timeout(tracker, seqno, UINT64_MAX);
+}
+
+/*
+ * Tracker: Block until a submit completes, with a timeout
+ */
+int pv_venus_completion_wait_timeout(struct pv_venus_completion_tracker *tracker,
+                                     uint64_t seqno, uint64_t timeout_ns)
+{
+    if (!tracker) {
+        return 1;
+    }
+
+    struct timespec until;
+    clock_gettime(CLOCK_REALTIME, &until);
+    if (timeout_ns != UINT64_MAX) {
+        until.tv_sec += (time_t)(timeout_ns / 1000000000ull);
+        until.tv_nsec += (long)(timeout_ns % 1000000000ull);
+        if (until.tv_nsec >= 1000000000L) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+    }
+
+    pthread_mutex_lock(&tracker->lock);
+    if (tracker->completed < seqno && tracker->count > 0 && timeout_ns > 0) {
+        tracker->stats.host_waits++;
+    }
+    /*
+     * A seqno never pushed would wait forever; stop once nothing is in
+     * flight, or once the context is lost
+     */
+    while (tracker->completed < seqno && tracker->count > 0 && !tracker->failed &&
+           timeout_ns > 0) {
+        if (timeout_ns == UINT64_MAX) {
+            pthread_cond_wait(&tracker->done, &tracker->lock);
+        } else if (pthread_cond_timedwait(&tracker->done, &tracker->lock, &until) == ETIMEDOUT) {
+            break;
+        }
+    }
+    int result = tracker->failed ? -1 : tracker->completed >= seqno ? 0 : 1;
+    pthread_mutex_unlock(&tracker->lock);
+    return result;
+}
+
+/*
+ * Tracker: Drain
+ */
+void pv_venus_completion_drain(struct pv_venus_completion_tracker *tracker)
+{
+    if (!tracker || !tracker->thread_running) {
+        return;
+    }
+
+    pthread_mutex_lock(&tracker->lock);
+    while (tracker->count > 0) {
+        pthread_cond_wait(&tracker->done, &tracker->lock);
+    }
+    for (uint32_t i = 0; i < tracker->free_count; i++) {
+        tracker->backend.destroy(tracker->backend.user_data, tracker->free_fences[i]);
+    }
+    tracker->free_count = 0;
+    pthread_mutex_unlock(&tracker->lock);
+}
+
+/*
+ * Tracker: Completed seqno
+ */
+uint64_t pv_venus_completion_completed(struct pv_venus_completion_tracker *tracker)
+{
+    if (!tracker) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&tracker->lock);
+    uint64_t completed = tracker->completed;
+    pthread_mutex_unlock(&tracker->lock);
+    return completed;
+}
+
+/*
+ * Tracker: Get statistics
+ */
+void pv_venus_completion_get_stats(struct pv_venus_completion_tracker *tracker,
+                                   struct pv_venus_completion_stats *stats)
+{
+    if (!tracker || !stats) {
+        return;
+    }
+
+    pthread_mutex_lock(&tracker->lock);
+    *stats = tracker->stats;
+    pthread_mutex_unlock(&tracker->lock);
+}
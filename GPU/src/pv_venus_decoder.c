@@ -7,6 +7,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Context generations: a freed context's address may be reused, its number never */
+static atomic_uint_fast64_t next_generation = 1;
+
 /*
  * Create dispatch context
  */
@@ -21,6 +24,13 @@ struct pv_venus_dispatch_context *pv_venus_dispatch_create(void)
     /* Initialize handler table to NULL */
     memset(ctx->handlers, 0, sizeof(ctx->handlers));
 
+    if (pthread_mutex_init(&ctx->latency_lock, NULL) != 0) {
+        fprintf(stderr, "[Venus Decoder] Failed to init latency lock\n");
+        free(ctx);
+        return NULL;
+    }
+    ctx->generation = atomic_fetch_add_explicit(&next_generation, 1, memory_order_relaxed);
+
     printf("[Venus Decoder] Created dispatch context\n");
     return ctx;
 }
@@ -39,6 +49,18 @@ void pv_venus_dispatch_destroy(struct pv_venus_dispatch_context *ctx)
            ctx->commands_unknown,
            ctx->commands_failed);
 
+    /* Free per-thread latency tables */
+    struct pv_venus_latency_table *table = atomic_load(&ctx->latency_tables);
+    while (table) {
+        struct pv_venus_latency_table *next = table->next;
+        for (uint32_t i = 0; i < PV_VENUS_MAX_COMMAND_ID; i++) {
+            free(atomic_load_explicit(&table->commands[i], memory_order_relaxed));
+        }
+        free(table);
+        table = next;
+    }
+    pthread_mutex_destroy(&ctx->latency_lock);
+
     free(ctx);
 }
 
@@ -59,65 +81,191 @@ void pv_venus_dispatch_register(
            pv_venus_command_name(command_id), command_id);
 }
 
+/* Ring whose command the calling thread is dispatching (NULL outside handlers) */
+static _Thread_local struct pv_venus_ring *dispatching_ring;
+
 /*
- * Process one command from ring buffer
+ * Scratch arena of the ring being decoded
  */
-int pv_venus_decode_command(
+struct pv_venus_ring_arena *pv_venus_dispatch_arena(void)
+{
+    return dispatching_ring ? &dispatching_ring->arena : NULL;
+}
+
+/* Calling thread's latency table, cached per thread by context generation */
+static _Thread_local struct {
+    uint64_t generation;
+    struct pv_venus_latency_table *table;
+} latency_cache;
+
+/*
+ * Find or create the calling thread's latency table in @ctx
+ */
+static struct pv_venus_latency_table *latency_table(struct pv_venus_dispatch_context *ctx)
+{
+    if (latency_cache.generation == ctx->generation) {
+        return latency_cache.table;
+    }
+
+    pthread_mutex_lock(&ctx->latency_lock);
+
+    pthread_t self = pthread_self();
+    struct pv_venus_latency_table *table = atomic_load(&ctx->latency_tables);
+    while (table && !pthread_equal(table->thread, self)) {
+        table = table->next;
+    }
+
+    if (!table) {
+        table = calloc(1, sizeof(*table));
+        if (table) {
+            table->thread = self;
+            table->next = atomic_load(&ctx->latency_tables);
+            atomic_store(&ctx->latency_tables, table);
+        }
+    }
+
+    pthread_mutex_unlock(&ctx->latency_lock);
+
+    if (table) {
+        latency_cache.generation = ctx->generation;
+        latency_cache.table = table;
+    }
+    return table;
+}
+
+/*
+ * Record latencies for one decoded command
+ */
+static void record_latency(
     struct pv_venus_ring *ring,
-    struct pv_venus_dispatch_context *ctx)
+    struct pv_venus_dispatch_context *ctx,
+    uint32_t command_id,
+    uint64_t start_ns,
+    uint64_t seen_ns)
 {
-    if (!ring || !ctx) {
-        return -1;
+    uint64_t now = pv_venus_clock_ns();
+
+    pv_venus_latency_record(&ring->stats.queue_latency, now - seen_ns);
+
+    struct pv_venus_latency_table *table = latency_table(ctx);
+    if (!table) {
+        return;
+    }
+
+    struct pv_venus_command_latency *latency =
+        atomic_load_explicit(&table->commands[command_id], memory_order_relaxed);
+    if (!latency) {
+        latency = calloc(1, sizeof(*latency));
+        if (!latency) {
+            return;
+        }
+        atomic_store_explicit(&table->commands[command_id], latency, memory_order_release);
     }
 
-    /* Read command header */
+    pv_venus_latency_record(&latency->dispatch, now - start_ns);
+    pv_venus_latency_record(&latency->queue, now - seen_ns);
+}
+
+/*
+ * Snapshot latency histograms for one command
+ */
+uint64_t pv_venus_dispatch_latency(
+    struct pv_venus_dispatch_context *ctx,
+    uint32_t command_id,
+    struct pv_venus_command_latency *latency)
+{
+    if (!ctx || !latency || command_id >= PV_VENUS_MAX_COMMAND_ID) {
+        return 0;
+    }
+
+    memset(latency, 0, sizeof(*latency));
+
+    struct pv_venus_latency_table *table = atomic_load(&ctx->latency_tables);
+    for (; table; table = table->next) {
+        const struct pv_venus_command_latency *src =
+            atomic_load_explicit(&table->commands[command_id], memory_order_acquire);
+        if (src) {
+            pv_venus_latency_merge(&latency->dispatch, &src->dispatch);
+            pv_venus_latency_merge(&latency->queue, &src->queue);
+        }
+    }
+
+    return latency->dispatch.count;
+}
+
+/*
+ * Give up on a ring whose framing can't be trusted
+ * 
+ * Once a header is bad there's no way to find the next command, so the
+ * ring is marked in error for the guest and nothing more is decoded
+ * until the guest resets it (see pv_venus_ring_recover).
+ */
+static int framing_error(
+    struct pv_venus_ring *ring,
+    struct pv_venus_dispatch_context *ctx,
+    const char *what)
+{
+    fprintf(stderr, "[Venus Decoder] %s at %u (tail %u), ring stopped\n",
+            what, ring->buffer.current_pos, pv_venus_ring_get_tail(ring));
+    ring->framing_lost = true;
+    atomic_fetch_or(ring->control.status, PV_VENUS_RING_STATUS_ERROR);
+    ring->stats.errors++;
+    ctx->commands_failed++;
+    return PV_VENUS_DECODE_FRAMING_ERROR;
+}
+
+/*
+ * Decode and dispatch one command
+ * 
+ * @seen_ns: When the tail covering this command was first observed
+ */
+static int decode_one(
+    struct pv_venus_ring *ring,
+    struct pv_venus_dispatch_context *ctx,
+    uint64_t seen_ns)
+{
+    uint64_t start_ns = pv_venus_clock_ns();
+
+    /* Read command header, never past what the guest has published */
     struct pv_venus_command_header header;
+    if (pv_venus_ring_available(ring) < sizeof(header)) {
+        return framing_error(ring, ctx, "Truncated command header");
+    }
     if (pv_venus_ring_read(ring, &header, sizeof(header)) != 0) {
-        fprintf(stderr, "[Venus Decoder] Failed to read command header\n");
-        ctx->commands_failed++;
-        return -1;
+        return framing_error(ring, ctx, "Failed to read command header");
     }
 
     /* Validate header */
     if (pv_venus_validate_command_header(&header) != 0) {
-        fprintf(stderr, "[Venus Decoder] Invalid command header\n");
-        ctx->commands_failed++;
-        return -1;
+        return framing_error(ring, ctx, "Invalid command header");
     }
 
     /* Calculate data size (header.command_size includes header) */
     size_t data_size = header.command_size - sizeof(header);
 
-    /* Read command data (if any) */
-    void *data = NULL;
+    /* View command data (if any) in place - copied only if it wraps */
+    struct pv_venus_ring_view view = {0};
     if (data_size > 0) {
-        data = malloc(data_size);
-        if (!data) {
-            fprintf(stderr, "[Venus Decoder] Failed to allocate command data\n");
-            ctx->commands_failed++;
-            return -1;
-        }
-
-        if (pv_venus_ring_read(ring, data, data_size) != 0) {
-            fprintf(stderr, "[Venus Decoder] Failed to read command data\n");
-            free(data);
-            ctx->commands_failed++;
-            return -1;
+        if (pv_venus_ring_view_acquire(ring, data_size, &view) != 0) {
+            return framing_error(ring, ctx, "Command runs past the tail");
         }
     }
+    const void *data = view.data;
 
     /* Log command for debugging */
-    printf("[Venus Decoder] Command: %s (id=%u size=%u)\n",
-           pv_venus_command_name(header.command_id),
-           header.command_id,
-           header.command_size);
+    pv_venus_trace("[Venus Decoder] Command: %s (id=%u size=%u)\n",
+                   pv_venus_command_name(header.command_id),
+                   header.command_id,
+                   header.command_size);
 
     /* Dispatch to handler */
     pv_venus_command_handler_t handler = ctx->handlers[header.command_id];
     
     int ret = 0;
     if (handler) {
+        dispatching_ring = ring;
         ret = handler(ctx, &header, data, data_size);
+        dispatching_ring = NULL;
         if (ret != 0) {
             fprintf(stderr, "[Venus Decoder] Handler failed for %s: %d\n",
                     pv_venus_command_name(header.command_id), ret);
@@ -126,19 +274,30 @@ int pv_venus_decode_command(
             ctx->commands_dispatched++;
         }
     } else {
-        printf("[Venus Decoder] No handler for %s\n",
-               pv_venus_command_name(header.command_id));
+        pv_venus_trace("[Venus Decoder] No handler for %s\n",
+                       pv_venus_command_name(header.command_id));
         ctx->commands_unknown++;
     }
 
-    /* Cleanup */
-    if (data) {
-        free(data);
-    }
+    record_latency(ring, ctx, header.command_id, start_ns, seen_ns);
 
     return ret;
 }
 
+/*
+ * Process one command from ring buffer
+ */
+int pv_venus_decode_command(
+    struct pv_venus_ring *ring,
+    struct pv_venus_dispatch_context *ctx)
+{
+    if (!ring || !ctx) {
+        return -1;
+    }
+
+    return decode_one(ring, ctx, pv_venus_clock_ns());
+}
+
 /*
  * Process all available commands from ring buffer
  */
@@ -153,25 +312,48 @@ int pv_venus_decode_all(
     int processed = 0;
     uint32_t tail = pv_venus_ring_get_tail(ring);
     uint32_t head = ring->buffer.current_pos;
+    uint32_t published = head;
+    uint32_t batch_commands = 0;
+    uint64_t seen_ns = pv_venus_clock_ns();
 
-    /* Process all available commands */
-    while (head != tail) {
-        if (pv_venus_decode_command(ring, ctx) != 0) {
-            /* Error occurred, but continue processing */
-            fprintf(stderr, "[Venus Decoder] Error processing command, continuing...\n");
+    /* Process all available commands; a failed handler doesn't stop the drain */
+    while (pv_venus_ring_seq_before(head, tail)) {
+        if (decode_one(ring, ctx, seen_ns) == PV_VENUS_DECODE_FRAMING_ERROR) {
+            head = ring->buffer.current_pos;
+            break;
         }
 
         processed++;
+        batch_commands++;
         
-        /* Update head and tail */
+        /* Update head; re-read tail once everything seen so far is done */
         head = ring->buffer.current_pos;
-        tail = pv_venus_ring_get_tail(ring);
+        if (!pv_venus_ring_seq_before(head, tail)) {
+            uint32_t new_tail = pv_venus_ring_get_tail(ring);
+            if (new_tail != tail) {
+                tail = new_tail;
+                seen_ns = pv_venus_clock_ns();
+            }
+        }
+
+        /* Publish head mid-drain so the guest can reuse ring space */
+        if ((ring->head_batch_bytes && head - published >= ring->head_batch_bytes) ||
+            (ring->head_batch_commands && batch_commands >= ring->head_batch_commands)) {
+            pv_venus_ring_set_head(ring, head);
+            ring->stats.head_publishes++;
+            published = head;
+            batch_commands = 0;
+        }
     }
 
     /* Update ring head */
-    if (processed > 0) {
+    if (head != published) {
         pv_venus_ring_set_head(ring, head);
+        ring->stats.head_publishes++;
     }
 
+    /* Drain boundary: nothing carved from the arena outlives it */
+    pv_venus_ring_arena_reset(&ring->arena);
+
     return processed;
 }
@@ -0,0 +1,190 @@
+/*
+ * PearVisor - Epoch-Based Reclamation Implementation
+ *
+ * Classic three-epoch scheme: a reader pins the global epoch it saw on
+ * entry; the global epoch only advances once every pinned reader has
+ * seen the current one; storage retired in epoch E is freed once the
+ * global epoch reaches E + 2, when no reader can still hold it.
+ */
+
+#include "pv_venus_epoch.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+/* Per-thread record, one cache line each so readers never share a line */
+struct epoch_record {
+    _Alignas(128) atomic_uint_fast64_t epoch;  /* Pinned epoch, 0 = not reading */
+    atomic_bool used;
+};
+
+/* Retired block waiting for readers to drain */
+struct epoch_limbo {
+    void *ptr;
+    uint64_t epoch;
+    struct epoch_limbo *next;
+};
+
+static struct epoch_record records[PV_VENUS_EPOCH_MAX_THREADS];
+static _Alignas(128) atomic_uint_fast64_t global_epoch = 1;
+static atomic_uint unrecorded_readers;     /* Readers that found no free record */
+
+static pthread_mutex_t limbo_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct epoch_limbo *limbo;
+static atomic_bool limbo_pending;          /* limbo != NULL, readable without the lock */
+
+static pthread_once_t record_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t record_key;
+
+static _Thread_local struct epoch_record *self;
+static _Thread_local uint32_t nesting;
+
+/* Give the record back when its thread exits */
+static void release_record(void *arg)
+{
+    struct epoch_record *record = arg;
+    atomic_store_explicit(&record->epoch, 0, memory_order_release);
+    atomic_store_explicit(&record->used, false, memory_order_release);
+}
+
+static void create_record_key(void)
+{
+    pthread_key_create(&record_key, release_record);
+}
+
+static struct epoch_record *claim_record(void)
+{
+    pthread_once(&record_key_once, create_record_key);
+
+    for (int i = 0; i < PV_VENUS_EPOCH_MAX_THREADS; i++) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&records[i].used, &expected, true)) {
+            pthread_setspecific(record_key, &records[i]);
+            return &records[i];
+        }
+    }
+
+    return NULL;
+}
+
+void pv_venus_epoch_enter(void)
+{
+    if (nesting++ > 0) {
+        return;
+    }
+
+    if (!self) {
+        self = claim_record();
+    }
+
+    if (self) {
+        atomic_store_explicit(&self->epoch,
+                              atomic_load_explicit(&global_epoch, memory_order_relaxed),
+                              memory_order_relaxed);
+        /* Publish the pin before loading any shared pointer */
+        atomic_thread_fence(memory_order_seq_cst);
+    } else {
+        /* Out of records: block epoch advances while we read */
+        atomic_fetch_add(&unrecorded_readers, 1);
+    }
+}
+
+void pv_venus_epoch_exit(void)
+{
+    if (--nesting > 0) {
+        return;
+    }
+
+    if (self) {
+        atomic_store_explicit(&self->epoch, 0, memory_order_release);
+    } else {
+        atomic_fetch_sub(&unrecorded_readers, 1);
+    }
+}
+
+/*
+ * Advance the global epoch if every pinned reader has seen it
+ * (called with limbo_lock held)
+ */
+static void try_advance(void)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+
+    uint64_t epoch = atomic_load(&global_epoch);
+    if (atomic_load(&unrecorded_readers) != 0) {
+        return;
+    }
+
+    for (int i = 0; i < PV_VENUS_EPOCH_MAX_THREADS; i++) {
+        if (!atomic_load_explicit(&records[i].used, memory_order_acquire)) {
+            continue;
+        }
+        uint64_t pinned = atomic_load_explicit(&records[i].epoch, memory_order_acquire);
+        if (pinned != 0 && pinned != epoch) {
+            return;
+        }
+    }
+
+    atomic_store(&global_epoch, epoch + 1);
+}
+
+/* Free limbo entries two epochs old (called with limbo_lock held) */
+static void reclaim_locked(void)
+{
+    try_advance();
+
+    uint64_t epoch = atomic_load(&global_epoch);
+    struct epoch_limbo **link = &limbo;
+    while (*link) {
+        struct epoch_limbo *item = *link;
+        if (item->epoch + 2 <= epoch) {
+            *link = item->next;
+            free(item->ptr);
+            free(item);
+        } else {
+            link = &item->next;
+        }
+    }
+
+    atomic_store_explicit(&limbo_pending, limbo != NULL, memory_order_relaxed);
+}
+
+void pv_venus_epoch_retire(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    struct epoch_limbo *item = malloc(sizeof(*item));
+    if (!item) {
+        /* Can't track it, and freeing now could pull it from under a reader */
+        fprintf(stderr, "[Venus Epoch] Out of memory, leaking retired block %p\n", ptr);
+        return;
+    }
+
+    /* Order the writer's unlink before reading the epoch it retires in */
+    atomic_thread_fence(memory_order_seq_cst);
+
+    pthread_mutex_lock(&limbo_lock);
+    item->ptr = ptr;
+    item->epoch = atomic_load(&global_epoch);
+    item->next = limbo;
+    limbo = item;
+    reclaim_locked();
+    pthread_mutex_unlock(&limbo_lock);
+}
+
+void pv_venus_epoch_reclaim(void)
+{
+    /* Cheap enough to call on every write */
+    if (!atomic_load_explicit(&limbo_pending, memory_order_relaxed)) {
+        return;
+    }
+
+    pthread_mutex_lock(&limbo_lock);
+    reclaim_locked();
+    pthread_mutex_unlock(&limbo_lock);
+}
@@ -7,6 +7,628 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* SPIR-V magic number (first word of every module) */
+#define SPIRV_MAGIC 0x07230203u
+
+/* One cache for the process; entries are still per device, so per context */
+static struct pv_venus_shader_cache shader_cache;
+static pthread_once_t shader_cache_once = PTHREAD_ONCE_INIT;
+static bool shader_cache_ready;
+
+/*
+ * Serialize a fixed-size query result into the reply ring
+ * 
+ * A no-op (success) when no reply ring is attached.
+ */
+static int reply_with(struct pv_venus_handler_context *ctx,
+                      const struct pv_venus_command_header *header,
+                      const void *result,
+                      size_t size)
+{
+    if (!ctx->reply) {
+        return 0;
+    }
+
+    struct pv_venus_reply_encoder encoder;
+    if (pv_venus_reply_begin(ctx->reply, &encoder, header->command_id, size) != 0) {
+        fprintf(stderr, "[Venus Handlers] Reply ring full, dropping %s reply\n",
+                pv_venus_command_name(header->command_id));
+        return -1;
+    }
+
+    pv_venus_reply_write(&encoder, result, size);
+    pv_venus_reply_end(&encoder, VK_SUCCESS);
+    return 0;
+}
+
+/*
+ * Report a bare VkResult through the reply ring (no-op without one)
+ */
+static int reply_result(struct pv_venus_handler_context *ctx,
+                        const struct pv_venus_command_header *header,
+                        VkResult result)
+{
+    if (!ctx->reply) {
+        return 0;
+    }
+
+    struct pv_venus_reply_encoder encoder;
+    if (pv_venus_reply_begin(ctx->reply, &encoder, header->command_id, 0) != 0) {
+        fprintf(stderr, "[Venus Handlers] Reply ring full, dropping %s reply\n",
+                pv_venus_command_name(header->command_id));
+        return -1;
+    }
+
+    pv_venus_reply_end(&encoder, result);
+    return 0;
+}
+
+/*
+ * Host handle of a guest object, only if it has the expected type
+ *
+ * Everything the guest names goes through here before it reaches the
+ * driver: an ID of the wrong type would hand the driver (or our own
+ * bookkeeping) a pointer to something else entirely.
+ */
+static void *object_get_typed(struct pv_venus_handler_context *ctx,
+                              pv_venus_object_id guest_id,
+                              pv_venus_object_type type)
+{
+    pv_venus_object_handle handle = pv_venus_object_lookup(&ctx->objects, guest_id);
+    if (pv_venus_object_handle_type(handle) != type) {
+        return NULL;
+    }
+    return pv_venus_object_resolve(&ctx->objects, handle);
+}
+
+/*
+ * Answer a physical device query from the cache
+ */
+static int reply_query(struct pv_venus_handler_context *ctx,
+                       const struct pv_venus_command_header *header,
+                       const void *data,
+                       size_t data_size)
+{
+    struct pv_venus_query_blob blob;
+    if (pv_venus_query_cache_lookup(&ctx->queries, header->command_id, data, data_size,
+                                    &blob) != 0) {
+        fprintf(stderr, "[Venus Handlers] %s before vkEnumeratePhysicalDevices\n",
+                pv_venus_command_name(header->command_id));
+        return -1;
+    }
+    return reply_with(ctx, header, blob.data, blob.size);
+}
+
+/*
+ * Query cache backend: one driver format query, made while building
+ */
+static void query_format_properties(void *user_data, VkFormat format,
+                                    VkFormatProperties *properties)
+{
+    struct pv_moltenvk_context *vk = user_data;
+    vkGetPhysicalDeviceFormatProperties(vk->physical_device, format, properties);
+}
+
+/*
+ * Suballocator backend: host blocks are plain device allocations
+ */
+static int memory_allocate_block(void *user_data, uint32_t memory_type,
+                                 uint64_t size, void **memory)
+{
+    struct pv_venus_handler_context *ctx = user_data;
+
+    VkMemoryAllocateInfo alloc_info = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = size,
+        .memoryTypeIndex = memory_type,
+    };
+
+    VkDeviceMemory block;
+    VkResult result = vkAllocateMemory(ctx->vk->device, &alloc_info, NULL, &block);
+    if (result != VK_SUCCESS) {
+        fprintf(stderr, "[Venus Handlers] vkAllocateMemory failed: %d\n", result);
+        return -1;
+    }
+
+    *memory = (void *)block;
+    return 0;
+}
+
+static void memory_free_block(void *user_data, uint32_t memory_type, void *memory)
+{
+    struct pv_venus_handler_context *ctx = user_data;
+    (void)memory_type;
+
+    vkFreeMemory(ctx->vk->device, (VkDeviceMemory)memory, NULL);
+}
+
+/*
+ * Clear a whole block on the transfer queue and wait for it
+ *
+ * Runs on the recycler thread, so it brings its own pool and fence.
+ * The transfer buffer must be allowed in the block's memory type and fit
+ * in the block; if not, the block can't be cleared this way and the
+ * caller releases it instead. Binding at offset 0 meets any alignment,
+ * and a size past the device's buffer limit fails in vkCreateBuffer.
+ */
+static int memory_fill_block(struct pv_venus_handler_context *ctx, uint32_t memory_type,
+                             VkDeviceMemory memory, uint64_t size)
+{
+    struct pv_moltenvk_context *vk = ctx->vk;
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkCommandPool pool = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+    VkResult result;
+
+    VkBufferCreateInfo buffer_info = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = size,
+        .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+    VkCommandPoolCreateInfo pool_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = vk->transfer_queue_family,
+    };
+    VkFenceCreateInfo fence_info = {
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+    };
+
+    result = vkCreateBuffer(vk->device, &buffer_info, NULL, &buffer);
+    if (result == VK_SUCCESS) {
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(vk->device, buffer, &requirements);
+        if (!(requirements.memoryTypeBits & (1u << memory_type)) || requirements.size > size) {
+            fprintf(stderr, "[Venus Handlers] Can't clear block: type %u size %llu "
+                    "(buffer wants types 0x%x, %llu bytes)\n",
+                    memory_type, (unsigned long long)size, requirements.memoryTypeBits,
+                    (unsigned long long)requirements.size);
+            vkDestroyBuffer(vk->device, buffer, NULL);
+            return -1;
+        }
+        result = vkBindBufferMemory(vk->device, buffer, memory, 0);
+    }
+    if (result == VK_SUCCESS) {
+        result = vkCreateCommandPool(vk->device, &pool_info, NULL, &pool);
+    }
+    if (result == VK_SUCCESS) {
+        result = vkCreateFence(vk->device, &fence_info, NULL, &fence);
+    }
+
+    if (result == VK_SUCCESS) {
+        VkCommandBufferAllocateInfo alloc_info = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1,
+        };
+        VkCommandBufferBeginInfo begin_info = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        };
+
+        VkCommandBuffer cmd;
+        result = vkAllocateCommandBuffers(vk->device, &alloc_info, &cmd);
+        if (result == VK_SUCCESS) {
+            result = vkBeginCommandBuffer(cmd, &begin_info);
+        }
+        if (result == VK_SUCCESS) {
+            vkCmdFillBuffer(cmd, buffer, 0, VK_WHOLE_SIZE, 0);
+            result = vkEndCommandBuffer(cmd);
+        }
+        if (result == VK_SUCCESS) {
+            VkSubmitInfo submit_info = {
+                .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                .commandBufferCount = 1,
+                .pCommandBuffers = &cmd,
+            };
+            pthread_mutex_lock(&vk->queue_lock);
+            result = vkQueueSubmit(vk->transfer_queue, 1, &submit_info, fence);
+            pthread_mutex_unlock(&vk->queue_lock);
+        }
+        if (result == VK_SUCCESS) {
+            result = vkWaitForFences(vk->device, 1, &fence, VK_TRUE, UINT64_MAX);
+        }
+    }
+
+    if (fence) {
+        vkDestroyFence(vk->device, fence, NULL);
+    }
+    if (pool) {
+        vkDestroyCommandPool(vk->device, pool, NULL);
+    }
+    if (buffer) {
+        vkDestroyBuffer(vk->device, buffer, NULL);
+    }
+
+    if (result != VK_SUCCESS) {
+        fprintf(stderr, "[Venus Handlers] Clearing %llu bytes failed: %d\n",
+                (unsigned long long)size, result);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Suballocator backend: scrub a freed block before it is reused
+ *
+ * Host-visible memory is cleared through a mapping; anything else on the
+ * transfer queue.
+ */
+static int memory_zero_block(void *user_data, uint32_t memory_type,
+                             void *memory, uint64_t size)
+{
+    struct pv_venus_handler_context *ctx = user_data;
+    struct pv_moltenvk_context *vk = ctx->vk;
+    VkMemoryPropertyFlags flags = vk->memory_properties.memoryTypes[memory_type].propertyFlags;
+
+    if (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        void *data;
+        if (vkMapMemory(vk->device, (VkDeviceMemory)memory, 0, VK_WHOLE_SIZE, 0,
+                        &data) == VK_SUCCESS) {
+            memset(data, 0, size);
+            if (!(flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+                VkMappedMemoryRange range = {
+                    .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+                    .memory = (VkDeviceMemory)memory,
+                    .offset = 0,
+                    .size = VK_WHOLE_SIZE,
+                };
+                vkFlushMappedMemoryRanges(vk->device, 1, &range);
+            }
+            vkUnmapMemory(vk->device, (VkDeviceMemory)memory);
+            return 0;
+        }
+    }
+
+    return memory_fill_block(ctx, memory_type, (VkDeviceMemory)memory, size);
+}
+
+/*
+ * Shader cache backend: plain vkCreateShaderModule on the entry's device
+ */
+static int shader_module_create(void *user_data, void *device, const uint32_t *code,
+                                size_t code_size, void **module)
+{
+    (void)user_data;
+
+    VkShaderModuleCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .pNext = NULL,
+        .flags = 0,
+        .codeSize = code_size,
+        .pCode = code,
+    };
+
+    VkShaderModule shader_module;
+    VkResult result = vkCreateShaderModule((VkDevice)device, &create_info, NULL,
+                                           &shader_module);
+    if (result != VK_SUCCESS) {
+        fprintf(stderr, "[Venus Handlers] vkCreateShaderModule failed: %d\n", result);
+        return -1;
+    }
+
+    *module = (void *)shader_module;
+    return 0;
+}
+
+static void shader_module_destroy(void *user_data, void *device, void *module)
+{
+    (void)user_data;
+    vkDestroyShaderModule((VkDevice)device, (VkShaderModule)module, NULL);
+}
+
+static void shader_cache_create(void)
+{
+    struct pv_venus_shader_cache_backend backend = {
+        .create = shader_module_create,
+        .destroy = shader_module_destroy,
+    };
+
+    shader_cache_ready = pv_venus_shader_cache_init(&shader_cache, &backend) == 0;
+}
+
+/*
+ * Process-wide shader cache
+ */
+struct pv_venus_shader_cache *pv_venus_handlers_shader_cache(void)
+{
+    pthread_once(&shader_cache_once, shader_cache_create);
+    return shader_cache_ready ? &shader_cache : NULL;
+}
+
+/*
+ * Set up the device memory suballocator
+ */
+int pv_venus_handlers_memory_init(struct pv_venus_handler_context *ctx)
+{
+    struct pv_venus_memory_backend backend = {
+        .allocate = memory_allocate_block,
+        .free = memory_free_block,
+        .zero = memory_zero_block,
+        .user_data = ctx,
+    };
+
+    return pv_venus_memory_allocator_init(&ctx->memory, &backend, 0, 0);
+}
+
+/*
+ * Completion backend: host fences
+ */
+static int completion_wait(void *user_data, void *fence, uint64_t timeout_ns)
+{
+    struct pv_venus_handler_context *ctx = user_data;
+    VkFence host_fence = fence;
+
+    VkResult result = vkWaitForFences(ctx->vk->device, 1, &host_fence, VK_TRUE, timeout_ns);
+    if (result == VK_TIMEOUT) {
+        return 0;
+    }
+    return result == VK_SUCCESS ? 1 : -1;
+}
+
+static void completion_reset(void *user_data, void *fence)
+{
+    struct pv_venus_handler_context *ctx = user_data;
+    VkFence host_fence = fence;
+
+    vkResetFences(ctx->vk->device, 1, &host_fence);
+}
+
+static void completion_destroy(void *user_data, void *fence)
+{
+    struct pv_venus_handler_context *ctx = user_data;
+
+    vkDestroyFence(ctx->vk->device, (VkFence)fence, NULL);
+}
+
+/*
+ * Submit coalescer backend: the real vkQueueSubmit
+ *
+ * Every submit gets a fence, so the completion thread can tell the guest
+ * when it is done. One that fails is recorded as such, in order, so the
+ * guest sees the context lost rather than a later submit covering it.
+ */
+static int submit_batches(void *user_data, VkQueue queue, uint32_t count,
+                          const VkSubmitInfo *submits, VkFence fence, uint64_t seqno)
+{
+    struct pv_venus_handler_context *ctx = user_data;
+    bool owned = false;
+
+    if (fence == VK_NULL_HANDLE) {
+        owned = true;
+        fence = pv_venus_completion_take_fence(&ctx->completions);
+        if (!fence) {
+            VkFenceCreateInfo fence_info = {
+                .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+            };
+            if (vkCreateFence(ctx->vk->device, &fence_info, NULL, &fence) != VK_SUCCESS) {
+                fprintf(stderr, "[Venus Handlers] vkCreateFence failed\n");
+                pv_venus_completion_push_failed(&ctx->completions, seqno);
+                return -1;
+            }
+        }
+    }
+
+    pthread_mutex_lock(&ctx->vk->queue_lock);
+    VkResult result = vkQueueSubmit(queue, count, submits, fence);
+    pthread_mutex_unlock(&ctx->vk->queue_lock);
+
+    if (result != VK_SUCCESS) {
+        fprintf(stderr, "[Venus Handlers] vkQueueSubmit failed: %d\n", result);
+        if (owned) {
+            vkDestroyFence(ctx->vk->device, fence, NULL);
+        }
+        pv_venus_completion_push_failed(&ctx->completions, seqno);
+        return -1;
+    }
+
+    if (pv_venus_completion_push(&ctx->completions, fence, owned, seqno) != 0) {
+        /* Out of memory: the work ran, but the context can't track it */
+        vkWaitForFences(ctx->vk->device, 1, &fence, VK_TRUE, UINT64_MAX);
+        if (owned) {
+            vkDestroyFence(ctx->vk->device, fence, NULL);
+        }
+        pv_venus_completion_push_failed(&ctx->completions, seqno);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Set up completion tracking and the submit coalescer that feeds it
+ */
+int pv_venus_handlers_submit_init(struct pv_venus_handler_context *ctx)
+{
+    struct pv_venus_completion_backend completion_backend = {
+        .wait = completion_wait,
+        .reset = completion_reset,
+        .destroy = completion_destroy,
+        .user_data = ctx,
+    };
+    struct pv_venus_submit_backend submit_backend = {
+        .submit = submit_batches,
+        .user_data = ctx,
+    };
+
+    if (pv_venus_completion_init(&ctx->completions, &completion_backend) != 0) {
+        return -1;
+    }
+    if (pv_venus_submit_init(&ctx->submits, &submit_backend, 0, 0) != 0) {
+        pv_venus_completion_destroy(&ctx->completions);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Check whether a teardown also destroys command pool @pool
+ *
+ * Releases come children-first, so a pool follows its buffers.
+ */
+static bool releases_pool(const struct pv_venus_object_release *releases,
+                          size_t count, void *pool)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (releases[i].type == PV_VENUS_OBJECT_TYPE_COMMAND_POOL &&
+            releases[i].host_handle == pool) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Check whether a teardown releases anything submitted work can reference
+ */
+static bool releases_gpu_objects(const struct pv_venus_object_release *releases,
+                                 size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        switch (releases[i].type) {
+        case PV_VENUS_OBJECT_TYPE_BUFFER:
+        case PV_VENUS_OBJECT_TYPE_IMAGE:
+        case PV_VENUS_OBJECT_TYPE_DEVICE_MEMORY:
+        case PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER:
+        case PV_VENUS_OBJECT_TYPE_COMMAND_POOL:
+        case PV_VENUS_OBJECT_TYPE_PIPELINE:
+        case PV_VENUS_OBJECT_TYPE_SEMAPHORE:
+        case PV_VENUS_OBJECT_TYPE_DEVICE:
+            return true;
+        default:
+            break;
+        }
+    }
+    return false;
+}
+
+/*
+ * Tear down a guest object and everything it owns
+ *
+ * Host objects are destroyed children-first, as Vulkan requires.
+ * Returns: Number of objects released (0 if @guest_id is unknown)
+ */
+static size_t destroy_tree(struct pv_venus_handler_context *ctx,
+                           pv_venus_object_id guest_id)
+{
+    struct pv_venus_object_release *releases;
+    size_t count = pv_venus_object_remove_tree(&ctx->objects, guest_id, &releases);
+    struct pv_moltenvk_context *vk = ctx->vk;
+
+    /*
+     * Held batches may use what is about to go, and so may submitted work
+     * the guest never waited for (always the case after a crash). Let it
+     * finish first: freed memory also goes straight to the recycler, whose
+     * scrub must not race late writes from that work.
+     */
+    pv_venus_submit_flush(&ctx->submits, PV_VENUS_SUBMIT_FLUSH_EXPLICIT);
+    if (releases_gpu_objects(releases, count)) {
+        pv_venus_completion_drain(&ctx->completions);
+    }
+
+    void *released_pool = NULL;  /* Last pool found further down the list */
+
+    for (size_t i = 0; i < count; i++) {
+        const struct pv_venus_object_release *release = &releases[i];
+
+        switch (release->type) {
+        case PV_VENUS_OBJECT_TYPE_BUFFER:
+            vkDestroyBuffer(vk->device, (VkBuffer)release->host_handle, NULL);
+            break;
+        case PV_VENUS_OBJECT_TYPE_IMAGE:
+            vkDestroyImage(vk->device, (VkImage)release->host_handle, NULL);
+            break;
+        case PV_VENUS_OBJECT_TYPE_DEVICE_MEMORY:
+            pv_venus_memory_free(&ctx->memory, release->host_handle);
+            break;
+        case PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER:
+            /* Destroying the pool frees its buffers; free only those whose pool stays */
+            if (release->parent_handle != released_pool &&
+                releases_pool(releases + i + 1, count - i - 1, release->parent_handle)) {
+                released_pool = release->parent_handle;
+            }
+            if (release->parent_handle != released_pool) {
+                VkCommandBuffer command_buffer = release->host_handle;
+                vkFreeCommandBuffers(vk->device, (VkCommandPool)release->parent_handle,
+                                     1, &command_buffer);
+            }
+            break;
+        case PV_VENUS_OBJECT_TYPE_COMMAND_POOL:
+            vkDestroyCommandPool(vk->device, (VkCommandPool)release->host_handle, NULL);
+            break;
+        case PV_VENUS_OBJECT_TYPE_SHADER_MODULE:
+            /* Other guests may still share it */
+            pv_venus_shader_cache_release(pv_venus_handlers_shader_cache(),
+                                          release->host_handle);
+            break;
+        case PV_VENUS_OBJECT_TYPE_PIPELINE: {
+            /* A compile still in flight has to land before it can be destroyed */
+            VkPipeline pipeline = pv_venus_pipeline_resolve(&ctx->pipelines,
+                                                            release->host_handle);
+            if (pipeline) {
+                vkDestroyPipeline(vk->device, pipeline, NULL);
+            }
+            pv_venus_pipeline_free(release->host_handle);
+            break;
+        }
+        case PV_VENUS_OBJECT_TYPE_FENCE:
+            /* Only a slot; the guest reuses it as it likes */
+            free(release->host_handle);
+            break;
+        case PV_VENUS_OBJECT_TYPE_DEVICE:
+            if (vk->device_created && release->host_handle == (void *)vk->device) {
+                /* Its memory was freed above; give the cached blocks back too */
+                pv_venus_memory_trim(&ctx->memory);
+                if (ctx->empty_layout) {
+                    vkDestroyPipelineLayout(vk->device, ctx->empty_layout, NULL);
+                    ctx->empty_layout = VK_NULL_HANDLE;
+                }
+                pv_moltenvk_destroy_device(vk);
+            }
+            break;
+        case PV_VENUS_OBJECT_TYPE_INSTANCE:
+            if (vk->instance_created && release->host_handle == (void *)vk->instance) {
+                vkDestroyInstance(vk->instance, NULL);
+                vk->instance = VK_NULL_HANDLE;
+                vk->instance_created = false;
+            }
+            break;
+        default:
+            /* Queues and physical devices go away with their parent */
+            break;
+        }
+    }
+
+    free(releases);
+    ctx->objects_destroyed += count;
+    return count;
+}
+
+/*
+ * Release every host object the guest left behind
+ */
+void pv_venus_handlers_release_objects(struct pv_venus_handler_context *ctx)
+{
+    if (!ctx || !ctx->vk) {
+        return;
+    }
+
+    /* Every tracked object hangs off an instance */
+    pv_venus_object_id instance;
+    uint64_t destroyed = ctx->objects_destroyed;
+    while (pv_venus_object_any(&ctx->objects, PV_VENUS_OBJECT_TYPE_INSTANCE, &instance)) {
+        if (destroy_tree(ctx, instance) == 0) {
+            break;  /* Out of memory for the release list */
+        }
+    }
+
+    if (ctx->objects_destroyed != destroyed) {
+        printf("[Venus Handlers] Released %llu objects left by the guest\n",
+               ctx->objects_destroyed - destroyed);
+    }
+}
+
 /*
  * Create handler context
  */
@@ -26,15 +648,35 @@ struct pv_venus_handler_context *pv_venus_handlers_create(void)
     }
 
     /* Initialize object table */
-    ctx->objects.capacity = 1024;  /* Start with 1024 objects */
-    ctx->objects.objects = calloc(ctx->objects.capacity, 
-                                   sizeof(struct pv_venus_object));
-    if (!ctx->objects.objects) {
+    if (pv_venus_object_table_init(&ctx->objects, 1024) != 0) {
+        pv_moltenvk_cleanup(ctx->vk);
+        free(ctx);
+        return NULL;
+    }
+
+    if (pv_venus_handlers_memory_init(ctx) != 0) {
+        pv_venus_object_table_destroy(&ctx->objects);
+        pv_moltenvk_cleanup(ctx->vk);
+        free(ctx);
+        return NULL;
+    }
+
+    if (pv_venus_pipeline_pool_init(&ctx->pipelines, 0) != 0) {
+        pv_venus_memory_allocator_destroy(&ctx->memory);
+        pv_venus_object_table_destroy(&ctx->objects);
+        pv_moltenvk_cleanup(ctx->vk);
+        free(ctx);
+        return NULL;
+    }
+
+    if (pv_venus_handlers_submit_init(ctx) != 0) {
+        pv_venus_pipeline_pool_destroy(&ctx->pipelines);
+        pv_venus_memory_allocator_destroy(&ctx->memory);
+        pv_venus_object_table_destroy(&ctx->objects);
         pv_moltenvk_cleanup(ctx->vk);
         free(ctx);
         return NULL;
     }
-    ctx->objects.count = 0;
 
     printf("[Venus Handlers] Context created\n");
     return ctx;
@@ -49,103 +691,304 @@ void pv_venus_handlers_destroy(struct pv_venus_handler_context *ctx)
         return;
     }
 
+    pv_venus_handlers_release_objects(ctx);
+
     printf("[Venus Handlers] Stats: handled=%llu created=%llu destroyed=%llu\n",
            ctx->commands_handled, ctx->objects_created, ctx->objects_destroyed);
 
+    /* Blocks go back while the device still exists */
+    pv_venus_submit_destroy(&ctx->submits);
+    pv_venus_completion_destroy(&ctx->completions);
+    pv_venus_pipeline_pool_destroy(&ctx->pipelines);
+    pv_venus_memory_allocator_destroy(&ctx->memory);
+    pv_venus_query_cache_destroy(&ctx->queries);
+
     /* Cleanup MoltenVK */
     if (ctx->vk) {
         pv_moltenvk_cleanup(ctx->vk);
     }
 
     /* Free object table */
-    if (ctx->objects.objects) {
-        free(ctx->objects.objects);
-    }
+    pv_venus_object_table_destroy(&ctx->objects);
 
     free(ctx);
 }
 
 /*
- * Object table: Add object
+ * Handler: vkCreateInstance
  */
-int pv_venus_object_add(
-    struct pv_venus_object_table *table,
-    pv_venus_object_id guest_id,
-    void *host_handle,
-    pv_venus_object_type type)
-{
-    if (!table || !host_handle) {
-        return -1;
-    }
-
-    /* Find free slot */
-    for (size_t i = 0; i < table->capacity; i++) {
-        if (!table->objects[i].in_use) {
-            table->objects[i].guest_id = guest_id;
-            table->objects[i].host_handle = host_handle;
-            table->objects[i].type = type;
-            table->objects[i].in_use = true;
-            table->count++;
-            
-            printf("[Venus Handlers] Added object: guest_id=0x%llx type=%d\n",
-                   guest_id, type);
-            return 0;
-        }
+int pv_venus_handle_vkCreateInstance(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    (void)header;
+    (void)data;
+    (void)data_size;
+    
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    printf("[Venus Handlers] vkCreateInstance called\n");
+
+    /* Create Vulkan instance via MoltenVK */
+    VkResult result = pv_moltenvk_create_instance(ctx->vk, "PearVisor Guest");
+    if (result != VK_SUCCESS) {
+        fprintf(stderr, "[Venus Handlers] Failed to create instance: %d\n", result);
+        return -1;
     }
 
-    fprintf(stderr, "[Venus Handlers] Object table full!\n");
-    return -1;
+    /* TODO: Parse guest_id from command data and add to object table */
+    /* For now, use fixed ID for testing */
+    pv_venus_object_id guest_instance_id = 0x1000;
+    
+    if (pv_venus_object_add(&ctx->objects, guest_instance_id,
+                            ctx->vk->instance, PV_VENUS_OBJECT_TYPE_INSTANCE) != 0) {
+        vkDestroyInstance(ctx->vk->instance, NULL);
+        ctx->vk->instance = VK_NULL_HANDLE;
+        ctx->vk->instance_created = false;
+        return -1;
+    }
+
+    ctx->commands_handled++;
+    ctx->objects_created++;
+
+    return 0;
 }
 
 /*
- * Object table: Get object
+ * Handler: vkDestroyInstance
  */
-void *pv_venus_object_get(
-    struct pv_venus_object_table *table,
-    pv_venus_object_id guest_id)
+int pv_venus_handle_vkDestroyInstance(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
 {
-    if (!table) {
-        return NULL;
+    (void)header;
+    (void)data;
+    (void)data_size;
+    
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    printf("[Venus Handlers] vkDestroyInstance called\n");
+
+    /* TODO: Parse guest_id from command data */
+    size_t released = destroy_tree(ctx, 0x1000);
+    printf("[Venus Handlers]   Released %zu objects\n", released);
+
+    ctx->commands_handled++;
+
+    return 0;
+}
+
+/*
+ * Handler: vkEnumeratePhysicalDevices
+ */
+int pv_venus_handle_vkEnumeratePhysicalDevices(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    (void)header;
+    (void)data;
+    (void)data_size;
+    
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    printf("[Venus Handlers] vkEnumeratePhysicalDevices called\n");
+
+    /* Select physical device via MoltenVK */
+    VkResult result = pv_moltenvk_select_physical_device(ctx->vk);
+    if (result != VK_SUCCESS) {
+        fprintf(stderr, "[Venus Handlers] Failed to select physical device: %d\n", 
+                result);
+        return -1;
     }
 
-    for (size_t i = 0; i < table->capacity; i++) {
-        if (table->objects[i].in_use && 
-            table->objects[i].guest_id == guest_id) {
-            return table->objects[i].host_handle;
-        }
+    /* Everything the guest will ask about this device, serialized up front */
+    struct pv_venus_query_device device = {
+        .properties = &ctx->vk->device_properties,
+        .features = &ctx->vk->device_features,
+        .memory_properties = &ctx->vk->memory_properties,
+        .queue_families = ctx->vk->queue_families,
+        .queue_family_count = ctx->vk->queue_families ? ctx->vk->queue_family_count : 0,
+    };
+    struct pv_venus_query_backend query_backend = {
+        .format_properties = query_format_properties,
+        .user_data = ctx->vk,
+    };
+    if (pv_venus_query_cache_build(&ctx->queries, &device, &query_backend) != 0) {
+        fprintf(stderr, "[Venus Handlers] Failed to cache physical device queries\n");
+        return -1;
+    }
+
+    /* TODO: Parse command data and return device list to guest */
+    /* For now, just add to object table */
+    pv_venus_object_id guest_device_id = 0x2000;
+    
+    /* Enumerating again is legal and finds the same device */
+    if (object_get_typed(ctx, guest_device_id, PV_VENUS_OBJECT_TYPE_PHYSICAL_DEVICE) ==
+        (void *)ctx->vk->physical_device) {
+        ctx->commands_handled++;
+        return 0;
     }
 
-    return NULL;
+    if (pv_venus_object_add_child(&ctx->objects, guest_device_id,
+                                  ctx->vk->physical_device,
+                                  PV_VENUS_OBJECT_TYPE_PHYSICAL_DEVICE, 0x1000) != 0) {
+        return -1;
+    }
+
+    ctx->commands_handled++;
+    ctx->objects_created++;
+
+    return 0;
 }
 
 /*
- * Object table: Remove object
+ * Handler: vkGetPhysicalDeviceProperties
  */
-void pv_venus_object_remove(
-    struct pv_venus_object_table *table,
-    pv_venus_object_id guest_id)
+int pv_venus_handle_vkGetPhysicalDeviceProperties(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
 {
-    if (!table) {
-        return;
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    pv_venus_trace("[Venus Handlers] vkGetPhysicalDeviceProperties called\n");
+
+    if (reply_query(ctx, header, data, data_size) != 0) {
+        return -1;
+    }
+
+    ctx->commands_handled++;
+    return 0;
+}
+
+/*
+ * Handler: vkGetPhysicalDeviceFeatures
+ */
+int pv_venus_handle_vkGetPhysicalDeviceFeatures(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    pv_venus_trace("[Venus Handlers] vkGetPhysicalDeviceFeatures called\n");
+
+    if (reply_query(ctx, header, data, data_size) != 0) {
+        return -1;
     }
 
-    for (size_t i = 0; i < table->capacity; i++) {
-        if (table->objects[i].in_use && 
-            table->objects[i].guest_id == guest_id) {
-            table->objects[i].in_use = false;
-            table->objects[i].host_handle = NULL;
-            table->count--;
-            
-            printf("[Venus Handlers] Removed object: guest_id=0x%llx\n", guest_id);
-            return;
+    ctx->commands_handled++;
+    return 0;
+}
+
+/*
+ * Handler: vkGetPhysicalDeviceMemoryProperties
+ */
+int pv_venus_handle_vkGetPhysicalDeviceMemoryProperties(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    pv_venus_trace("[Venus Handlers] vkGetPhysicalDeviceMemoryProperties called\n");
+
+    if (reply_query(ctx, header, data, data_size) != 0) {
+        return -1;
+    }
+
+    ctx->commands_handled++;
+    return 0;
+}
+
+/*
+ * Handler: vkGetPhysicalDeviceQueueFamilyProperties
+ */
+int pv_venus_handle_vkGetPhysicalDeviceQueueFamilyProperties(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    pv_venus_trace("[Venus Handlers] vkGetPhysicalDeviceQueueFamilyProperties called\n");
+
+    if (reply_query(ctx, header, data, data_size) != 0) {
+        return -1;
+    }
+
+    ctx->commands_handled++;
+    return 0;
+}
+
+/*
+ * Handler: vkGetPhysicalDeviceFormatProperties
+ */
+int pv_venus_handle_vkGetPhysicalDeviceFormatProperties(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    struct pv_venus_get_format_properties args;
+    if (data_size < sizeof(args)) {
+        fprintf(stderr, "[Venus Handlers] vkGetPhysicalDeviceFormatProperties: truncated command\n");
+        return -1;
+    }
+    memcpy(&args, data, sizeof(args));
+
+    pv_venus_trace("[Venus Handlers] vkGetPhysicalDeviceFormatProperties called (format %u)\n",
+                   args.format);
+
+    struct pv_venus_query_blob blob;
+    if (pv_venus_query_cache_lookup(&ctx->queries, header->command_id, data, data_size,
+                                    &blob) == 0) {
+        if (reply_with(ctx, header, blob.data, blob.size) != 0) {
+            return -1;
+        }
+    } else {
+        /* Extension formats aren't in the table; those still ask the driver */
+        if (!ctx->vk->physical_device) {
+            fprintf(stderr, "[Venus Handlers] vkGetPhysicalDeviceFormatProperties "
+                    "before vkEnumeratePhysicalDevices\n");
+            return -1;
+        }
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(ctx->vk->physical_device, (VkFormat)args.format,
+                                            &properties);
+        if (reply_with(ctx, header, &properties, sizeof(properties)) != 0) {
+            return -1;
         }
     }
+
+    ctx->commands_handled++;
+    return 0;
 }
 
 /*
- * Handler: vkCreateInstance
+ * Handler: vkCreateDevice
  */
-int pv_venus_handle_vkCreateInstance(
+int pv_venus_handle_vkCreateDevice(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
@@ -158,21 +1001,24 @@ int pv_venus_handle_vkCreateInstance(
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkCreateInstance called\n");
+    printf("[Venus Handlers] vkCreateDevice called\n");
 
-    /* Create Vulkan instance via MoltenVK */
-    VkResult result = pv_moltenvk_create_instance(ctx->vk, "PearVisor Guest");
+    /* Create logical device via MoltenVK */
+    VkResult result = pv_moltenvk_create_device(ctx->vk);
     if (result != VK_SUCCESS) {
-        fprintf(stderr, "[Venus Handlers] Failed to create instance: %d\n", result);
+        fprintf(stderr, "[Venus Handlers] Failed to create device: %d\n", result);
         return -1;
     }
 
-    /* TODO: Parse guest_id from command data and add to object table */
-    /* For now, use fixed ID for testing */
-    pv_venus_object_id guest_instance_id = 0x1000;
+    /* TODO: Parse guest_id from command data */
+    pv_venus_object_id guest_device_id = 0x3000;
     
-    pv_venus_object_add(&ctx->objects, guest_instance_id, 
-                         ctx->vk->instance, PV_VENUS_OBJECT_TYPE_INSTANCE);
+    /* Owned by the physical device, so vkDestroyInstance takes it down too */
+    if (pv_venus_object_add_child(&ctx->objects, guest_device_id,
+                                  ctx->vk->device, PV_VENUS_OBJECT_TYPE_DEVICE, 0x2000) != 0) {
+        pv_moltenvk_destroy_device(ctx->vk);
+        return -1;
+    }
 
     ctx->commands_handled++;
     ctx->objects_created++;
@@ -181,9 +1027,9 @@ int pv_venus_handle_vkCreateInstance(
 }
 
 /*
- * Handler: vkDestroyInstance
+ * Handler: vkDestroyDevice
  */
-int pv_venus_handle_vkDestroyInstance(
+int pv_venus_handle_vkDestroyDevice(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
@@ -196,49 +1042,69 @@ int pv_venus_handle_vkDestroyInstance(
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkDestroyInstance called\n");
+    printf("[Venus Handlers] vkDestroyDevice called\n");
+
+    /* TODO: Parse guest_id from command data */
+    size_t released = destroy_tree(ctx, 0x3000);
+    printf("[Venus Handlers]   Released %zu objects\n", released);
 
-    /* TODO: Parse guest_id and remove from object table */
-    /* For now, just mark in stats */
     ctx->commands_handled++;
-    ctx->objects_destroyed++;
 
     return 0;
 }
 
 /*
- * Handler: vkEnumeratePhysicalDevices
+ * Handler: vkGetDeviceQueue
  */
-int pv_venus_handle_vkEnumeratePhysicalDevices(
+int pv_venus_handle_vkGetDeviceQueue(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
     size_t data_size)
 {
     (void)header;
-    (void)data;
-    (void)data_size;
     
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkEnumeratePhysicalDevices called\n");
+    printf("[Venus Handlers] vkGetDeviceQueue called\n");
 
-    /* Select physical device via MoltenVK */
-    VkResult result = pv_moltenvk_select_physical_device(ctx->vk);
-    if (result != VK_SUCCESS) {
-        fprintf(stderr, "[Venus Handlers] Failed to select physical device: %d\n", 
-                result);
+    /* No payload: the graphics queue, under the fixed ID */
+    struct pv_venus_get_device_queue args = {
+        .queue_id = 0x4000,
+        .queue_family_index = ctx->vk->graphics_queue_family,
+        .queue_index = 0,
+    };
+    if (data_size > 0) {
+        if (data_size < sizeof(args)) {
+            fprintf(stderr, "[Venus Handlers] vkGetDeviceQueue: truncated command\n");
+            return -1;
+        }
+        memcpy(&args, data, sizeof(args));
+    }
+
+    VkQueue queue = pv_moltenvk_get_queue(ctx->vk, args.queue_family_index, args.queue_index);
+    if (queue == VK_NULL_HANDLE) {
+        fprintf(stderr, "[Venus Handlers] No queue %u.%u\n",
+                args.queue_family_index, args.queue_index);
         return -1;
     }
 
-    /* TODO: Parse command data and return device list to guest */
-    /* For now, just add to object table */
-    pv_venus_object_id guest_device_id = 0x2000;
-    
-    pv_venus_object_add(&ctx->objects, guest_device_id,
-                         ctx->vk->physical_device, 
-                         PV_VENUS_OBJECT_TYPE_PHYSICAL_DEVICE);
+    /* Asking twice for a queue is legal and gets the same handle */
+    if (object_get_typed(ctx, args.queue_id, PV_VENUS_OBJECT_TYPE_QUEUE) == queue) {
+        ctx->commands_handled++;
+        return 0;
+    }
+
+    if (pv_venus_object_add_child(&ctx->objects, args.queue_id, queue,
+                                  PV_VENUS_OBJECT_TYPE_QUEUE, 0x3000) != 0) {
+        return -1;
+    }
+
+    printf("[Venus Handlers]   Queue %u.%u -> %s queue\n",
+           args.queue_family_index, args.queue_index,
+           queue == ctx->vk->graphics_queue ? "graphics" :
+           queue == ctx->vk->compute_queue ? "compute" : "transfer");
 
     ctx->commands_handled++;
     ctx->objects_created++;
@@ -247,9 +1113,10 @@ int pv_venus_handle_vkEnumeratePhysicalDevices(
 }
 
 /*
- * Handler: vkGetPhysicalDeviceProperties
+ * Memory Management Handlers
  */
-int pv_venus_handle_vkGetPhysicalDeviceProperties(
+
+int pv_venus_handle_vkAllocateMemory(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
@@ -262,19 +1129,45 @@ int pv_venus_handle_vkGetPhysicalDeviceProperties(
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkGetPhysicalDeviceProperties called\n");
-    printf("[Venus Handlers]   Device: %s\n", ctx->vk->device_properties.deviceName);
+    printf("[Venus Handlers] vkAllocateMemory called\n");
 
-    /* TODO: Write properties back to guest shared memory */
+    /* TODO: Parse VkMemoryAllocateInfo from command data */
+    /* For now, allocate 1MB of device memory as test */
     
+    VkMemoryAllocateInfo alloc_info = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext = NULL,
+        .allocationSize = 1024 * 1024,  // 1MB
+        .memoryTypeIndex = 0,            // First memory type
+    };
+
+    /* Carve it out of a shared host block instead of a driver allocation */
+    struct pv_venus_memory_allocation *memory =
+        pv_venus_memory_alloc(&ctx->memory, alloc_info.memoryTypeIndex,
+                              alloc_info.allocationSize);
+    if (!memory) {
+        fprintf(stderr, "[Venus Handlers] vkAllocateMemory failed\n");
+        return -1;
+    }
+
+    /* Track with fixed guest ID for testing */
+    pv_venus_object_id guest_memory_id = 0x5000;
+    if (pv_venus_object_add_child(&ctx->objects, guest_memory_id, memory,
+                                  PV_VENUS_OBJECT_TYPE_DEVICE_MEMORY, 0x3000) != 0) {
+        pv_venus_memory_free(&ctx->memory, memory);
+        return -1;
+    }
+
+    printf("[Venus Handlers]   Allocated %zu bytes of device memory at offset %llu\n",
+           alloc_info.allocationSize, (unsigned long long)memory->offset);
+
     ctx->commands_handled++;
+    ctx->objects_created++;
+
     return 0;
 }
 
-/*
- * Handler: vkGetPhysicalDeviceFeatures
- */
-int pv_venus_handle_vkGetPhysicalDeviceFeatures(
+int pv_venus_handle_vkFreeMemory(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
@@ -287,18 +1180,21 @@ int pv_venus_handle_vkGetPhysicalDeviceFeatures(
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkGetPhysicalDeviceFeatures called\n");
+    printf("[Venus Handlers] vkFreeMemory called\n");
+
+    /* TODO: Parse guest memory ID from command data */
+    destroy_tree(ctx, 0x5000);
 
-    /* TODO: Write features back to guest */
-    
     ctx->commands_handled++;
+
     return 0;
 }
 
 /*
- * Handler: vkGetPhysicalDeviceMemoryProperties
+ * Buffer Management Handlers
  */
-int pv_venus_handle_vkGetPhysicalDeviceMemoryProperties(
+
+int pv_venus_handle_vkCreateBuffer(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
@@ -311,20 +1207,47 @@ int pv_venus_handle_vkGetPhysicalDeviceMemoryProperties(
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkGetPhysicalDeviceMemoryProperties called\n");
-    printf("[Venus Handlers]   Memory heaps: %u\n", 
-           ctx->vk->memory_properties.memoryHeapCount);
+    printf("[Venus Handlers] vkCreateBuffer called\n");
+
+    /* TODO: Parse VkBufferCreateInfo from command data */
+    /* For now, create 64KB vertex buffer as test */
+    
+    VkBufferCreateInfo buffer_info = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = NULL,
+        .flags = 0,
+        .size = 64 * 1024,  // 64KB
+        .usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 0,
+        .pQueueFamilyIndices = NULL,
+    };
 
-    /* TODO: Write memory properties back to guest */
+    VkBuffer buffer;
+    VkResult result = vkCreateBuffer(ctx->vk->device, &buffer_info, NULL, &buffer);
     
+    if (result != VK_SUCCESS) {
+        fprintf(stderr, "[Venus Handlers] vkCreateBuffer failed: %d\n", result);
+        return -1;
+    }
+
+    /* Track with fixed guest ID for testing */
+    pv_venus_object_id guest_buffer_id = 0x6000;
+    if (pv_venus_object_add_child(&ctx->objects, guest_buffer_id, buffer,
+                                  PV_VENUS_OBJECT_TYPE_BUFFER, 0x3000) != 0) {
+        vkDestroyBuffer(ctx->vk->device, buffer, NULL);
+        return -1;
+    }
+
+    printf("[Venus Handlers]   Created buffer: %zu bytes\n", buffer_info.size);
+
     ctx->commands_handled++;
+    ctx->objects_created++;
+
     return 0;
 }
 
-/*
- * Handler: vkCreateDevice
- */
-int pv_venus_handle_vkCreateDevice(
+int pv_venus_handle_vkDestroyBuffer(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
@@ -337,31 +1260,18 @@ int pv_venus_handle_vkCreateDevice(
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkCreateDevice called\n");
-
-    /* Create logical device via MoltenVK */
-    VkResult result = pv_moltenvk_create_device(ctx->vk);
-    if (result != VK_SUCCESS) {
-        fprintf(stderr, "[Venus Handlers] Failed to create device: %d\n", result);
-        return -1;
-    }
+    printf("[Venus Handlers] vkDestroyBuffer called\n");
 
-    /* TODO: Parse guest_id from command data */
-    pv_venus_object_id guest_device_id = 0x3000;
-    
-    pv_venus_object_add(&ctx->objects, guest_device_id,
-                         ctx->vk->device, PV_VENUS_OBJECT_TYPE_DEVICE);
+    /* TODO: Parse guest buffer ID and destroy actual buffer */
+    /* For now, just track statistics */
 
     ctx->commands_handled++;
-    ctx->objects_created++;
+    ctx->objects_destroyed++;
 
     return 0;
 }
 
-/*
- * Handler: vkDestroyDevice
- */
-int pv_venus_handle_vkDestroyDevice(
+int pv_venus_handle_vkBindBufferMemory(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
@@ -374,40 +1284,93 @@ int pv_venus_handle_vkDestroyDevice(
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkDestroyDevice called\n");
+    printf("[Venus Handlers] vkBindBufferMemory called\n");
 
-    /* TODO: Parse guest_id and remove from object table */
+    /* TODO: Parse buffer ID, memory ID, and offset from command data */
+    /* For now, use fixed IDs from previous allocations */
+    
+    VkBuffer buffer = object_get_typed(ctx, 0x6000, PV_VENUS_OBJECT_TYPE_BUFFER);
+    const struct pv_venus_memory_allocation *memory =
+        object_get_typed(ctx, 0x5000, PV_VENUS_OBJECT_TYPE_DEVICE_MEMORY);
+    VkDeviceSize offset = 0;
+
+    if (!buffer || !memory) {
+        fprintf(stderr, "[Venus Handlers] Buffer or memory not found\n");
+        return -1;
+    }
+
+    /* Guest (memory, offset) -> host (block, block offset + offset) */
+    VkResult result = vkBindBufferMemory(ctx->vk->device, buffer,
+                                         (VkDeviceMemory)memory->block->memory,
+                                         memory->offset + offset);
     
+    if (result != VK_SUCCESS) {
+        fprintf(stderr, "[Venus Handlers] vkBindBufferMemory failed: %d\n", result);
+        return -1;
+    }
+
+    printf("[Venus Handlers]   Bound buffer to memory\n");
+
     ctx->commands_handled++;
-    ctx->objects_destroyed++;
 
     return 0;
 }
 
 /*
- * Handler: vkGetDeviceQueue
+ * Shader Module Handlers
  */
-int pv_venus_handle_vkGetDeviceQueue(
+
+int pv_venus_handle_vkCreateShaderModule(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
     size_t data_size)
 {
     (void)header;
-    (void)data;
-    (void)data_size;
     
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkGetDeviceQueue called\n");
+    printf("[Venus Handlers] vkCreateShaderModule called\n");
 
-    /* TODO: Parse queue family index and queue index from command */
-    /* For now, just add graphics queue */
-    pv_venus_object_id guest_queue_id = 0x4000;
-    
-    pv_venus_object_add(&ctx->objects, guest_queue_id,
-                         ctx->vk->graphics_queue, PV_VENUS_OBJECT_TYPE_QUEUE);
+    struct pv_venus_create_shader_module args;
+    if (data_size < sizeof(args)) {
+        fprintf(stderr, "[Venus Handlers] vkCreateShaderModule: truncated command\n");
+        return -1;
+    }
+    memcpy(&args, data, sizeof(args));
+
+    const uint8_t *code = (const uint8_t *)data + sizeof(args);
+    uint32_t magic = 0;
+    if (args.code_size < sizeof(magic) || args.code_size % sizeof(uint32_t) != 0 ||
+        args.code_size > data_size - sizeof(args)) {
+        fprintf(stderr, "[Venus Handlers] vkCreateShaderModule: bad code size %llu\n",
+                (unsigned long long)args.code_size);
+        return -1;
+    }
+    memcpy(&magic, code, sizeof(magic));
+    if (magic != SPIRV_MAGIC) {
+        fprintf(stderr, "[Venus Handlers] vkCreateShaderModule: not SPIR-V\n");
+        return -1;
+    }
+
+    if (!ctx->vk->device_created) {
+        fprintf(stderr, "[Venus Handlers] No device\n");
+        return -1;
+    }
+
+    struct pv_venus_shader_cache *cache = pv_venus_handlers_shader_cache();
+    struct pv_venus_shader *shader =
+        pv_venus_shader_cache_acquire(cache, ctx->vk->device, code, args.code_size);
+    if (!shader) {
+        return -1;
+    }
+
+    if (pv_venus_object_add_child(&ctx->objects, args.shader_module_id, shader,
+                                  PV_VENUS_OBJECT_TYPE_SHADER_MODULE, 0x3000) != 0) {
+        pv_venus_shader_cache_release(cache, shader);
+        return -1;
+    }
 
     ctx->commands_handled++;
     ctx->objects_created++;
@@ -415,193 +1378,269 @@ int pv_venus_handle_vkGetDeviceQueue(
     return 0;
 }
 
-/*
- * Memory Management Handlers
- */
-
-int pv_venus_handle_vkAllocateMemory(
+int pv_venus_handle_vkDestroyShaderModule(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
     size_t data_size)
 {
     (void)header;
-    (void)data;
-    (void)data_size;
     
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkAllocateMemory called\n");
+    printf("[Venus Handlers] vkDestroyShaderModule called\n");
 
-    /* TODO: Parse VkMemoryAllocateInfo from command data */
-    /* For now, allocate 1MB of device memory as test */
-    
-    VkMemoryAllocateInfo alloc_info = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+    struct pv_venus_destroy_shader_module args;
+    if (data_size < sizeof(args)) {
+        fprintf(stderr, "[Venus Handlers] vkDestroyShaderModule: truncated command\n");
+        return -1;
+    }
+    memcpy(&args, data, sizeof(args));
+
+    if (!object_get_typed(ctx, args.shader_module_id, PV_VENUS_OBJECT_TYPE_SHADER_MODULE) ||
+        destroy_tree(ctx, args.shader_module_id) == 0) {
+        fprintf(stderr, "[Venus Handlers] Shader module 0x%llx not found\n",
+                (unsigned long long)args.shader_module_id);
+        return -1;
+    }
+
+    ctx->commands_handled++;
+
+    return 0;
+}
+
+/*
+ * Pipeline Handlers
+ */
+
+/* A compute pipeline compile, run by the pipeline pool */
+struct compute_pipeline_job {
+    struct pv_moltenvk_context *vk;
+    VkPipelineLayout layout;
+    struct pv_venus_shader *shader;   /* Referenced until the compile ends */
+};
+
+static int compile_compute_pipeline(void *job_data, void **pipeline)
+{
+    struct compute_pipeline_job *job = job_data;
+    struct pv_moltenvk_context *vk = job->vk;
+
+    VkComputePipelineCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
         .pNext = NULL,
-        .allocationSize = 1024 * 1024,  // 1MB
-        .memoryTypeIndex = 0,            // First memory type
+        .flags = 0,
+        .stage = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+            .module = (VkShaderModule)job->shader->module,
+            .pName = "main",
+        },
+        .layout = job->layout,
+        .basePipelineHandle = VK_NULL_HANDLE,
+        .basePipelineIndex = -1,
     };
 
-    VkDeviceMemory memory;
-    VkResult result = vkAllocateMemory(ctx->vk->device, &alloc_info, NULL, &memory);
-    
+    VkPipeline compute_pipeline;
+    VkResult result = vkCreateComputePipelines(vk->device, vk->pipeline_cache, 1,
+                                               &create_info, NULL, &compute_pipeline);
+
+    pv_venus_shader_cache_release(pv_venus_handlers_shader_cache(), job->shader);
+    free(job);
+
     if (result != VK_SUCCESS) {
-        fprintf(stderr, "[Venus Handlers] vkAllocateMemory failed: %d\n", result);
+        fprintf(stderr, "[Venus Handlers] vkCreateComputePipelines failed: %d\n", result);
         return -1;
     }
 
-    /* Track with fixed guest ID for testing */
-    pv_venus_object_id guest_memory_id = 0x5000;
-    pv_venus_object_add(&ctx->objects, guest_memory_id, memory,
-                         PV_VENUS_OBJECT_TYPE_DEVICE_MEMORY);
-
-    printf("[Venus Handlers]   Allocated %zu bytes of device memory\n", 
-           alloc_info.allocationSize);
-
-    ctx->commands_handled++;
-    ctx->objects_created++;
+    /* New cache entries reach disk every flush interval, not per pipeline */
+    pv_moltenvk_pipeline_cache_flush(vk, false);
 
+    *pipeline = (void *)compute_pipeline;
     return 0;
 }
 
-int pv_venus_handle_vkFreeMemory(
+int pv_venus_handle_vkCreateComputePipelines(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
     size_t data_size)
 {
     (void)header;
-    (void)data;
-    (void)data_size;
     
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkFreeMemory called\n");
+    printf("[Venus Handlers] vkCreateComputePipelines called\n");
 
-    /* TODO: Parse guest memory ID and free actual memory */
-    /* For now, just track statistics */
+    struct pv_venus_create_compute_pipeline args;
+    if (data_size < sizeof(args)) {
+        fprintf(stderr, "[Venus Handlers] vkCreateComputePipelines: truncated command\n");
+        return -1;
+    }
+    memcpy(&args, data, sizeof(args));
 
-    ctx->commands_handled++;
-    ctx->objects_destroyed++;
+    struct pv_venus_shader *shader = object_get_typed(ctx, args.shader_module_id,
+                                                      PV_VENUS_OBJECT_TYPE_SHADER_MODULE);
+    if (!shader || !ctx->vk->device_created) {
+        fprintf(stderr, "[Venus Handlers] Shader module or device not found\n");
+        return -1;
+    }
 
-    return 0;
-}
+    /*
+     * The protocol has no descriptor set or pipeline layouts yet, so every
+     * pipeline shares one empty layout: shaders may not use descriptors
+     * or push constants. The payload grows a layout ID with that support.
+     */
+    if (!ctx->empty_layout) {
+        VkPipelineLayoutCreateInfo layout_info = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        };
+        VkResult result = vkCreatePipelineLayout(ctx->vk->device, &layout_info, NULL,
+                                                 &ctx->empty_layout);
+        if (result != VK_SUCCESS) {
+            fprintf(stderr, "[Venus Handlers] vkCreatePipelineLayout failed: %d\n", result);
+            return -1;
+        }
+    }
 
-/*
- * Buffer Management Handlers
- */
+    struct compute_pipeline_job *job = malloc(sizeof(*job));
+    if (!job) {
+        return -1;
+    }
+    job->vk = ctx->vk;
+    job->layout = ctx->empty_layout;
+    job->shader = shader;
+
+    /* The guest may destroy the module before the compile runs */
+    struct pv_venus_shader_cache *cache = pv_venus_handlers_shader_cache();
+    pv_venus_shader_cache_retain(cache, shader);
+
+    struct pv_venus_pipeline *pipeline =
+        pv_venus_pipeline_compile_async(&ctx->pipelines, compile_compute_pipeline, job);
+    if (!pipeline) {
+        pv_venus_shader_cache_release(cache, shader);
+        free(job);
+        return -1;
+    }
+
+    /* The guest gets its handle now; the compile finishes in the background */
+    if (pv_venus_object_add_child(&ctx->objects, args.pipeline_id, pipeline,
+                                  PV_VENUS_OBJECT_TYPE_PIPELINE, 0x3000) != 0) {
+        VkPipeline compiled = pv_venus_pipeline_resolve(&ctx->pipelines, pipeline);
+        if (compiled) {
+            vkDestroyPipeline(ctx->vk->device, compiled, NULL);
+        }
+        pv_venus_pipeline_free(pipeline);
+        return -1;
+    }
+
+    ctx->commands_handled++;
+    ctx->objects_created++;
 
-int pv_venus_handle_vkCreateBuffer(
+    return 0;
+}
+
+int pv_venus_handle_vkCreateGraphicsPipelines(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
     size_t data_size)
 {
-    (void)header;
     (void)data;
     (void)data_size;
     
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkCreateBuffer called\n");
-
-    /* TODO: Parse VkBufferCreateInfo from command data */
-    /* For now, create 64KB vertex buffer as test */
-    
-    VkBufferCreateInfo buffer_info = {
-        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .pNext = NULL,
-        .flags = 0,
-        .size = 64 * 1024,  // 64KB
-        .usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-        .queueFamilyIndexCount = 0,
-        .pQueueFamilyIndices = NULL,
-    };
-
-    VkBuffer buffer;
-    VkResult result = vkCreateBuffer(ctx->vk->device, &buffer_info, NULL, &buffer);
-    
-    if (result != VK_SUCCESS) {
-        fprintf(stderr, "[Venus Handlers] vkCreateBuffer failed: %d\n", result);
-        return -1;
-    }
-
-    /* Track with fixed guest ID for testing */
-    pv_venus_object_id guest_buffer_id = 0x6000;
-    pv_venus_object_add(&ctx->objects, guest_buffer_id, buffer,
-                         PV_VENUS_OBJECT_TYPE_BUFFER);
-
-    printf("[Venus Handlers]   Created buffer: %zu bytes\n", buffer_info.size);
-
-    ctx->commands_handled++;
-    ctx->objects_created++;
-
-    return 0;
+    /*
+     * A graphics pipeline needs its render pass, vertex input and
+     * fixed-function state, none of which the protocol carries yet.
+     * Refuse it outright rather than leave the guest's handle dangling.
+     */
+    fprintf(stderr, "[Venus Handlers] vkCreateGraphicsPipelines: not supported yet\n");
+    reply_result(ctx, header, VK_ERROR_FEATURE_NOT_PRESENT);
+    return -1;
 }
 
-int pv_venus_handle_vkDestroyBuffer(
+int pv_venus_handle_vkDestroyPipeline(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
     size_t data_size)
 {
     (void)header;
-    (void)data;
-    (void)data_size;
     
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkDestroyBuffer called\n");
+    printf("[Venus Handlers] vkDestroyPipeline called\n");
 
-    /* TODO: Parse guest buffer ID and destroy actual buffer */
-    /* For now, just track statistics */
+    struct pv_venus_destroy_pipeline args;
+    if (data_size < sizeof(args)) {
+        fprintf(stderr, "[Venus Handlers] vkDestroyPipeline: truncated command\n");
+        return -1;
+    }
+    memcpy(&args, data, sizeof(args));
+
+    if (!object_get_typed(ctx, args.pipeline_id, PV_VENUS_OBJECT_TYPE_PIPELINE)) {
+        fprintf(stderr, "[Venus Handlers] Pipeline 0x%llx not found\n",
+                (unsigned long long)args.pipeline_id);
+        return -1;
+    }
+    if (destroy_tree(ctx, args.pipeline_id) == 0) {
+        fprintf(stderr, "[Venus Handlers] Pipeline 0x%llx not found\n",
+                (unsigned long long)args.pipeline_id);
+        return -1;
+    }
 
     ctx->commands_handled++;
-    ctx->objects_destroyed++;
 
     return 0;
 }
 
-int pv_venus_handle_vkBindBufferMemory(
+int pv_venus_handle_vkCmdBindPipeline(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
     size_t data_size)
 {
     (void)header;
-    (void)data;
-    (void)data_size;
     
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkBindBufferMemory called\n");
-
-    /* TODO: Parse buffer ID, memory ID, and offset from command data */
-    /* For now, use fixed IDs from previous allocations */
-    
-    VkBuffer buffer = pv_venus_object_get(&ctx->objects, 0x6000);
-    VkDeviceMemory memory = pv_venus_object_get(&ctx->objects, 0x5000);
-
-    if (!buffer || !memory) {
-        fprintf(stderr, "[Venus Handlers] Buffer or memory not found\n");
+    struct pv_venus_cmd_bind_pipeline args;
+    if (data_size < sizeof(args)) {
+        fprintf(stderr, "[Venus Handlers] vkCmdBindPipeline: truncated command\n");
+        return -1;
+    }
+    memcpy(&args, data, sizeof(args));
+
+    VkCommandBuffer cmd_buffer = object_get_typed(ctx, args.command_buffer_id,
+                                                  PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER);
+    struct pv_venus_pipeline *placeholder = object_get_typed(ctx, args.pipeline_id,
+                                                             PV_VENUS_OBJECT_TYPE_PIPELINE);
+    if (!cmd_buffer || !placeholder) {
+        fprintf(stderr, "[Venus Handlers] Command buffer or pipeline not found\n");
+        return -1;
+    }
+    if (args.bind_point != VK_PIPELINE_BIND_POINT_GRAPHICS &&
+        args.bind_point != VK_PIPELINE_BIND_POINT_COMPUTE) {
+        fprintf(stderr, "[Venus Handlers] vkCmdBindPipeline: bad bind point %u\n",
+                args.bind_point);
         return -1;
     }
 
-    VkResult result = vkBindBufferMemory(ctx->vk->device, buffer, memory, 0);
-    
-    if (result != VK_SUCCESS) {
-        fprintf(stderr, "[Venus Handlers] vkBindBufferMemory failed: %d\n", result);
+    /* First use: from here on the real pipeline is needed */
+    VkPipeline pipeline = pv_venus_pipeline_resolve(&ctx->pipelines, placeholder);
+    if (!pipeline) {
+        fprintf(stderr, "[Venus Handlers] Pipeline 0x%llx failed to compile\n",
+                (unsigned long long)args.pipeline_id);
         return -1;
     }
 
-    printf("[Venus Handlers]   Bound buffer to memory\n");
+    vkCmdBindPipeline(cmd_buffer, (VkPipelineBindPoint)args.bind_point, pipeline);
 
     ctx->commands_handled++;
 
@@ -662,8 +1701,11 @@ int pv_venus_handle_vkCreateImage(
 
     /* Track with fixed guest ID for testing */
     pv_venus_object_id guest_image_id = 0x7000;
-    pv_venus_object_add(&ctx->objects, guest_image_id, image,
-                         PV_VENUS_OBJECT_TYPE_IMAGE);
+    if (pv_venus_object_add_child(&ctx->objects, guest_image_id, image,
+                                  PV_VENUS_OBJECT_TYPE_IMAGE, 0x3000) != 0) {
+        vkDestroyImage(ctx->vk->device, image, NULL);
+        return -1;
+    }
 
     printf("[Venus Handlers]   Created image: %ux%u\n", 
            image_info.extent.width, image_info.extent.height);
@@ -763,8 +1805,11 @@ int pv_venus_handle_vkCreateCommandPool(
 
     /* Track with fixed guest ID for testing */
     pv_venus_object_id guest_pool_id = 0x8000;
-    pv_venus_object_add(&ctx->objects, guest_pool_id, command_pool,
-                         PV_VENUS_OBJECT_TYPE_COMMAND_POOL);
+    if (pv_venus_object_add_child(&ctx->objects, guest_pool_id, command_pool,
+                                  PV_VENUS_OBJECT_TYPE_COMMAND_POOL, 0x3000) != 0) {
+        vkDestroyCommandPool(ctx->vk->device, command_pool, NULL);
+        return -1;
+    }
 
     printf("[Venus Handlers]   Created command pool for queue family %u\n", 
            ctx->vk->graphics_queue_family);
@@ -790,10 +1835,10 @@ int pv_venus_handle_vkDestroyCommandPool(
 
     printf("[Venus Handlers] vkDestroyCommandPool called\n");
 
-    /* TODO: Parse guest pool ID and destroy actual pool */
+    /* TODO: Parse guest pool ID from command data */
+    destroy_tree(ctx, 0x8000);
 
     ctx->commands_handled++;
-    ctx->objects_destroyed++;
 
     return 0;
 }
@@ -820,7 +1865,7 @@ int pv_venus_handle_vkAllocateCommandBuffers(
     /* TODO: Parse VkCommandBufferAllocateInfo from command data */
     /* For now, allocate single primary command buffer */
     
-    VkCommandPool pool = pv_venus_object_get(&ctx->objects, 0x8000);
+    VkCommandPool pool = object_get_typed(ctx, 0x8000, PV_VENUS_OBJECT_TYPE_COMMAND_POOL);
     if (!pool) {
         fprintf(stderr, "[Venus Handlers] Command pool not found\n");
         return -1;
@@ -844,8 +1889,11 @@ int pv_venus_handle_vkAllocateCommandBuffers(
 
     /* Track with fixed guest ID for testing */
     pv_venus_object_id guest_cmdbuf_id = 0x9000;
-    pv_venus_object_add(&ctx->objects, guest_cmdbuf_id, command_buffer,
-                         PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER);
+    if (pv_venus_object_add_child(&ctx->objects, guest_cmdbuf_id, command_buffer,
+                                  PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER, 0x8000) != 0) {
+        vkFreeCommandBuffers(ctx->vk->device, pool, 1, &command_buffer);
+        return -1;
+    }
 
     printf("[Venus Handlers]   Allocated command buffer\n");
 
@@ -895,7 +1943,8 @@ int pv_venus_handle_vkBeginCommandBuffer(
 
     /* TODO: Parse guest command buffer ID and begin info */
     
-    VkCommandBuffer cmd_buffer = pv_venus_object_get(&ctx->objects, 0x9000);
+    VkCommandBuffer cmd_buffer = object_get_typed(ctx, 0x9000,
+                                                  PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER);
     if (!cmd_buffer) {
         fprintf(stderr, "[Venus Handlers] Command buffer not found\n");
         return -1;
@@ -939,7 +1988,8 @@ int pv_venus_handle_vkEndCommandBuffer(
 
     /* TODO: Parse guest command buffer ID */
     
-    VkCommandBuffer cmd_buffer = pv_venus_object_get(&ctx->objects, 0x9000);
+    VkCommandBuffer cmd_buffer = object_get_typed(ctx, 0x9000,
+                                                  PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER);
     if (!cmd_buffer) {
         fprintf(stderr, "[Venus Handlers] Command buffer not found\n");
         return -1;
@@ -960,52 +2010,373 @@ int pv_venus_handle_vkEndCommandBuffer(
 }
 
 /*
- * Queue Operation Handlers
+ * Fence Handlers
+ *
+ * A guest fence is just the number of the guest submit that signals it,
+ * mirrored into its slot of the completion page. No host VkFence: the
+ * completion thread's per-submit fences already say when that submit is
+ * done.
  */
 
-int pv_venus_handle_vkQueueSubmit(
+struct guest_fence {
+    uint32_t slot;
+    uint64_t seqno;                   /* PV_VENUS_FENCE_UNSIGNALED until submitted */
+};
+
+static struct guest_fence *guest_fence_get(struct pv_venus_handler_context *ctx,
+                                           uint64_t fence_id)
+{
+    pv_venus_object_handle handle = pv_venus_object_lookup(&ctx->objects, fence_id);
+    if (pv_venus_object_handle_type(handle) != PV_VENUS_OBJECT_TYPE_FENCE) {
+        fprintf(stderr, "[Venus Handlers] Fence 0x%llx not found\n",
+                (unsigned long long)fence_id);
+        return NULL;
+    }
+    return pv_venus_object_resolve(&ctx->objects, handle);
+}
+
+static void guest_fence_set(struct pv_venus_handler_context *ctx,
+                            struct guest_fence *fence, uint64_t seqno)
+{
+    fence->seqno = seqno;
+    pv_venus_completion_set_fence(&ctx->completions, fence->slot, seqno);
+}
+
+/* Parse a fence list payload; *ids points at the unaligned ID array */
+static int parse_fence_list(const void *data, size_t data_size,
+                            struct pv_venus_fence_list *list, const uint8_t **ids)
+{
+    if (data_size < sizeof(*list)) {
+        return -1;
+    }
+    memcpy(list, data, sizeof(*list));
+    if ((uint64_t)list->fence_count * sizeof(uint64_t) > data_size - sizeof(*list)) {
+        return -1;
+    }
+    *ids = (const uint8_t *)data + sizeof(*list);
+    return 0;
+}
+
+int pv_venus_handle_vkCreateFence(
     void *context,
     const struct pv_venus_command_header *header,
     const void *data,
     size_t data_size)
 {
     (void)header;
-    (void)data;
-    (void)data_size;
     
     struct pv_venus_dispatch_context *dispatch_ctx = context;
     struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
 
-    printf("[Venus Handlers] vkQueueSubmit called\n");
+    printf("[Venus Handlers] vkCreateFence called\n");
+
+    struct pv_venus_create_fence args;
+    if (data_size < sizeof(args)) {
+        fprintf(stderr, "[Venus Handlers] vkCreateFence: truncated command\n");
+        return -1;
+    }
+    memcpy(&args, data, sizeof(args));
+
+    struct guest_fence *fence = malloc(sizeof(*fence));
+    if (!fence) {
+        return -1;
+    }
+    fence->slot = args.slot;
+
+    if (pv_venus_object_add_child(&ctx->objects, args.fence_id, fence,
+                                  PV_VENUS_OBJECT_TYPE_FENCE, 0x3000) != 0) {
+        free(fence);
+        return -1;
+    }
+
+    /* Created signalled: submit 0 has always completed */
+    guest_fence_set(ctx, fence, (args.flags & VK_FENCE_CREATE_SIGNALED_BIT)
+                                    ? 0 : PV_VENUS_FENCE_UNSIGNALED);
+
+    ctx->commands_handled++;
+    ctx->objects_created++;
+
+    return 0;
+}
 
-    /* TODO: Parse submit info (command buffers, semaphores, fence) */
+int pv_venus_handle_vkDestroyFence(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    (void)header;
     
-    VkCommandBuffer cmd_buffer = pv_venus_object_get(&ctx->objects, 0x9000);
-    if (!cmd_buffer) {
-        fprintf(stderr, "[Venus Handlers] Command buffer not found\n");
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    printf("[Venus Handlers] vkDestroyFence called\n");
+
+    struct pv_venus_fence_command args;
+    if (data_size < sizeof(args)) {
+        fprintf(stderr, "[Venus Handlers] vkDestroyFence: truncated command\n");
+        return -1;
+    }
+    memcpy(&args, data, sizeof(args));
+
+    if (!guest_fence_get(ctx, args.fence_id)) {
+        return -1;
+    }
+    destroy_tree(ctx, args.fence_id);
+
+    ctx->commands_handled++;
+
+    return 0;
+}
+
+int pv_venus_handle_vkResetFences(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    (void)header;
+    
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    printf("[Venus Handlers] vkResetFences called\n");
+
+    struct pv_venus_fence_list list;
+    const uint8_t *ids;
+    if (parse_fence_list(data, data_size, &list, &ids) != 0) {
+        fprintf(stderr, "[Venus Handlers] vkResetFences: truncated command\n");
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < list.fence_count; i++) {
+        uint64_t fence_id;
+        memcpy(&fence_id, ids + i * sizeof(fence_id), sizeof(fence_id));
+        struct guest_fence *fence = guest_fence_get(ctx, fence_id);
+        if (!fence) {
+            return -1;
+        }
+        guest_fence_set(ctx, fence, PV_VENUS_FENCE_UNSIGNALED);
+    }
+
+    ctx->commands_handled++;
+
+    return 0;
+}
+
+int pv_venus_handle_vkGetFenceStatus(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    /* Guests with a completion page read the slot instead */
+    struct pv_venus_fence_command args;
+    if (data_size < sizeof(args)) {
+        fprintf(stderr, "[Venus Handlers] vkGetFenceStatus: truncated command\n");
+        return -1;
+    }
+    memcpy(&args, data, sizeof(args));
+
+    struct guest_fence *fence = guest_fence_get(ctx, args.fence_id);
+    if (!fence) {
+        return -1;
+    }
+
+    bool signalled = fence->seqno <= pv_venus_completion_completed(&ctx->completions);
+    VkResult result = signalled ? VK_SUCCESS : VK_NOT_READY;
+    if (pv_venus_completion_failed(&ctx->completions)) {
+        result = VK_ERROR_DEVICE_LOST;
+    }
+    if (reply_result(ctx, header, result) != 0) {
+        return -1;
+    }
+
+    ctx->commands_handled++;
+
+    return 0;
+}
+
+int pv_venus_handle_vkWaitForFences(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    printf("[Venus Handlers] vkWaitForFences called\n");
+
+    struct pv_venus_fence_list list;
+    const uint8_t *ids;
+    if (parse_fence_list(data, data_size, &list, &ids) != 0 || list.fence_count == 0) {
+        fprintf(stderr, "[Venus Handlers] vkWaitForFences: bad fence list\n");
+        return -1;
+    }
+
+    /* All: the latest signalling submit; any: the earliest */
+    uint64_t target = list.wait_all ? 0 : PV_VENUS_FENCE_UNSIGNALED;
+    for (uint32_t i = 0; i < list.fence_count; i++) {
+        uint64_t fence_id;
+        memcpy(&fence_id, ids + i * sizeof(fence_id), sizeof(fence_id));
+        struct guest_fence *fence = guest_fence_get(ctx, fence_id);
+        if (!fence) {
+            return -1;
+        }
+        if (list.wait_all ? fence->seqno > target : fence->seqno < target) {
+            target = fence->seqno;
+        }
+    }
+
+    /*
+     * A fence no submit will signal can only time out: nothing else is
+     * decoded while this thread waits, so don't wait. Otherwise wait a
+     * bounded slice; the guest finishes longer waits on its page.
+     */
+    VkResult result = VK_TIMEOUT;
+    if (target != PV_VENUS_FENCE_UNSIGNALED) {
+        if (pv_venus_submit_flush(&ctx->submits, PV_VENUS_SUBMIT_FLUSH_EXPLICIT) != 0) {
+            return -1;
+        }
+        uint64_t timeout_ns = list.timeout_ns < PV_VENUS_FENCE_WAIT_MAX_NS ?
+                              list.timeout_ns : PV_VENUS_FENCE_WAIT_MAX_NS;
+        int waited = pv_venus_completion_wait_timeout(&ctx->completions, target, timeout_ns);
+        if (waited == 0) {
+            result = VK_SUCCESS;
+        } else if (waited < 0) {
+            result = VK_ERROR_DEVICE_LOST;
+        }
+    }
+
+    if (reply_result(ctx, header, result) != 0) {
         return -1;
     }
 
+    ctx->commands_handled++;
+
+    return 0;
+}
+
+/*
+ * Queue Operation Handlers
+ */
+
+int pv_venus_handle_vkQueueSubmit(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    (void)header;
+    
+    struct pv_venus_dispatch_context *dispatch_ctx = context;
+    struct pv_venus_handler_context *ctx = dispatch_ctx->user_context;
+
+    printf("[Venus Handlers] vkQueueSubmit called\n");
+
+    VkQueue queue = ctx->vk->graphics_queue;
+    struct guest_fence *fence = NULL;
     VkSubmitInfo submit_info = {
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .pNext = NULL,
-        .waitSemaphoreCount = 0,
-        .pWaitSemaphores = NULL,
-        .pWaitDstStageMask = NULL,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &cmd_buffer,
-        .signalSemaphoreCount = 0,
-        .pSignalSemaphores = NULL,
     };
+    VkCommandBuffer *command_buffers = NULL;
+    VkCommandBuffer *heap_array = NULL;  /* Only when the arena is full */
+    VkCommandBuffer cmd_buffer;
+
+    if (data_size == 0) {
+        /* No batch described: the fixed command buffer */
+        cmd_buffer = object_get_typed(ctx, 0x9000, PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER);
+        if (!cmd_buffer) {
+            fprintf(stderr, "[Venus Handlers] Command buffer not found\n");
+            return -1;
+        }
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &cmd_buffer;
+    } else {
+        if (data_size < sizeof(struct pv_venus_queue_submit)) {
+            fprintf(stderr, "[Venus Handlers] vkQueueSubmit payload too small\n");
+            return -1;
+        }
 
-    VkResult result = vkQueueSubmit(ctx->vk->graphics_queue, 1, &submit_info, VK_NULL_HANDLE);
-    
-    if (result != VK_SUCCESS) {
-        fprintf(stderr, "[Venus Handlers] vkQueueSubmit failed: %d\n", result);
+        struct pv_venus_queue_submit params;
+        memcpy(&params, data, sizeof(params));
+        const uint8_t *ids = (const uint8_t *)data + sizeof(params);
+        uint64_t count = params.command_buffer_count;
+
+        if (sizeof(params) + count * sizeof(uint64_t) +
+                (uint64_t)params.wait_semaphore_count * sizeof(struct pv_venus_submit_wait) +
+                (uint64_t)params.signal_semaphore_count * sizeof(uint64_t) > data_size) {
+            fprintf(stderr, "[Venus Handlers] vkQueueSubmit payload truncated\n");
+            return -1;
+        }
+
+        /* Semaphores aren't tracked yet, so no ID could name a real one */
+        if (params.wait_semaphore_count || params.signal_semaphore_count) {
+            fprintf(stderr, "[Venus Handlers] vkQueueSubmit: semaphores not supported\n");
+            return -1;
+        }
+
+        if (params.queue_id) {
+            queue = object_get_typed(ctx, params.queue_id, PV_VENUS_OBJECT_TYPE_QUEUE);
+        }
+        if (params.fence_id) {
+            fence = guest_fence_get(ctx, params.fence_id);
+            if (!fence) {
+                return -1;
+            }
+        }
+        if (!queue) {
+            fprintf(stderr, "[Venus Handlers] vkQueueSubmit queue not found\n");
+            return -1;
+        }
+
+        /* Ring scratch for the array; the coalescer copies it before we return */
+        command_buffers = pv_venus_ring_arena_alloc(pv_venus_dispatch_arena(),
+                                                    count * sizeof(*command_buffers) + 1,
+                                                    _Alignof(VkCommandBuffer));
+        if (!command_buffers) {
+            command_buffers = malloc(count * sizeof(*command_buffers) + 1);
+            heap_array = command_buffers;
+        }
+        if (!command_buffers) {
+            return -1;
+        }
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t guest_id;
+            memcpy(&guest_id, ids, sizeof(guest_id));
+            ids += sizeof(guest_id);
+
+            command_buffers[i] = object_get_typed(ctx, guest_id,
+                                                  PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER);
+            if (!command_buffers[i]) {
+                fprintf(stderr, "[Venus Handlers] vkQueueSubmit command buffer 0x%llx not found\n",
+                        (unsigned long long)guest_id);
+                free(heap_array);
+                return -1;
+            }
+        }
+
+        submit_info.commandBufferCount = params.command_buffer_count;
+        submit_info.pCommandBuffers = command_buffers;
+    }
+
+    /* Held until a fence wait, a queue idle, or a budget runs out */
+    uint64_t seqno;
+    int result = pv_venus_submit_enqueue(&ctx->submits, queue, &submit_info, VK_NULL_HANDLE,
+                                         sizeof(*header) + data_size, &seqno);
+    free(heap_array);
+    if (result != 0) {
         return -1;
     }
 
-    printf("[Venus Handlers]   Submitted command buffer to GPU queue\n");
+    /* The fence signals when this submit completes */
+    if (fence) {
+        guest_fence_set(ctx, fence, seqno);
+    }
 
     ctx->commands_handled++;
 
@@ -1027,14 +2398,20 @@ int pv_venus_handle_vkQueueWaitIdle(
 
     printf("[Venus Handlers] vkQueueWaitIdle called\n");
 
-    VkResult result = vkQueueWaitIdle(ctx->vk->graphics_queue);
-    
-    if (result != VK_SUCCESS) {
-        fprintf(stderr, "[Venus Handlers] vkQueueWaitIdle failed: %d\n", result);
+    if (pv_venus_submit_flush(&ctx->submits, PV_VENUS_SUBMIT_FLUSH_EXPLICIT) != 0) {
         return -1;
     }
 
-    printf("[Venus Handlers]   Queue idle (all GPU work completed)\n");
+    /*
+     * The guest waits for its submit count on the completion page; only
+     * guests without one make the ring thread block.
+     */
+    if (!pv_venus_completion_has_page(&ctx->completions)) {
+        struct pv_venus_submit_stats stats;
+        pv_venus_submit_get_stats(&ctx->submits, &stats);
+        pv_venus_completion_wait(&ctx->completions, stats.guest_submits);
+        printf("[Venus Handlers]   Queue idle (all GPU work completed)\n");
+    }
 
     ctx->commands_handled++;
 
@@ -1066,6 +2443,10 @@ void pv_venus_handlers_register(
                                 pv_venus_handle_vkGetPhysicalDeviceFeatures);
     pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkGetPhysicalDeviceMemoryProperties,
                                 pv_venus_handle_vkGetPhysicalDeviceMemoryProperties);
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkGetPhysicalDeviceFormatProperties,
+                                pv_venus_handle_vkGetPhysicalDeviceFormatProperties);
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkGetPhysicalDeviceQueueFamilyProperties,
+                                pv_venus_handle_vkGetPhysicalDeviceQueueFamilyProperties);
 
     /* Register device handlers */
     pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkCreateDevice,
@@ -1094,6 +2475,22 @@ void pv_venus_handlers_register(
                                 pv_venus_handle_vkCreateImage);
     pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkDestroyImage,
                                 pv_venus_handle_vkDestroyImage);
+
+    /* Register shader module handlers */
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkCreateShaderModule,
+                                pv_venus_handle_vkCreateShaderModule);
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkDestroyShaderModule,
+                                pv_venus_handle_vkDestroyShaderModule);
+
+    /* Register pipeline handlers */
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkCreateGraphicsPipelines,
+                                pv_venus_handle_vkCreateGraphicsPipelines);
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkCreateComputePipelines,
+                                pv_venus_handle_vkCreateComputePipelines);
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkDestroyPipeline,
+                                pv_venus_handle_vkDestroyPipeline);
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkCmdBindPipeline,
+                                pv_venus_handle_vkCmdBindPipeline);
     pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkBindImageMemory,
                                 pv_venus_handle_vkBindImageMemory);
 
@@ -1113,11 +2510,27 @@ void pv_venus_handlers_register(
     pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkEndCommandBuffer,
                                 pv_venus_handle_vkEndCommandBuffer);
 
+    /* Register fence handlers */
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkCreateFence,
+                                pv_venus_handle_vkCreateFence);
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkDestroyFence,
+                                pv_venus_handle_vkDestroyFence);
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkResetFences,
+                                pv_venus_handle_vkResetFences);
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkGetFenceStatus,
+                                pv_venus_handle_vkGetFenceStatus);
+    pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkWaitForFences,
+                                pv_venus_handle_vkWaitForFences);
+
     /* Register queue operation handlers */
     pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkQueueSubmit,
                                 pv_venus_handle_vkQueueSubmit);
     pv_venus_dispatch_register(dispatch_ctx, PV_VK_COMMAND_vkQueueWaitIdle,
                                 pv_venus_handle_vkQueueWaitIdle);
 
-    printf("[Venus Handlers] Registered 25 command handlers\n");
+    uint32_t registered = 0;
+    for (uint32_t i = 0; i < PV_VENUS_MAX_COMMAND_ID; i++) {
+        registered += dispatch_ctx->handlers[i] != NULL;
+    }
+    printf("[Venus Handlers] Registered %u command handlers\n", registered);
 }
@@ -9,39 +9,32 @@
 #include "pv_venus_ring.h"
 #include "pv_venus_decoder.h"
 #include "pv_venus_handlers.h"
+#include "pv_venus_reply.h"
 #include "pv_moltenvk.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 /* Create ring buffer from existing memory */
-struct pv_venus_ring* pv_venus_ring_create_from_memory(void *memory, uint32_t size) {
+struct pv_venus_ring* pv_venus_ring_create_from_memory(void *memory, uint32_t size,
+                                                       uint32_t layout_version,
+                                                       uint32_t cache_line_size) {
     if (!memory) {
         fprintf(stderr, "[Venus Integration] NULL memory pointer\n");
         return NULL;
     }
     
-    if (size == 0 || (size & (size - 1)) != 0) {
-        fprintf(stderr, "[Venus Integration] Size must be power of 2, got %u\n", size);
-        return NULL;
-    }
-    
     printf("[Venus Integration] Creating ring buffer from memory: %p, size: %u bytes\n", 
            memory, size);
     
-    /* Create ring buffer layout */
-    /* Layout: [head(4)][tail(4)][status(4)][padding(4)][buffer(rest)] */
-    struct pv_venus_ring_layout layout = {
-        .shared_memory = memory,
-        .shared_memory_size = size,
-        .head_offset = 0,
-        .tail_offset = 4,
-        .status_offset = 8,
-        .buffer_offset = 16,  /* 16-byte aligned */
-        .buffer_size = size - 16,
-        .extra_offset = 0,
-        .extra_size = 0
-    };
+    /* Layout: [head][tail][status] as the guest placed them, then the
+     * largest power-of-2 buffer that fits in what's left */
+    struct pv_venus_ring_layout layout;
+    if (pv_venus_ring_layout_init(&layout, memory, size,
+                                  layout_version, cache_line_size) != 0) {
+        fprintf(stderr, "[Venus Integration] Region too small for ring layout\n");
+        return NULL;
+    }
     
     /* Create ring using existing API with NULL dispatch context (will set later) */
     struct pv_venus_ring *ring = pv_venus_ring_create(&layout, NULL);
@@ -66,14 +59,14 @@ int pv_venus_integration_start(struct pv_venus_ring *ring, void *context) {
         return -1;
     }
     
-    printf("[Venus Integration] Starting ring buffer processing (polling mode)\n");
+    printf("[Venus Integration] Starting ring buffer processing\n");
     
-    /* Set the dispatch context */
+    /* Ring thread decodes straight into the dispatch context */
     ring->dispatch_context = context;
-    ring->running = true;
-    
-    /* For integration, we use polling instead of background thread */
-    /* Commands will be processed when pv_venus_ring_notify() is called */
+    if (pv_venus_ring_start(ring) != 0) {
+        ring->dispatch_context = NULL;
+        return -1;
+    }
     
     printf("[Venus Integration] Ring buffer ready to process commands\n");
     return 0;
@@ -87,7 +80,9 @@ void pv_venus_integration_stop(struct pv_venus_ring *ring) {
     
     printf("[Venus Integration] Stopping ring buffer processing\n");
     
-    ring->running = false;
+    if (ring->running) {
+        pv_venus_ring_stop(ring);
+    }
     ring->dispatch_context = NULL;
     
     printf("[Venus Integration] Ring buffer processing stopped\n");
@@ -103,7 +98,7 @@ double pv_venus_ring_utilization(struct pv_venus_ring *ring) {
     
     uint32_t head = ring->buffer.current_pos;
     uint32_t tail = pv_venus_ring_get_tail(ring);
-    uint32_t used = (tail - head) & ring->buffer.mask;
+    uint32_t used = pv_venus_ring_seq_distance(head, tail);
     
     return (double)used / (double)ring->buffer.size;
 }
@@ -144,8 +139,39 @@ void* pv_venus_init(void) {
     ctx->vk = vk;
     dispatch_ctx->user_context = ctx;
     
-    /* Object table will be initialized by handlers */
-    /* No separate init function needed - handlers initialize on first use */
+    if (pv_venus_object_table_init(&ctx->objects, 1024) != 0) {
+        free(ctx);
+        pv_venus_dispatch_destroy(dispatch_ctx);
+        pv_moltenvk_cleanup(vk);
+        return NULL;
+    }
+    
+    if (pv_venus_handlers_memory_init(ctx) != 0) {
+        pv_venus_object_table_destroy(&ctx->objects);
+        free(ctx);
+        pv_venus_dispatch_destroy(dispatch_ctx);
+        pv_moltenvk_cleanup(vk);
+        return NULL;
+    }
+    
+    if (pv_venus_pipeline_pool_init(&ctx->pipelines, 0) != 0) {
+        pv_venus_memory_allocator_destroy(&ctx->memory);
+        pv_venus_object_table_destroy(&ctx->objects);
+        free(ctx);
+        pv_venus_dispatch_destroy(dispatch_ctx);
+        pv_moltenvk_cleanup(vk);
+        return NULL;
+    }
+    
+    if (pv_venus_handlers_submit_init(ctx) != 0) {
+        pv_venus_pipeline_pool_destroy(&ctx->pipelines);
+        pv_venus_memory_allocator_destroy(&ctx->memory);
+        pv_venus_object_table_destroy(&ctx->objects);
+        free(ctx);
+        pv_venus_dispatch_destroy(dispatch_ctx);
+        pv_moltenvk_cleanup(vk);
+        return NULL;
+    }
     
     printf("[Venus Integration] Handler context initialized\n");
     
@@ -173,6 +199,15 @@ void pv_venus_cleanup(void *context) {
         struct pv_venus_handler_context *handler_ctx = 
             (struct pv_venus_handler_context *)dispatch_ctx->user_context;
         
+        pv_venus_reply_ring_destroy(handler_ctx->reply);
+        pv_venus_handlers_release_objects(handler_ctx);
+        pv_venus_submit_destroy(&handler_ctx->submits);
+        pv_venus_completion_destroy(&handler_ctx->completions);
+        pv_venus_pipeline_pool_destroy(&handler_ctx->pipelines);
+        pv_venus_memory_allocator_destroy(&handler_ctx->memory);
+        pv_venus_query_cache_destroy(&handler_ctx->queries);
+        pv_venus_object_table_destroy(&handler_ctx->objects);
+        
         /* Cleanup MoltenVK */
         if (handler_ctx->vk) {
             pv_moltenvk_cleanup(handler_ctx->vk);
@@ -187,6 +222,72 @@ void pv_venus_cleanup(void *context) {
     printf("[Venus Integration] Venus context cleaned up\n");
 }
 
+/* Attach reply ring in guest shared memory */
+int pv_venus_attach_reply_memory(void *context, void *memory, uint32_t size,
+                                 uint32_t layout_version, uint32_t cache_line_size) {
+    if (!context || !memory) {
+        fprintf(stderr, "[Venus Integration] NULL context or memory\n");
+        return -1;
+    }
+    
+    struct pv_venus_dispatch_context *dispatch_ctx = 
+        (struct pv_venus_dispatch_context *)context;
+    struct pv_venus_handler_context *handler_ctx = dispatch_ctx->user_context;
+    if (!handler_ctx) {
+        return -1;
+    }
+    
+    /* Any size: the data region is the largest power of 2 after the control words */
+    struct pv_venus_ring_layout layout;
+    if (pv_venus_ring_layout_init(&layout, memory, size,
+                                  layout_version, cache_line_size) != 0) {
+        fprintf(stderr, "[Venus Integration] Region too small for reply ring\n");
+        return -1;
+    }
+    
+    struct pv_venus_reply_ring *reply = pv_venus_reply_ring_create(&layout);
+    if (!reply) {
+        return -1;
+    }
+    
+    pv_venus_reply_ring_destroy(handler_ctx->reply);
+    handler_ctx->reply = reply;
+    
+    printf("[Venus Integration] Reply ring attached: %u bytes at offset %zu\n",
+           (unsigned int)layout.buffer_size, layout.buffer_offset);
+    return 0;
+}
+
+/* Attach the shared completion page to a Venus context */
+int pv_venus_attach_completion_memory(void *context, void *memory, uint32_t size) {
+    if (!context || !memory) {
+        fprintf(stderr, "[Venus Integration] NULL context or memory\n");
+        return -1;
+    }
+    
+    struct pv_venus_dispatch_context *dispatch_ctx = 
+        (struct pv_venus_dispatch_context *)context;
+    struct pv_venus_handler_context *handler_ctx = dispatch_ctx->user_context;
+    if (!handler_ctx) {
+        return -1;
+    }
+    
+    if (size < sizeof(struct pv_venus_completion_page) ||
+        ((uintptr_t)memory % _Alignof(struct pv_venus_completion_page)) != 0) {
+        fprintf(stderr, "[Venus Integration] Completion page too small or misaligned\n");
+        return -1;
+    }
+    
+    struct pv_venus_completion_page *page = memory;
+    if (pv_venus_completion_attach_page(&handler_ctx->completions, page, size) != 0) {
+        return -1;
+    }
+    
+    printf("[Venus Integration] Completion page attached: %u fence slots\n",
+           page->fence_slot_count);
+    return 0;
+}
+
 /* Get Venus statistics */
 struct pv_venus_stats pv_venus_get_stats(void *context) {
     struct pv_venus_stats stats = {0};
@@ -209,3 +310,95 @@ struct pv_venus_stats pv_venus_get_stats(void *context) {
     
     return stats;
 }
+
+/* Snapshot per-command latency */
+uint32_t pv_venus_get_latency_stats(void *context, pv_venus_latency_stats *stats,
+                                    uint32_t max_stats) {
+    if (!context || !stats) {
+        return 0;
+    }
+    
+    struct pv_venus_dispatch_context *dispatch_ctx = 
+        (struct pv_venus_dispatch_context *)context;
+    
+    struct pv_venus_command_latency *latency = malloc(sizeof(*latency));
+    if (!latency) {
+        return 0;
+    }
+    
+    uint32_t count = 0;
+    for (uint32_t id = 0; id < PV_VENUS_MAX_COMMAND_ID && count < max_stats; id++) {
+        if (pv_venus_dispatch_latency(dispatch_ctx, id, latency) == 0) {
+            continue;
+        }
+        
+        struct pv_venus_latency_summary dispatch = 
+            pv_venus_latency_summarize(&latency->dispatch);
+        struct pv_venus_latency_summary queue = 
+            pv_venus_latency_summarize(&latency->queue);
+        
+        stats[count++] = (pv_venus_latency_stats){
+            .command_id = id,
+            .count = dispatch.count,
+            .dispatch_p50_ns = dispatch.p50_ns,
+            .dispatch_p99_ns = dispatch.p99_ns,
+            .dispatch_max_ns = dispatch.max_ns,
+            .queue_p50_ns = queue.p50_ns,
+            .queue_p99_ns = queue.p99_ns,
+            .queue_max_ns = queue.max_ns,
+        };
+    }
+    
+    free(latency);
+    return count;
+}
+
+/* Get shader module cache statistics */
+struct pv_venus_shader_stats pv_venus_get_shader_stats(void) {
+    struct pv_venus_shader_stats stats = {0};
+    struct pv_venus_shader_cache_stats cache_stats;
+    
+    struct pv_venus_shader_cache *cache = pv_venus_handlers_shader_cache();
+    if (!cache) {
+        return stats;
+    }
+    pv_venus_shader_cache_get_stats(cache, &cache_stats);
+    
+    stats.lookups = cache_stats.lookups;
+    stats.hits = cache_stats.hits;
+    stats.bytes_saved = cache_stats.bytes_saved;
+    stats.modules = cache_stats.modules;
+    stats.hit_rate = cache_stats.lookups
+                         ? (double)cache_stats.hits / (double)cache_stats.lookups : 0.0;
+    return stats;
+}
+
+/* Get queue submit coalescing statistics */
+struct pv_venus_queue_stats pv_venus_get_queue_stats(void *context) {
+    struct pv_venus_queue_stats stats = {0};
+    struct pv_venus_submit_stats submit_stats;
+    
+    if (!context) {
+        return stats;
+    }
+    
+    struct pv_venus_dispatch_context *dispatch_ctx = 
+        (struct pv_venus_dispatch_context *)context;
+    struct pv_venus_handler_context *handler_ctx = dispatch_ctx->user_context;
+    if (!handler_ctx) {
+        return stats;
+    }
+    pv_venus_submit_get_stats(&handler_ctx->submits, &submit_stats);
+    
+    stats.guest_submits = submit_stats.guest_submits;
+    stats.host_submits = submit_stats.host_submits;
+    stats.timer_flushes = submit_stats.flushes[PV_VENUS_SUBMIT_FLUSH_TIMER];
+    stats.budget_flushes = submit_stats.flushes[PV_VENUS_SUBMIT_FLUSH_BUDGET];
+    stats.merge_ratio = pv_venus_submit_merge_ratio(&submit_stats);
+    
+    struct pv_venus_completion_stats completion_stats;
+    pv_venus_completion_get_stats(&handler_ctx->completions, &completion_stats);
+    stats.completed_submits = pv_venus_completion_completed(&handler_ctx->completions);
+    stats.host_waits = completion_stats.host_waits;
+    return stats;
+}
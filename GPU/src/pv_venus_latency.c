@@ -0,0 +1,99 @@
+/*
+ * PearVisor - Venus Latency Histograms Implementation
+ */
+
+#include "pv_venus_latency.h"
+
+/*
+ * Upper bound (inclusive) of the values counted in a bucket
+ */
+uint64_t pv_venus_latency_bucket_limit(uint32_t bucket)
+{
+    const uint32_t sub_count = 1u << PV_VENUS_LATENCY_SUB_BITS;
+
+    if (bucket < sub_count) {
+        return bucket;
+    }
+    if (bucket >= PV_VENUS_LATENCY_BUCKETS - 1) {
+        return UINT64_MAX;
+    }
+
+    /* Inverse of pv_venus_latency_bucket */
+    uint32_t shift = (bucket >> PV_VENUS_LATENCY_SUB_BITS) - 1;
+    uint64_t sub = bucket & (sub_count - 1);
+    return ((sub_count + sub + 1) << shift) - 1;
+}
+
+/*
+ * Add the samples of one histogram to another
+ */
+void pv_venus_latency_merge(
+    struct pv_venus_latency_histogram *dst,
+    const struct pv_venus_latency_histogram *src)
+{
+    if (!dst || !src) {
+        return;
+    }
+
+    /* @src's writer may be mid-record: read each counter atomically */
+    for (uint32_t i = 0; i < PV_VENUS_LATENCY_BUCKETS; i++) {
+        dst->buckets[i] += __atomic_load_n(&src->buckets[i], __ATOMIC_RELAXED);
+    }
+    dst->count += __atomic_load_n(&src->count, __ATOMIC_RELAXED);
+    dst->sum_ns += __atomic_load_n(&src->sum_ns, __ATOMIC_RELAXED);
+    uint64_t max_ns = __atomic_load_n(&src->max_ns, __ATOMIC_RELAXED);
+    if (max_ns > dst->max_ns) {
+        dst->max_ns = max_ns;
+    }
+}
+
+/*
+ * Estimate a percentile from bucket counts
+ */
+uint64_t pv_venus_latency_percentile(
+    const struct pv_venus_latency_histogram *hist,
+    double percentile)
+{
+    if (!hist || hist->count == 0) {
+        return 0;
+    }
+
+    /* Rank of the sample we are looking for (1-based) */
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)hist->count + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < PV_VENUS_LATENCY_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            uint64_t limit = pv_venus_latency_bucket_limit(i);
+            return limit < hist->max_ns ? limit : hist->max_ns;
+        }
+    }
+
+    return hist->max_ns;
+}
+
+/*
+ * Summarize a histogram
+ */
+struct pv_venus_latency_summary pv_venus_latency_summarize(
+    const struct pv_venus_latency_histogram *hist)
+{
+    struct pv_venus_latency_summary summary = {0};
+
+    if (!hist || hist->count == 0) {
+        return summary;
+    }
+
+    summary.count = hist->count;
+    summary.mean_ns = hist->sum_ns / hist->count;
+    summary.p50_ns = pv_venus_latency_percentile(hist, 50.0);
+    summary.p99_ns = pv_venus_latency_percentile(hist, 99.0);
+    summary.p999_ns = pv_venus_latency_percentile(hist, 99.9);
+    summary.max_ns = hist->max_ns;
+
+    return summary;
+}
@@ -0,0 +1,764 @@
+/*
+ * PearVisor - Venus Device Memory Suballocator Implementation
+ *
+ * Large allocations use TLSF (two-level segregated fit): free ranges are
+ * binned by the position of their top bit (first level) and the next
+ * SL_LOG2 bits (second level), with a bitmap per level, so finding a
+ * fitting range is two find-first-set operations regardless of how many
+ * ranges are free. Freed ranges merge with free neighbours immediately.
+ *
+ * Blocks that empty out are scrubbed off the hot path: the allocate and
+ * free calls only move them between lists, and the recycler thread does
+ * the zeroing.
+ */
+
+#include "pv_venus_memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SL_LOG2  PV_VENUS_MEMORY_TLSF_SL_LOG2
+#define SL_COUNT PV_VENUS_MEMORY_TLSF_SL_COUNT
+
+#define SLAB_FULL_MASK ((uint32_t)(((uint64_t)1 << PV_VENUS_MEMORY_SLAB_SLOTS) - 1))
+
+static inline uint32_t top_bit(uint64_t value)
+{
+    return 63u - (uint32_t)__builtin_clzll(value);
+}
+
+static inline uint64_t align_up(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/*
+ * TLSF bin of a range of @size bytes
+ */
+static void tlsf_mapping(uint64_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size < SL_COUNT) {
+        *fl = 0;
+        *sl = (uint32_t)size;
+        return;
+    }
+
+    uint32_t bit = top_bit(size);
+    *fl = bit;
+    *sl = (uint32_t)(size >> (bit - SL_LOG2)) ^ SL_COUNT;
+}
+
+/*
+ * First bin whose ranges are all at least @size bytes
+ */
+static void tlsf_mapping_search(uint64_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size >= SL_COUNT) {
+        size += (1ull << (top_bit(size) - SL_LOG2)) - 1;
+    }
+    tlsf_mapping(size, fl, sl);
+}
+
+static void tlsf_insert(struct pv_venus_memory_heap *heap, struct pv_venus_memory_range *range)
+{
+    uint32_t fl, sl;
+    tlsf_mapping(range->size, &fl, &sl);
+
+    range->free = true;
+    range->prev_free = NULL;
+    range->next_free = heap->free_lists[fl][sl];
+    if (range->next_free) {
+        range->next_free->prev_free = range;
+    }
+    heap->free_lists[fl][sl] = range;
+
+    heap->fl_bitmap |= 1ull << fl;
+    heap->sl_bitmap[fl] |= 1u << sl;
+}
+
+static void tlsf_remove(struct pv_venus_memory_heap *heap, struct pv_venus_memory_range *range)
+{
+    uint32_t fl, sl;
+    tlsf_mapping(range->size, &fl, &sl);
+
+    if (range->prev_free) {
+        range->prev_free->next_free = range->next_free;
+    } else {
+        heap->free_lists[fl][sl] = range->next_free;
+    }
+    if (range->next_free) {
+        range->next_free->prev_free = range->prev_free;
+    }
+
+    if (!heap->free_lists[fl][sl]) {
+        heap->sl_bitmap[fl] &= ~(1u << sl);
+        if (!heap->sl_bitmap[fl]) {
+            heap->fl_bitmap &= ~(1ull << fl);
+        }
+    }
+    range->free = false;
+}
+
+/*
+ * Find a free range of at least @size bytes
+ */
+static struct pv_venus_memory_range *tlsf_find(struct pv_venus_memory_heap *heap, uint64_t size)
+{
+    uint32_t fl, sl;
+    tlsf_mapping_search(size, &fl, &sl);
+    if (fl >= PV_VENUS_MEMORY_TLSF_FL_COUNT) {
+        return NULL;
+    }
+
+    uint32_t sl_map = heap->sl_bitmap[fl] & (~0u << sl);
+    if (!sl_map) {
+        uint64_t fl_map = fl + 1 < 64 ? heap->fl_bitmap & (~0ull << (fl + 1)) : 0;
+        if (!fl_map) {
+            return NULL;
+        }
+        fl = (uint32_t)__builtin_ctzll(fl_map);
+        sl_map = heap->sl_bitmap[fl];
+    }
+
+    return heap->free_lists[fl][__builtin_ctz(sl_map)];
+}
+
+static void block_list_push(struct pv_venus_memory_block **list,
+                            struct pv_venus_memory_block *block)
+{
+    block->prev = NULL;
+    block->next = *list;
+    if (*list) {
+        (*list)->prev = block;
+    }
+    *list = block;
+}
+
+static void block_list_remove(struct pv_venus_memory_block **list,
+                              struct pv_venus_memory_block *block)
+{
+    if (block->prev) {
+        block->prev->next = block->next;
+    } else {
+        *list = block->next;
+    }
+    if (block->next) {
+        block->next->prev = block->prev;
+    }
+    block->prev = NULL;
+    block->next = NULL;
+}
+
+/*
+ * Hand a block back to the backend (already off every list)
+ */
+static void block_release(struct pv_venus_memory_allocator *allocator,
+                          struct pv_venus_memory_block *block)
+{
+    allocator->backend.free(allocator->backend.user_data, block->memory_type, block->memory);
+    allocator->stats.host_frees++;
+    free(block);
+}
+
+/*
+ * Get a block for a heap: a scrubbed one of the same size if the pool has
+ * one, else a new host allocation
+ */
+static struct pv_venus_memory_block *block_create(struct pv_venus_memory_allocator *allocator,
+                                                  uint32_t memory_type,
+                                                  uint64_t size,
+                                                  bool dedicated)
+{
+    struct pv_venus_memory_heap *heap = &allocator->heaps[memory_type];
+
+    struct pv_venus_memory_block *block = heap->clean;
+    while (block && block->size != size) {
+        block = block->next;
+    }
+
+    if (block) {
+        block_list_remove(&heap->clean, block);
+        allocator->stats.recycled++;
+        allocator->stats.pool_blocks--;
+        allocator->stats.pool_bytes -= size;
+    } else {
+        block = calloc(1, sizeof(*block));
+        if (!block) {
+            return NULL;
+        }
+
+        if (allocator->backend.allocate(allocator->backend.user_data, memory_type,
+                                        size, &block->memory) != 0) {
+            fprintf(stderr, "[Venus Memory] Host allocation of %llu bytes (type %u) failed\n",
+                    (unsigned long long)size, memory_type);
+            free(block);
+            return NULL;
+        }
+        block->size = size;
+        block->memory_type = memory_type;
+        allocator->stats.host_allocations++;
+    }
+
+    block->dedicated = dedicated;
+    block_list_push(&heap->blocks, block);
+
+    allocator->stats.blocks++;
+    allocator->stats.block_bytes += size;
+    return block;
+}
+
+/*
+ * Take an empty block out of its heap
+ *
+ * It goes to the recycler when there is one and the pool has room (or
+ * @force), else straight back to the backend.
+ */
+static void block_retire(struct pv_venus_memory_allocator *allocator,
+                         struct pv_venus_memory_block *block,
+                         bool force)
+{
+    block_list_remove(&allocator->heaps[block->memory_type].blocks, block);
+    allocator->stats.blocks--;
+    allocator->stats.block_bytes -= block->size;
+
+    block->used = 0;
+    block->ranges = NULL;
+
+    if (!allocator->recycler_running ||
+        (!force && allocator->stats.pool_bytes + block->size > PV_VENUS_MEMORY_POOL_BYTES)) {
+        block_release(allocator, block);
+        return;
+    }
+
+    block_list_push(&allocator->dirty, block);
+    allocator->stats.pool_blocks++;
+    allocator->stats.pool_bytes += block->size;
+    pthread_cond_signal(&allocator->recycle_wake);
+}
+
+/*
+ * Recycler thread: zero dirty blocks and move them to their clean list
+ *
+ * Drains the queue before honouring a stop request.
+ */
+static void *recycler_main(void *arg)
+{
+    struct pv_venus_memory_allocator *allocator = arg;
+
+    pthread_mutex_lock(&allocator->lock);
+    for (;;) {
+        while (!allocator->dirty && !allocator->recycler_stop) {
+            pthread_cond_wait(&allocator->recycle_wake, &allocator->lock);
+        }
+
+        struct pv_venus_memory_block *block = allocator->dirty;
+        if (!block) {
+            break;
+        }
+        block_list_remove(&allocator->dirty, block);
+        allocator->zeroing = block;
+        pthread_mutex_unlock(&allocator->lock);
+
+        int result = allocator->backend.zero(allocator->backend.user_data,
+                                             block->memory_type, block->memory, block->size);
+
+        pthread_mutex_lock(&allocator->lock);
+        allocator->zeroing = NULL;
+        if (result == 0) {
+            block_list_push(&allocator->heaps[block->memory_type].clean, block);
+            allocator->stats.scrubbed++;
+        } else {
+            fprintf(stderr, "[Venus Memory] Scrubbing %llu bytes (type %u) failed, releasing\n",
+                    (unsigned long long)block->size, block->memory_type);
+            allocator->stats.pool_blocks--;
+            allocator->stats.pool_bytes -= block->size;
+            block_release(allocator, block);
+        }
+
+        if (!allocator->dirty) {
+            pthread_cond_broadcast(&allocator->recycle_idle);
+        }
+    }
+    pthread_mutex_unlock(&allocator->lock);
+
+    return NULL;
+}
+
+/* Wait for the recycler to drain the dirty queue (lock held) */
+static void recycler_wait_locked(struct pv_venus_memory_allocator *allocator)
+{
+    while (allocator->dirty || allocator->zeroing) {
+        pthread_cond_wait(&allocator->recycle_idle, &allocator->lock);
+    }
+}
+
+/* Release every scrubbed block (lock held) */
+static void pool_release_locked(struct pv_venus_memory_allocator *allocator)
+{
+    for (uint32_t type = 0; type < PV_VENUS_MEMORY_MAX_TYPES; type++) {
+        struct pv_venus_memory_heap *heap = &allocator->heaps[type];
+        while (heap->clean) {
+            struct pv_venus_memory_block *block = heap->clean;
+            block_list_remove(&heap->clean, block);
+            allocator->stats.pool_blocks--;
+            allocator->stats.pool_bytes -= block->size;
+            block_release(allocator, block);
+        }
+    }
+}
+
+/*
+ * Add a shared block to a heap as one free range
+ */
+static int heap_grow(struct pv_venus_memory_allocator *allocator, uint32_t memory_type)
+{
+    struct pv_venus_memory_range *range = calloc(1, sizeof(*range));
+    if (!range) {
+        return -1;
+    }
+
+    struct pv_venus_memory_block *block =
+        block_create(allocator, memory_type, allocator->block_size, false);
+    if (!block) {
+        free(range);
+        return -1;
+    }
+
+    range->block = block;
+    range->size = block->size;
+    block->ranges = range;
+    tlsf_insert(&allocator->heaps[memory_type], range);
+    return 0;
+}
+
+/*
+ * Take @size bytes (aligned) from the heap's blocks
+ */
+static struct pv_venus_memory_range *range_alloc(struct pv_venus_memory_allocator *allocator,
+                                                 uint32_t memory_type,
+                                                 uint64_t size)
+{
+    struct pv_venus_memory_heap *heap = &allocator->heaps[memory_type];
+
+    struct pv_venus_memory_range *range = tlsf_find(heap, size);
+    if (!range) {
+        if (heap_grow(allocator, memory_type) != 0) {
+            return NULL;
+        }
+        range = tlsf_find(heap, size);
+    }
+    tlsf_remove(heap, range);
+
+    /* Split off the tail (sizes are multiples of the alignment, so it stays aligned) */
+    if (range->size > size) {
+        struct pv_venus_memory_range *rest = calloc(1, sizeof(*rest));
+        if (rest) {
+            rest->block = range->block;
+            rest->offset = range->offset + size;
+            rest->size = range->size - size;
+            rest->prev_phys = range;
+            rest->next_phys = range->next_phys;
+            if (rest->next_phys) {
+                rest->next_phys->prev_phys = rest;
+            }
+            range->next_phys = rest;
+            range->size = size;
+            tlsf_insert(heap, rest);
+        }
+    }
+
+    range->block->used += range->size;
+    return range;
+}
+
+/*
+ * Absorb @next (physically after @range, off the free lists) into @range
+ */
+static void range_merge(struct pv_venus_memory_range *range,
+                        struct pv_venus_memory_range *next)
+{
+    range->size += next->size;
+    range->next_phys = next->next_phys;
+    if (range->next_phys) {
+        range->next_phys->prev_phys = range;
+    }
+    free(next);
+}
+
+/* Whether the heap has an empty shared block other than @except */
+static bool heap_has_spare(struct pv_venus_memory_heap *heap,
+                           const struct pv_venus_memory_block *except)
+{
+    for (struct pv_venus_memory_block *block = heap->blocks; block; block = block->next) {
+        if (block != except && !block->dedicated && block->used == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Return a range to its heap, merging it with free neighbours
+ */
+static void range_free(struct pv_venus_memory_allocator *allocator,
+                       struct pv_venus_memory_range *range)
+{
+    struct pv_venus_memory_block *block = range->block;
+    struct pv_venus_memory_heap *heap = &allocator->heaps[block->memory_type];
+
+    block->used -= range->size;
+    range->slab = NULL;
+
+    if (range->next_phys && range->next_phys->free) {
+        tlsf_remove(heap, range->next_phys);
+        range_merge(range, range->next_phys);
+    }
+    if (range->prev_phys && range->prev_phys->free) {
+        struct pv_venus_memory_range *prev = range->prev_phys;
+        tlsf_remove(heap, prev);
+        range_merge(prev, range);
+        range = prev;
+    }
+
+    /* Keep one empty block per type for churn, recycle the rest */
+    if (block->used == 0 && heap_has_spare(heap, block)) {
+        free(range);
+        block_retire(allocator, block, false);
+        return;
+    }
+
+    tlsf_insert(heap, range);
+}
+
+/*
+ * Take one slot of size class @size_class
+ */
+static struct pv_venus_memory_slab *slab_alloc(struct pv_venus_memory_allocator *allocator,
+                                               uint32_t memory_type,
+                                               uint32_t size_class,
+                                               uint64_t *offset)
+{
+    struct pv_venus_memory_heap *heap = &allocator->heaps[memory_type];
+    uint64_t slot_size = allocator->alignment << size_class;
+
+    struct pv_venus_memory_slab *slab = heap->slabs[size_class];
+    if (!slab) {
+        slab = calloc(1, sizeof(*slab));
+        if (!slab) {
+            return NULL;
+        }
+
+        slab->range = range_alloc(allocator, memory_type,
+                                  slot_size * PV_VENUS_MEMORY_SLAB_SLOTS);
+        if (!slab->range) {
+            free(slab);
+            return NULL;
+        }
+        slab->range->slab = slab;
+        slab->size_class = size_class;
+        slab->free_count = PV_VENUS_MEMORY_SLAB_SLOTS;
+        slab->free_mask = SLAB_FULL_MASK;
+        heap->slabs[size_class] = slab;
+    }
+
+    uint32_t slot = (uint32_t)__builtin_ctz(slab->free_mask);
+    slab->free_mask &= ~(1u << slot);
+    *offset = slab->range->offset + slot * slot_size;
+
+    /* Full slabs leave the list until a slot comes back */
+    if (--slab->free_count == 0) {
+        heap->slabs[size_class] = slab->next;
+        if (slab->next) {
+            slab->next->prev = NULL;
+        }
+        slab->next = NULL;
+    }
+
+    return slab;
+}
+
+static void slab_free(struct pv_venus_memory_allocator *allocator,
+                      struct pv_venus_memory_slab *slab,
+                      uint64_t offset)
+{
+    struct pv_venus_memory_heap *heap = &allocator->heaps[slab->range->block->memory_type];
+    uint64_t slot_size = allocator->alignment << slab->size_class;
+    uint32_t slot = (uint32_t)((offset - slab->range->offset) / slot_size);
+
+    slab->free_mask |= 1u << slot;
+    if (slab->free_count++ == 0) {
+        slab->prev = NULL;
+        slab->next = heap->slabs[slab->size_class];
+        if (slab->next) {
+            slab->next->prev = slab;
+        }
+        heap->slabs[slab->size_class] = slab;
+    }
+
+    if (slab->free_count == PV_VENUS_MEMORY_SLAB_SLOTS) {
+        if (slab->prev) {
+            slab->prev->next = slab->next;
+        } else {
+            heap->slabs[slab->size_class] = slab->next;
+        }
+        if (slab->next) {
+            slab->next->prev = slab->prev;
+        }
+        range_free(allocator, slab->range);
+        free(slab);
+    }
+}
+
+/*
+ * Suballocator: Initialize
+ */
+int pv_venus_memory_allocator_init(struct pv_venus_memory_allocator *allocator,
+                                   const struct pv_venus_memory_backend *backend,
+                                   uint64_t block_size,
+                                   uint64_t alignment)
+{
+    if (!allocator || !backend || !backend->allocate || !backend->free) {
+        return -1;
+    }
+
+    if (alignment == 0) {
+        alignment = PV_VENUS_MEMORY_ALIGNMENT;
+    }
+    if (block_size == 0) {
+        block_size = PV_VENUS_MEMORY_BLOCK_SIZE;
+    }
+    if ((alignment & (alignment - 1)) != 0 || block_size % alignment != 0) {
+        fprintf(stderr, "[Venus Memory] Bad block size %llu / alignment %llu\n",
+                (unsigned long long)block_size, (unsigned long long)alignment);
+        return -1;
+    }
+
+    memset(allocator, 0, sizeof(*allocator));
+    allocator->backend = *backend;
+    allocator->block_size = block_size;
+    allocator->alignment = alignment;
+
+    /* One class per power of 2 from the alignment to SMALL_MAX, if a slab fits a block */
+    while (allocator->class_count < PV_VENUS_MEMORY_MAX_CLASSES &&
+           (alignment << allocator->class_count) <= PV_VENUS_MEMORY_SMALL_MAX &&
+           (alignment << allocator->class_count) * PV_VENUS_MEMORY_SLAB_SLOTS <= block_size) {
+        allocator->class_count++;
+    }
+
+    if (pthread_mutex_init(&allocator->lock, NULL) != 0) {
+        return -1;
+    }
+    if (pthread_cond_init(&allocator->recycle_wake, NULL) != 0 ||
+        pthread_cond_init(&allocator->recycle_idle, NULL) != 0) {
+        pthread_mutex_destroy(&allocator->lock);
+        return -1;
+    }
+
+    if (backend->zero) {
+        if (pthread_create(&allocator->recycler, NULL, recycler_main, allocator) != 0) {
+            /* Still usable, freed blocks just go straight back */
+            fprintf(stderr, "[Venus Memory] Failed to start recycler thread\n");
+        } else {
+            allocator->recycler_running = true;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Suballocator: Destroy
+ */
+void pv_venus_memory_allocator_destroy(struct pv_venus_memory_allocator *allocator)
+{
+    if (!allocator || !allocator->backend.free) {
+        return;
+    }
+
+    /* Let the recycler finish what is queued */
+    if (allocator->recycler_running) {
+        pthread_mutex_lock(&allocator->lock);
+        allocator->recycler_stop = true;
+        pthread_cond_signal(&allocator->recycle_wake);
+        pthread_mutex_unlock(&allocator->lock);
+        pthread_join(allocator->recycler, NULL);
+        allocator->recycler_running = false;
+    }
+    pool_release_locked(allocator);
+
+    for (uint32_t type = 0; type < PV_VENUS_MEMORY_MAX_TYPES; type++) {
+        struct pv_venus_memory_heap *heap = &allocator->heaps[type];
+        while (heap->blocks) {
+            struct pv_venus_memory_block *block = heap->blocks;
+            struct pv_venus_memory_range *range = block->ranges;
+            while (range) {
+                struct pv_venus_memory_range *next = range->next_phys;
+                free(range->slab);
+                free(range);
+                range = next;
+            }
+            block_list_remove(&heap->blocks, block);
+            block_release(allocator, block);
+        }
+    }
+
+    printf("[Venus Memory] Final stats: allocations=%llu host_allocations=%llu "
+           "recycled=%llu scrubbed=%llu\n",
+           allocator->stats.allocations, allocator->stats.host_allocations,
+           allocator->stats.recycled, allocator->stats.scrubbed);
+
+    pthread_cond_destroy(&allocator->recycle_wake);
+    pthread_cond_destroy(&allocator->recycle_idle);
+    pthread_mutex_destroy(&allocator->lock);
+    memset(allocator, 0, sizeof(*allocator));
+}
+
+/*
+ * Suballocator: Allocate
+ */
+struct pv_venus_memory_allocation *pv_venus_memory_alloc(
+    struct pv_venus_memory_allocator *allocator,
+    uint32_t memory_type,
+    uint64_t size)
+{
+    if (!allocator || memory_type >= PV_VENUS_MEMORY_MAX_TYPES || size == 0 ||
+        size > UINT64_MAX / 2) {
+        return NULL;
+    }
+
+    struct pv_venus_memory_allocation *allocation = calloc(1, sizeof(*allocation));
+    if (!allocation) {
+        return NULL;
+    }
+    size = align_up(size, allocator->alignment);
+
+    pthread_mutex_lock(&allocator->lock);
+
+    /* Smallest class holding size: ceil(log2(size / alignment)) */
+    uint32_t size_class = size > allocator->alignment
+                              ? top_bit(size - 1) + 1 - top_bit(allocator->alignment) : 0;
+
+    if (size_class < allocator->class_count) {
+        /* Small: a slot of the next power-of-2 class */
+        allocation->size = allocator->alignment << size_class;
+        allocation->slab = slab_alloc(allocator, memory_type, size_class, &allocation->offset);
+        if (allocation->slab) {
+            allocation->block = allocation->slab->range->block;
+        }
+    } else if (size <= allocator->block_size / 2) {
+        allocation->size = size;
+        allocation->range = range_alloc(allocator, memory_type, size);
+        if (allocation->range) {
+            allocation->block = allocation->range->block;
+            allocation->offset = allocation->range->offset;
+        }
+    } else {
+        /* Too big to share a block */
+        allocation->size = size;
+        allocation->block = block_create(allocator, memory_type, size, true);
+        if (allocation->block) {
+            allocation->block->used = size;
+        }
+    }
+
+    if (allocation->block) {
+        allocator->stats.allocations++;
+        allocator->stats.bytes_in_use += allocation->size;
+    }
+
+    pthread_mutex_unlock(&allocator->lock);
+
+    if (!allocation->block) {
+        free(allocation);
+        return NULL;
+    }
+    return allocation;
+}
+
+/*
+ * Suballocator: Free
+ */
+void pv_venus_memory_free(struct pv_venus_memory_allocator *allocator,
+                          struct pv_venus_memory_allocation *allocation)
+{
+    if (!allocator || !allocation) {
+        return;
+    }
+
+    pthread_mutex_lock(&allocator->lock);
+
+    if (allocation->slab) {
+        slab_free(allocator, allocation->slab, allocation->offset);
+    } else if (allocation->range) {
+        range_free(allocator, allocation->range);
+    } else {
+        block_retire(allocator, allocation->block, false);
+    }
+
+    allocator->stats.frees++;
+    allocator->stats.bytes_in_use -= allocation->size;
+
+    pthread_mutex_unlock(&allocator->lock);
+    free(allocation);
+}
+
+/*
+ * Suballocator: Release empty blocks
+ */
+void pv_venus_memory_trim(struct pv_venus_memory_allocator *allocator)
+{
+    if (!allocator) {
+        return;
+    }
+
+    pthread_mutex_lock(&allocator->lock);
+
+    for (uint32_t type = 0; type < PV_VENUS_MEMORY_MAX_TYPES; type++) {
+        struct pv_venus_memory_heap *heap = &allocator->heaps[type];
+        struct pv_venus_memory_block *block = heap->blocks;
+        while (block) {
+            struct pv_venus_memory_block *next = block->next;
+            if (!block->dedicated && block->used == 0) {
+                /* An empty shared block is a single free range */
+                tlsf_remove(heap, block->ranges);
+                free(block->ranges);
+                block_retire(allocator, block, true);
+            }
+            block = next;
+        }
+    }
+
+    /* Everything empty is on its way through the recycler; then let it all go */
+    recycler_wait_locked(allocator);
+    pool_release_locked(allocator);
+
+    pthread_mutex_unlock(&allocator->lock);
+}
+
+/*
+ * Suballocator: Wait for the recycler
+ */
+void pv_venus_memory_wait_idle(struct pv_venus_memory_allocator *allocator)
+{
+    if (!allocator) {
+        return;
+    }
+
+    pthread_mutex_lock(&allocator->lock);
+    recycler_wait_locked(allocator);
+    pthread_mutex_unlock(&allocator->lock);
+}
+
+/*
+ * Suballocator: Get statistics
+ */
+void pv_venus_memory_get_stats(struct pv_venus_memory_allocator *allocator,
+                               struct pv_venus_memory_stats *stats)
+{
+    if (!allocator || !stats) {
+        return;
+    }
+
+    pthread_mutex_lock(&allocator->lock);
+    *stats = allocator->stats;
+    pthread_mutex_unlock(&allocator->lock);
+}
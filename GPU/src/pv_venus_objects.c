@@ -0,0 +1,977 @@
+/*
+ * PearVisor - Venus Object Table Implementation
+ */
+
+#include "pv_venus_objects.h"
+#include "pv_venus_epoch.h"
+#include "pv_venus_protocol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Hash a guest ID (murmur3 finalizer)
+ *
+ * Guest IDs are often small and sequential; mixing spreads them across
+ * the whole table instead of clustering them in one probe run.
+ */
+static inline size_t object_hash(pv_venus_object_id id)
+{
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdull;
+    id ^= id >> 33;
+    id *= 0xc4ceb9fe1a85ec53ull;
+    id ^= id >> 33;
+    return (size_t)id;
+}
+
+/*
+ * Seqlock around table updates
+ *
+ * Writers (already serialized by table->lock) make the sequence odd for
+ * the duration of a change. Readers snapshot it, copy what they need and
+ * retry if it was odd or has moved, so a reader can spin for as long as
+ * one write section lasts: sections never allocate (new arrays are made
+ * beforehand, under the lock only) and cover one object at a time. The
+ * epoch section around every read keeps the arrays allocated, so a racing
+ * read is at worst stale, never a fault; bounded probe loops keep it from
+ * spinning on a torn run.
+ */
+static inline void write_begin(struct pv_venus_object_table *table)
+{
+    unsigned sequence = atomic_load_explicit(&table->sequence, memory_order_relaxed);
+    atomic_store_explicit(&table->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void write_end(struct pv_venus_object_table *table)
+{
+    unsigned sequence = atomic_load_explicit(&table->sequence, memory_order_relaxed);
+    atomic_store_explicit(&table->sequence, sequence + 1, memory_order_release);
+}
+
+static inline unsigned read_begin(struct pv_venus_object_table *table)
+{
+    unsigned sequence;
+    while ((sequence = atomic_load_explicit(&table->sequence, memory_order_acquire)) & 1) {
+        /* Writer mid-update: updates are a few dozen stores at most */
+    }
+    return sequence;
+}
+
+static inline bool read_retry(struct pv_venus_object_table *table, unsigned sequence)
+{
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&table->sequence, memory_order_relaxed) != sequence;
+}
+
+/*
+ * Allocate an empty index of @capacity slots
+ */
+static struct pv_venus_object_index *index_create(size_t capacity)
+{
+    struct pv_venus_object_index *index =
+        calloc(1, sizeof(*index) + capacity * sizeof(struct pv_venus_object));
+    if (!index) {
+        fprintf(stderr, "[Venus Objects] Failed to allocate %zu slots\n", capacity);
+        return NULL;
+    }
+
+    index->capacity = capacity;
+    index->mask = capacity - 1;
+    return index;
+}
+
+/*
+ * Find the entry for @guest_id in one array
+ *
+ * Returns: Entry, or NULL if not present
+ */
+static struct pv_venus_object *index_find(struct pv_venus_object_index *index,
+                                          pv_venus_object_id guest_id)
+{
+    size_t i = object_hash(guest_id) & index->mask;
+
+    /*
+     * Probe runs always end at an empty slot (load factor < 1); the bound
+     * only matters to a reader racing a writer, which retries anyway
+     */
+    for (size_t probes = 0; probes < index->capacity; probes++) {
+        struct pv_venus_object *object = &index->objects[i];
+        if (object->handle == PV_VENUS_OBJECT_HANDLE_NULL) {
+            break;
+        }
+        if (object->guest_id == guest_id) {
+            return object;
+        }
+        i = (i + 1) & index->mask;
+    }
+
+    return NULL;
+}
+
+/*
+ * Place @object in the first free slot of its probe run
+ * (caller guarantees guest_id is not present and a slot is free)
+ */
+static void index_insert(struct pv_venus_object_index *index,
+                         const struct pv_venus_object *object)
+{
+    size_t i = object_hash(object->guest_id) & index->mask;
+    while (index->objects[i].handle != PV_VENUS_OBJECT_HANDLE_NULL) {
+        i = (i + 1) & index->mask;
+    }
+    index->objects[i] = *object;
+}
+
+/*
+ * Empty slot @hole
+ *
+ * Backward-shift deletion: walk the rest of the probe run and move back
+ * every entry whose home slot is not between the hole and its current
+ * position (cyclically), so no lookup ever needs a tombstone.
+ */
+static void index_remove(struct pv_venus_object_index *index, size_t hole)
+{
+    struct pv_venus_object *objects = index->objects;
+    size_t mask = index->mask;
+
+    size_t j = hole;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (objects[j].handle == PV_VENUS_OBJECT_HANDLE_NULL) {
+            break;
+        }
+
+        size_t home = object_hash(objects[j].guest_id) & mask;
+        bool stays = (hole <= j) ? (hole < home && home <= j)
+                                 : (hole < home || home <= j);
+        if (!stays) {
+            objects[hole] = objects[j];
+            hole = j;
+        }
+    }
+
+    objects[hole].handle = PV_VENUS_OBJECT_HANDLE_NULL;
+    objects[hole].host_handle = NULL;
+}
+
+/*
+ * Find @guest_id in the current array, then the one being moved out of
+ *
+ * @found_in: Set to the array holding the entry (may be NULL)
+ */
+static struct pv_venus_object *table_find(struct pv_venus_object_table *table,
+                                          pv_venus_object_id guest_id,
+                                          struct pv_venus_object_index **found_in)
+{
+    struct pv_venus_object_index *index =
+        atomic_load_explicit(&table->index, memory_order_acquire);
+    struct pv_venus_object *object = index_find(index, guest_id);
+
+    if (!object) {
+        index = atomic_load_explicit(&table->old_index, memory_order_acquire);
+        object = index ? index_find(index, guest_id) : NULL;
+    }
+
+    if (found_in) {
+        *found_in = index;
+    }
+    return object;
+}
+
+/*
+ * Copy the entry for @guest_id without taking the table lock
+ *
+ * Returns: true if found
+ */
+static bool read_object(struct pv_venus_object_table *table,
+                        pv_venus_object_id guest_id,
+                        struct pv_venus_object *out)
+{
+    bool found;
+
+    pv_venus_epoch_enter();
+    unsigned sequence;
+    do {
+        sequence = read_begin(table);
+        const struct pv_venus_object *object = table_find(table, guest_id, NULL);
+        found = object != NULL;
+        if (found) {
+            *out = *object;
+        }
+    } while (read_retry(table, sequence));
+    pv_venus_epoch_exit();
+
+    return found;
+}
+
+/*
+ * Move up to @steps slots of the old array into the current one
+ *
+ * Slots are visited downwards starting just below an empty slot, so the
+ * slot being emptied is always the last of its probe run and removing
+ * it needs no backward shift. Entries not yet visited stay reachable.
+ */
+static void migrate(struct pv_venus_object_table *table, size_t steps)
+{
+    struct pv_venus_object_index *old =
+        atomic_load_explicit(&table->old_index, memory_order_relaxed);
+    if (!old) {
+        return;
+    }
+
+    struct pv_venus_object_index *index =
+        atomic_load_explicit(&table->index, memory_order_relaxed);
+
+    while (steps-- > 0) {
+        struct pv_venus_object *object = &old->objects[table->migrate_pos];
+        if (object->handle != PV_VENUS_OBJECT_HANDLE_NULL) {
+            index_insert(index, object);
+            object->handle = PV_VENUS_OBJECT_HANDLE_NULL;
+            table->old_count--;
+        }
+
+        table->migrate_pos = (table->migrate_pos - 1) & old->mask;
+        if (--table->migrate_left == 0 || table->old_count == 0) {
+            /* Readers may still be probing it */
+            atomic_store_explicit(&table->old_index, NULL, memory_order_release);
+            pv_venus_epoch_retire(old);
+            return;
+        }
+    }
+}
+
+/*
+ * Start moving the table into @index, a fresh empty array
+ */
+static void start_resize(struct pv_venus_object_table *table,
+                         struct pv_venus_object_index *index)
+{
+    /* Only one resize at a time: finish the previous one first */
+    migrate(table, SIZE_MAX);
+
+    struct pv_venus_object_index *old =
+        atomic_load_explicit(&table->index, memory_order_relaxed);
+    table->old_count = table->count;
+    table->migrate_left = old->capacity;
+
+    /* Begin just below an empty slot (one always exists) */
+    size_t empty = 0;
+    while (old->objects[empty].handle != PV_VENUS_OBJECT_HANDLE_NULL) {
+        empty++;
+    }
+    table->migrate_pos = (empty - 1) & old->mask;
+
+    atomic_store_explicit(&table->old_index, old, memory_order_release);
+    atomic_store_explicit(&table->index, index, memory_order_release);
+
+    if (table->old_count == 0) {
+        migrate(table, SIZE_MAX);
+    }
+}
+
+/*
+ * Array to grow into if the next add needs one (table lock held)
+ *
+ * Allocated before the write section so readers never wait on calloc.
+ * Returns: A fresh array, or NULL if none is needed or allocation failed
+ */
+static struct pv_venus_object_index *grow_prepare(struct pv_venus_object_table *table)
+{
+    struct pv_venus_object_index *index =
+        atomic_load_explicit(&table->index, memory_order_relaxed);
+    if (table->count + 1 > PV_VENUS_OBJECT_TABLE_MAX_LOAD(index->capacity)) {
+        return index_create(index->capacity * 2);
+    }
+    return NULL;
+}
+
+/*
+ * Halve the index once most objects are gone (table lock held, outside
+ * a write section)
+ */
+static void shrink_if_sparse(struct pv_venus_object_table *table)
+{
+    struct pv_venus_object_index *index =
+        atomic_load_explicit(&table->index, memory_order_relaxed);
+    if (atomic_load_explicit(&table->old_index, memory_order_relaxed) ||
+        index->capacity <= table->min_capacity || table->count >= index->capacity / 8) {
+        return;
+    }
+
+    struct pv_venus_object_index *smaller = index_create(index->capacity / 2);
+    if (!smaller) {
+        return;
+    }
+    write_begin(table);
+    start_resize(table, smaller);
+    write_end(table);
+    table->shrinks++;
+}
+
+/*
+ * Allocate a slot map block holding @capacity objects
+ */
+static struct pv_venus_slot_map *slot_map_create(uint32_t capacity)
+{
+    size_t size = sizeof(struct pv_venus_slot_map) +
+                  capacity * (sizeof(void *) + sizeof(pv_venus_object_id) +
+                              sizeof(struct pv_venus_object_links) +
+                              sizeof(struct pv_venus_object_slot) + sizeof(uint32_t));
+    struct pv_venus_slot_map *map = malloc(size);
+    if (!map) {
+        return NULL;
+    }
+
+    /* Arrays follow the header, largest alignment first */
+    map->capacity = capacity;
+    map->host_handles = (void **)(map + 1);
+    map->guest_ids = (pv_venus_object_id *)(map->host_handles + capacity);
+    map->links = (struct pv_venus_object_links *)(map->guest_ids + capacity);
+    map->slots = (struct pv_venus_object_slot *)(map->links + capacity);
+    map->dense_slots = (uint32_t *)(map->slots + capacity);
+    return map;
+}
+
+/*
+ * Make room in a type's slot map for one more object
+ *
+ * A grown map is a complete copy published with one pointer store, so
+ * this needs the table lock but no write section.
+ *
+ * Returns: The map to insert into, or NULL on allocation failure
+ */
+static struct pv_venus_slot_map *slot_map_reserve(struct pv_venus_object_table *table,
+                                                  pv_venus_object_type type)
+{
+    struct pv_venus_slot_map *map =
+        atomic_load_explicit(&table->types[type], memory_order_relaxed);
+    if (map && (map->free_slot != UINT32_MAX || map->slot_count < map->capacity)) {
+        return map;
+    }
+
+    /* Dense entries never outnumber slots, so one capacity covers both */
+    struct pv_venus_slot_map *grown = slot_map_create(map ? map->capacity * 2 : 16);
+    if (!grown) {
+        return NULL;
+    }
+
+    if (map) {
+        grown->slot_count = map->slot_count;
+        grown->free_slot = map->free_slot;
+        grown->count = map->count;
+        memcpy(grown->slots, map->slots, map->slot_count * sizeof(*map->slots));
+        memcpy(grown->links, map->links, map->slot_count * sizeof(*map->links));
+        memcpy(grown->host_handles, map->host_handles, map->count * sizeof(void *));
+        memcpy(grown->guest_ids, map->guest_ids, map->count * sizeof(pv_venus_object_id));
+        memcpy(grown->dense_slots, map->dense_slots, map->count * sizeof(uint32_t));
+    } else {
+        grown->slot_count = 0;
+        grown->free_slot = UINT32_MAX;
+        grown->count = 0;
+    }
+
+    atomic_store_explicit(&table->types[type], grown, memory_order_release);
+    pv_venus_epoch_retire(map);
+    return grown;
+}
+
+/*
+ * Store an object in its type's slot map
+ *
+ * Returns: Handle, or PV_VENUS_OBJECT_HANDLE_NULL on allocation failure
+ */
+static pv_venus_object_handle slot_map_alloc(
+    struct pv_venus_object_table *table,
+    pv_venus_object_type type,
+    pv_venus_object_id guest_id,
+    void *host_handle)
+{
+    struct pv_venus_slot_map *map = slot_map_reserve(table, type);
+    if (!map) {
+        fprintf(stderr, "[Venus Objects] Failed to grow slot map for type %d\n", type);
+        return PV_VENUS_OBJECT_HANDLE_NULL;
+    }
+
+    /* Reuse a freed slot (its generation was bumped on free) */
+    uint32_t slot;
+    if (map->free_slot != UINT32_MAX) {
+        slot = map->free_slot;
+        map->free_slot = map->slots[slot].dense;
+    } else {
+        slot = map->slot_count++;
+        map->slots[slot].generation = 1;
+    }
+
+    uint32_t dense = map->count++;
+    map->slots[slot].dense = dense;
+    memset(&map->links[slot], 0, sizeof(map->links[slot]));
+    map->host_handles[dense] = host_handle;
+    map->guest_ids[dense] = guest_id;
+    map->dense_slots[dense] = slot;
+
+    return ((pv_venus_object_handle)type << 56) |
+           ((pv_venus_object_handle)map->slots[slot].generation << 32) |
+           slot;
+}
+
+/*
+ * Ownership links of a live object
+ *
+ * Only valid until the next slot_map_alloc(), which may move the block.
+ */
+static struct pv_venus_object_links *object_links(struct pv_venus_object_table *table,
+                                                  pv_venus_object_handle handle)
+{
+    struct pv_venus_slot_map *map = atomic_load_explicit(
+        &table->types[pv_venus_object_handle_type(handle)], memory_order_relaxed);
+    return &map->links[pv_venus_object_handle_slot(handle)];
+}
+
+/*
+ * Host handle of a live object
+ */
+static void *object_host_handle(struct pv_venus_object_table *table,
+                                pv_venus_object_handle handle)
+{
+    struct pv_venus_slot_map *map = atomic_load_explicit(
+        &table->types[pv_venus_object_handle_type(handle)], memory_order_relaxed);
+    return map->host_handles[map->slots[pv_venus_object_handle_slot(handle)].dense];
+}
+
+/*
+ * Make @handle the first child of @parent
+ */
+static void link_attach(struct pv_venus_object_table *table,
+                        pv_venus_object_handle handle,
+                        pv_venus_object_handle parent)
+{
+    struct pv_venus_object_links *links = object_links(table, handle);
+    struct pv_venus_object_links *parent_links = object_links(table, parent);
+
+    links->parent = parent;
+    links->prev_sibling = PV_VENUS_OBJECT_HANDLE_NULL;
+    links->next_sibling = parent_links->first_child;
+    if (parent_links->first_child != PV_VENUS_OBJECT_HANDLE_NULL) {
+        object_links(table, parent_links->first_child)->prev_sibling = handle;
+    }
+    parent_links->first_child = handle;
+}
+
+/*
+ * Take @handle out of its parent's child list (children stay attached)
+ */
+static void link_detach(struct pv_venus_object_table *table,
+                        pv_venus_object_handle handle)
+{
+    struct pv_venus_object_links *links = object_links(table, handle);
+
+    if (links->prev_sibling != PV_VENUS_OBJECT_HANDLE_NULL) {
+        object_links(table, links->prev_sibling)->next_sibling = links->next_sibling;
+    } else if (links->parent != PV_VENUS_OBJECT_HANDLE_NULL) {
+        object_links(table, links->parent)->first_child = links->next_sibling;
+    }
+    if (links->next_sibling != PV_VENUS_OBJECT_HANDLE_NULL) {
+        object_links(table, links->next_sibling)->prev_sibling = links->prev_sibling;
+    }
+
+    links->parent = PV_VENUS_OBJECT_HANDLE_NULL;
+    links->next_sibling = PV_VENUS_OBJECT_HANDLE_NULL;
+    links->prev_sibling = PV_VENUS_OBJECT_HANDLE_NULL;
+}
+
+/*
+ * Release a slot map entry, invalidating every copy of @handle
+ *
+ * The object leaves its parent's child list; its own children become roots.
+ */
+static void slot_map_free(struct pv_venus_object_table *table,
+                          pv_venus_object_handle handle)
+{
+    link_detach(table, handle);
+
+    pv_venus_object_handle child = object_links(table, handle)->first_child;
+    while (child != PV_VENUS_OBJECT_HANDLE_NULL) {
+        struct pv_venus_object_links *links = object_links(table, child);
+        child = links->next_sibling;
+        links->parent = PV_VENUS_OBJECT_HANDLE_NULL;
+        links->next_sibling = PV_VENUS_OBJECT_HANDLE_NULL;
+        links->prev_sibling = PV_VENUS_OBJECT_HANDLE_NULL;
+    }
+
+    struct pv_venus_slot_map *map = atomic_load_explicit(
+        &table->types[pv_venus_object_handle_type(handle)], memory_order_relaxed);
+    uint32_t slot = pv_venus_object_handle_slot(handle);
+    uint32_t dense = map->slots[slot].dense;
+    memset(&map->links[slot], 0, sizeof(map->links[slot]));
+
+    /* Keep the dense arrays packed: move the last object into the hole */
+    uint32_t last = --map->count;
+    if (dense != last) {
+        map->host_handles[dense] = map->host_handles[last];
+        map->guest_ids[dense] = map->guest_ids[last];
+        map->dense_slots[dense] = map->dense_slots[last];
+        map->slots[map->dense_slots[dense]].dense = dense;
+    }
+
+    uint32_t generation = (map->slots[slot].generation + 1) & PV_VENUS_OBJECT_GENERATION_MASK;
+    map->slots[slot].generation = generation ? generation : 1;
+    map->slots[slot].dense = map->free_slot;
+    map->free_slot = slot;
+}
+
+/*
+ * Object table: Initialize
+ */
+int pv_venus_object_table_init(struct pv_venus_object_table *table, size_t max_objects)
+{
+    if (!table) {
+        return -1;
+    }
+
+    memset(table, 0, sizeof(*table));
+
+    /* Smallest power of 2 that keeps max_objects under the load limit */
+    size_t capacity = 16;
+    while (PV_VENUS_OBJECT_TABLE_MAX_LOAD(capacity) < max_objects) {
+        capacity <<= 1;
+    }
+
+    struct pv_venus_object_index *index = index_create(capacity);
+    if (!index) {
+        return -1;
+    }
+
+    if (pthread_mutex_init(&table->lock, NULL) != 0) {
+        free(index);
+        return -1;
+    }
+
+    atomic_init(&table->index, index);
+    atomic_init(&table->old_index, NULL);
+    for (int type = 0; type < PV_VENUS_OBJECT_TYPE_COUNT; type++) {
+        atomic_init(&table->types[type], NULL);
+    }
+    atomic_init(&table->sequence, 0);
+    table->min_capacity = capacity;
+    return 0;
+}
+
+/*
+ * Object table: Destroy
+ */
+void pv_venus_object_table_destroy(struct pv_venus_object_table *table)
+{
+    if (!table || !atomic_load(&table->index)) {
+        return;
+    }
+
+    /* No readers left, so nothing needs to wait out an epoch */
+    free(atomic_load(&table->index));
+    free(atomic_load(&table->old_index));
+    for (int type = 0; type < PV_VENUS_OBJECT_TYPE_COUNT; type++) {
+        free(atomic_load(&table->types[type]));
+    }
+
+    pthread_mutex_destroy(&table->lock);
+    memset(table, 0, sizeof(*table));
+}
+
+/*
+ * Add @guest_id (table lock held, inside a write section)
+ *
+ * @parent_id: Owner, or NULL to add a root
+ * @spare: From grow_prepare(); set to NULL once used
+ */
+static int object_add_locked(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id,
+    void *host_handle,
+    pv_venus_object_type type,
+    const pv_venus_object_id *parent_id,
+    struct pv_venus_object_index **spare)
+{
+    migrate(table, PV_VENUS_OBJECT_TABLE_MIGRATE_STEP);
+
+    pv_venus_object_handle parent = PV_VENUS_OBJECT_HANDLE_NULL;
+    if (parent_id) {
+        struct pv_venus_object *owner = table_find(table, *parent_id, NULL);
+        if (!owner) {
+            fprintf(stderr, "[Venus Objects] Parent 0x%llx of 0x%llx not found\n",
+                    (unsigned long long)*parent_id, (unsigned long long)guest_id);
+            return -1;
+        }
+        parent = owner->handle;
+    }
+
+    /*
+     * A live ID is never rebound: the host object behind it would leak,
+     * and a guest could repeat that without limit. It must be destroyed
+     * first.
+     */
+    if (table_find(table, guest_id, NULL)) {
+        fprintf(stderr, "[Venus Objects] 0x%llx is already live\n",
+                (unsigned long long)guest_id);
+        return -1;
+    }
+
+    /* Grow before the current array passes its load limit */
+    struct pv_venus_object_index *index =
+        atomic_load_explicit(&table->index, memory_order_relaxed);
+    if (table->count + 1 > PV_VENUS_OBJECT_TABLE_MAX_LOAD(index->capacity)) {
+        if (!*spare) {
+            return -1;              /* grow_prepare() couldn't allocate */
+        }
+        start_resize(table, *spare);
+        *spare = NULL;
+        table->grows++;
+        migrate(table, PV_VENUS_OBJECT_TABLE_MIGRATE_STEP);
+        index = atomic_load_explicit(&table->index, memory_order_relaxed);
+    }
+
+    struct pv_venus_object object = {
+        .guest_id = guest_id,
+        .host_handle = host_handle,
+        .handle = slot_map_alloc(table, type, guest_id, host_handle),
+    };
+    if (object.handle == PV_VENUS_OBJECT_HANDLE_NULL) {
+        return -1;
+    }
+    if (parent != PV_VENUS_OBJECT_HANDLE_NULL) {
+        link_attach(table, object.handle, parent);
+    }
+    index_insert(index, &object);
+    table->count++;
+    return 0;
+}
+
+/*
+ * Add under the table lock
+ */
+static int object_add(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id,
+    void *host_handle,
+    pv_venus_object_type type,
+    const pv_venus_object_id *parent_id)
+{
+    if (!table || !atomic_load_explicit(&table->index, memory_order_relaxed) ||
+        !host_handle || (unsigned)type >= PV_VENUS_OBJECT_TYPE_COUNT) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&table->lock);
+
+    /* Allocate outside the write section; unused spares were never published */
+    struct pv_venus_object_index *spare = grow_prepare(table);
+    int ret = -1;
+    if (slot_map_reserve(table, type)) {
+        write_begin(table);
+        ret = object_add_locked(table, guest_id, host_handle, type, parent_id, &spare);
+        write_end(table);
+    } else {
+        fprintf(stderr, "[Venus Objects] Failed to grow slot map for type %d\n", type);
+    }
+
+    pthread_mutex_unlock(&table->lock);
+    free(spare);
+
+    pv_venus_epoch_reclaim();
+
+    if (ret == 0) {
+        pv_venus_trace("[Venus Objects] Added object: guest_id=0x%llx type=%d\n",
+                       guest_id, type);
+    }
+    return ret;
+}
+
+/*
+ * Object table: Add object
+ */
+int pv_venus_object_add(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id,
+    void *host_handle,
+    pv_venus_object_type type)
+{
+    return object_add(table, guest_id, host_handle, type, NULL);
+}
+
+/*
+ * Object table: Add owned object
+ */
+int pv_venus_object_add_child(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id,
+    void *host_handle,
+    pv_venus_object_type type,
+    pv_venus_object_id parent_id)
+{
+    return object_add(table, guest_id, host_handle, type, &parent_id);
+}
+
+/*
+ * Object table: Get object
+ */
+void *pv_venus_object_get(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id)
+{
+    if (!table || !atomic_load_explicit(&table->index, memory_order_relaxed)) {
+        return NULL;
+    }
+
+    struct pv_venus_object object;
+    return read_object(table, guest_id, &object) ? object.host_handle : NULL;
+}
+
+/*
+ * Object table: Get slot map handle
+ */
+pv_venus_object_handle pv_venus_object_lookup(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id)
+{
+    if (!table || !atomic_load_explicit(&table->index, memory_order_relaxed)) {
+        return PV_VENUS_OBJECT_HANDLE_NULL;
+    }
+
+    struct pv_venus_object object;
+    return read_object(table, guest_id, &object) ? object.handle
+                                                 : PV_VENUS_OBJECT_HANDLE_NULL;
+}
+
+/*
+ * Object table: Resolve slot map handle
+ */
+void *pv_venus_object_resolve(
+    struct pv_venus_object_table *table,
+    pv_venus_object_handle handle)
+{
+    pv_venus_object_type type = pv_venus_object_handle_type(handle);
+    uint32_t slot = pv_venus_object_handle_slot(handle);
+    uint32_t generation = pv_venus_object_handle_generation(handle);
+
+    if (!table || type >= PV_VENUS_OBJECT_TYPE_COUNT) {
+        return NULL;
+    }
+
+    void *host_handle;
+
+    pv_venus_epoch_enter();
+    unsigned sequence;
+    do {
+        sequence = read_begin(table);
+        host_handle = NULL;
+
+        const struct pv_venus_slot_map *map =
+            atomic_load_explicit(&table->types[type], memory_order_acquire);
+        if (map && slot < map->slot_count && map->slots[slot].generation == generation) {
+            uint32_t dense = map->slots[slot].dense;
+            if (dense < map->capacity) {
+                host_handle = map->host_handles[dense];
+            }
+        }
+    } while (read_retry(table, sequence));
+    pv_venus_epoch_exit();
+
+    return host_handle;
+}
+
+/*
+ * Object table: Get any object of a type
+ */
+bool pv_venus_object_any(
+    struct pv_venus_object_table *table,
+    pv_venus_object_type type,
+    pv_venus_object_id *guest_id)
+{
+    if (!table || !guest_id || type >= PV_VENUS_OBJECT_TYPE_COUNT) {
+        return false;
+    }
+
+    bool found;
+
+    pv_venus_epoch_enter();
+    unsigned sequence;
+    do {
+        sequence = read_begin(table);
+        found = false;
+
+        const struct pv_venus_slot_map *map =
+            atomic_load_explicit(&table->types[type], memory_order_acquire);
+        if (map && map->count > 0) {
+            *guest_id = map->guest_ids[0];
+            found = true;
+        }
+    } while (read_retry(table, sequence));
+    pv_venus_epoch_exit();
+
+    return found;
+}
+
+/*
+ * Remove @guest_id (table lock held, inside a write section)
+ *
+ * Returns: true if it was present
+ */
+static bool object_remove_locked(struct pv_venus_object_table *table,
+                                 pv_venus_object_id guest_id)
+{
+    struct pv_venus_object_index *index;
+    struct pv_venus_object *object = table_find(table, guest_id, &index);
+    if (!object) {
+        return false;
+    }
+
+    /* In the old array the moved-out slots above migrate_pos are empty, so shifts stay below it */
+    slot_map_free(table, object->handle);
+    index_remove(index, (size_t)(object - index->objects));
+    if (index != atomic_load_explicit(&table->index, memory_order_relaxed)) {
+        table->old_count--;
+    }
+    table->count--;
+
+    migrate(table, PV_VENUS_OBJECT_TABLE_MIGRATE_STEP);
+    return true;
+}
+
+/*
+ * Object table: Remove object
+ */
+void pv_venus_object_remove(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id)
+{
+    if (!table || !atomic_load_explicit(&table->index, memory_order_relaxed)) {
+        return;
+    }
+
+    pthread_mutex_lock(&table->lock);
+    write_begin(table);
+    bool removed = object_remove_locked(table, guest_id);
+    write_end(table);
+
+    /* Shrink once the guest has torn down most of its objects */
+    if (removed) {
+        shrink_if_sparse(table);
+    }
+    pthread_mutex_unlock(&table->lock);
+
+    pv_venus_epoch_reclaim();
+
+    if (removed) {
+        pv_venus_trace("[Venus Objects] Removed object: guest_id=0x%llx\n", guest_id);
+    }
+}
+
+/*
+ * Count @root and everything below it (preorder walk, no stack)
+ */
+static size_t subtree_size(struct pv_venus_object_table *table,
+                           pv_venus_object_handle root)
+{
+    size_t count = 1;
+    pv_venus_object_handle node = root;
+
+    for (;;) {
+        pv_venus_object_handle child = object_links(table, node)->first_child;
+        if (child != PV_VENUS_OBJECT_HANDLE_NULL) {
+            node = child;
+            count++;
+            continue;
+        }
+
+        while (node != root &&
+               object_links(table, node)->next_sibling == PV_VENUS_OBJECT_HANDLE_NULL) {
+            node = object_links(table, node)->parent;
+        }
+        if (node == root) {
+            return count;
+        }
+        node = object_links(table, node)->next_sibling;
+        count++;
+    }
+}
+
+/*
+ * Object table: Remove object and everything it owns
+ */
+size_t pv_venus_object_remove_tree(
+    struct pv_venus_object_table *table,
+    pv_venus_object_id guest_id,
+    struct pv_venus_object_release **releases)
+{
+    if (releases) {
+        *releases = NULL;
+    }
+    if (!table || !releases || !atomic_load_explicit(&table->index, memory_order_relaxed)) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&table->lock);
+
+    struct pv_venus_object *object = table_find(table, guest_id, NULL);
+    if (!object) {
+        pthread_mutex_unlock(&table->lock);
+        return 0;
+    }
+
+    pv_venus_object_handle root = object->handle;
+    size_t total = subtree_size(table, root);
+    struct pv_venus_object_release *list = malloc(total * sizeof(*list));
+    if (!list) {
+        pthread_mutex_unlock(&table->lock);
+        fprintf(stderr, "[Venus Objects] Failed to allocate teardown of %zu objects\n", total);
+        return 0;
+    }
+
+    /*
+     * Postorder: always remove the deepest first child, then climb back to
+     * its parent, whose next child (if any) is now first. Removing a leaf
+     * detaches it, so every object is visited once. Each removal is its
+     * own write section, so readers wait for one object, not the tree;
+     * between them they see a smaller tree, never an orphan.
+     */
+    size_t count = 0;
+    pv_venus_object_handle node = root;
+    for (;;) {
+        pv_venus_object_handle child;
+        while ((child = object_links(table, node)->first_child) != PV_VENUS_OBJECT_HANDLE_NULL) {
+            node = child;
+        }
+
+        pv_venus_object_handle parent = object_links(table, node)->parent;
+        struct pv_venus_slot_map *map = atomic_load_explicit(
+            &table->types[pv_venus_object_handle_type(node)], memory_order_relaxed);
+        uint32_t dense = map->slots[pv_venus_object_handle_slot(node)].dense;
+
+        list[count] = (struct pv_venus_object_release) {
+            .guest_id = map->guest_ids[dense],
+            .host_handle = map->host_handles[dense],
+            .parent_handle = parent != PV_VENUS_OBJECT_HANDLE_NULL
+                                 ? object_host_handle(table, parent) : NULL,
+            .type = pv_venus_object_handle_type(node),
+        };
+        write_begin(table);
+        object_remove_locked(table, list[count].guest_id);
+        write_end(table);
+        count++;
+
+        if (node == root) {
+            break;
+        }
+        node = parent;
+    }
+    shrink_if_sparse(table);
+
+    pthread_mutex_unlock(&table->lock);
+    pv_venus_epoch_reclaim();
+
+    pv_venus_trace("[Venus Objects] Removed tree: guest_id=0x%llx objects=%zu\n",
+                   guest_id, count);
+
+    *releases = list;
+    return count;
+}
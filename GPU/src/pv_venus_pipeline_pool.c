@@ -0,0 +1,270 @@
+/*
+ * PearVisor - Venus Asynchronous Pipeline Compilation Implementation
+ */
+
+#include "pv_venus_pipeline_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Take @pipeline off the queue (lock held) */
+static void queue_remove(struct pv_venus_pipeline_pool *pool, struct pv_venus_pipeline *pipeline)
+{
+    if (pipeline->prev) {
+        pipeline->prev->next = pipeline->next;
+    } else {
+        pool->head = pipeline->next;
+    }
+    if (pipeline->next) {
+        pipeline->next->prev = pipeline->prev;
+    } else {
+        pool->tail = pipeline->prev;
+    }
+    pipeline->prev = NULL;
+    pipeline->next = NULL;
+    pipeline->queued = false;
+    pool->queued--;
+}
+
+/*
+ * Run a dequeued job (lock not held) and publish the result
+ */
+static void run_job(struct pv_venus_pipeline_pool *pool, struct pv_venus_pipeline *pipeline)
+{
+    void *result = NULL;
+    int status = pipeline->compile(pipeline->job, &result);
+    pipeline->job = NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    pipeline->pipeline = status == 0 ? result : NULL;
+    atomic_store_explicit(&pipeline->state,
+                          status == 0 ? PV_VENUS_PIPELINE_READY : PV_VENUS_PIPELINE_FAILED,
+                          memory_order_release);
+    pool->stats.compiled++;
+    if (status != 0) {
+        pool->stats.failed++;
+    }
+    pthread_cond_broadcast(&pool->done);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+ * Worker thread: compile queued jobs in order; drain the queue before stopping
+ */
+static void *worker_main(void *arg)
+{
+    struct pv_venus_pipeline_pool *pool = arg;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->head && !pool->stop) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+        }
+
+        struct pv_venus_pipeline *pipeline = pool->head;
+        if (!pipeline) {
+            break;
+        }
+        queue_remove(pool, pipeline);
+        pthread_mutex_unlock(&pool->lock);
+
+        run_job(pool, pipeline);
+
+        pthread_mutex_lock(&pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+/*
+ * Pool: Initialize
+ */
+int pv_venus_pipeline_pool_init(struct pv_venus_pipeline_pool *pool, unsigned threads)
+{
+    if (!pool) {
+        return -1;
+    }
+
+    if (threads == 0) {
+        /* Leave a CPU for the ring thread */
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 1 ? (unsigned)(cpus - 1) : 1;
+    }
+    if (threads > PV_VENUS_PIPELINE_POOL_MAX_THREADS) {
+        threads = PV_VENUS_PIPELINE_POOL_MAX_THREADS;
+    }
+
+    memset(pool, 0, sizeof(*pool));
+    if (pthread_mutex_init(&pool->lock, NULL) != 0) {
+        return -1;
+    }
+    if (pthread_cond_init(&pool->work, NULL) != 0 ||
+        pthread_cond_init(&pool->done, NULL) != 0) {
+        pthread_mutex_destroy(&pool->lock);
+        return -1;
+    }
+
+    for (unsigned i = 0; i < threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, worker_main, pool) != 0) {
+            break;
+        }
+        pool->thread_count++;
+    }
+
+    /* Resolvers compile inline, so even zero workers make progress */
+    if (pool->thread_count < threads) {
+        fprintf(stderr, "[Venus Pipelines] Started %u of %u compile threads\n",
+                pool->thread_count, threads);
+    }
+
+    printf("[Venus Pipelines] Compile pool started: %u threads\n", pool->thread_count);
+    return 0;
+}
+
+/*
+ * Pool: Destroy
+ */
+void pv_venus_pipeline_pool_destroy(struct pv_venus_pipeline_pool *pool)
+{
+    if (!pool) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (unsigned i = 0; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    /* Nothing left to drain it if no worker ever started */
+    while (pool->head) {
+        struct pv_venus_pipeline *pipeline = pool->head;
+        queue_remove(pool, pipeline);
+        run_job(pool, pipeline);
+    }
+
+    printf("[Venus Pipelines] Final stats: compiled=%llu failed=%llu waits=%llu inline=%llu\n",
+           pool->stats.compiled, pool->stats.failed, pool->stats.waits,
+           pool->stats.inline_compiles);
+
+    pthread_cond_destroy(&pool->work);
+    pthread_cond_destroy(&pool->done);
+    pthread_mutex_destroy(&pool->lock);
+    memset(pool, 0, sizeof(*pool));
+}
+
+/*
+ * Pool: Queue a compile
+ */
+struct pv_venus_pipeline *pv_venus_pipeline_compile_async(struct pv_venus_pipeline_pool *pool,
+                                                          pv_venus_pipeline_compile_t compile,
+                                                          void *job)
+{
+    if (!pool || !compile) {
+        return NULL;
+    }
+
+    struct pv_venus_pipeline *pipeline = calloc(1, sizeof(*pipeline));
+    if (!pipeline) {
+        return NULL;
+    }
+    pipeline->compile = compile;
+    pipeline->job = job;
+    atomic_init(&pipeline->state, PV_VENUS_PIPELINE_PENDING);
+
+    pthread_mutex_lock(&pool->lock);
+
+    pipeline->queued = true;
+    pipeline->prev = pool->tail;
+    if (pool->tail) {
+        pool->tail->next = pipeline;
+    } else {
+        pool->head = pipeline;
+    }
+    pool->tail = pipeline;
+
+    pool->stats.submitted++;
+    if (++pool->queued > pool->stats.max_queued) {
+        pool->stats.max_queued = pool->queued;
+    }
+
+    pthread_cond_signal(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+
+    return pipeline;
+}
+
+/*
+ * Pool: Resolve a placeholder
+ */
+void *pv_venus_pipeline_resolve(struct pv_venus_pipeline_pool *pool,
+                                struct pv_venus_pipeline *pipeline)
+{
+    if (!pipeline) {
+        return NULL;
+    }
+
+    int state = atomic_load_explicit(&pipeline->state, memory_order_acquire);
+    if (state == PV_VENUS_PIPELINE_PENDING) {
+        uint64_t start = now_ns();
+
+        pthread_mutex_lock(&pool->lock);
+        if (pipeline->queued) {
+            /* Not started: compiling it here beats waiting behind the queue */
+            queue_remove(pool, pipeline);
+            pool->stats.inline_compiles++;
+            pthread_mutex_unlock(&pool->lock);
+
+            run_job(pool, pipeline);
+
+            pthread_mutex_lock(&pool->lock);
+        }
+        while (atomic_load_explicit(&pipeline->state, memory_order_acquire) ==
+               PV_VENUS_PIPELINE_PENDING) {
+            pthread_cond_wait(&pool->done, &pool->lock);
+        }
+        pool->stats.waits++;
+        pool->stats.wait_ns += now_ns() - start;
+        pthread_mutex_unlock(&pool->lock);
+
+        state = atomic_load_explicit(&pipeline->state, memory_order_acquire);
+    }
+
+    return state == PV_VENUS_PIPELINE_READY ? pipeline->pipeline : NULL;
+}
+
+/*
+ * Pool: Free a placeholder
+ */
+void pv_venus_pipeline_free(struct pv_venus_pipeline *pipeline)
+{
+    free(pipeline);
+}
+
+/*
+ * Pool: Get statistics
+ */
+void pv_venus_pipeline_pool_get_stats(struct pv_venus_pipeline_pool *pool,
+                                      struct pv_venus_pipeline_pool_stats *stats)
+{
+    if (!pool || !stats) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    *stats = pool->stats;
+    pthread_mutex_unlock(&pool->lock);
+}
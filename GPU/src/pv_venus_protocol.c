@@ -20,6 +20,7 @@ static const struct {
     
     /* Physical Device */
     {PV_VK_COMMAND_vkGetPhysicalDeviceFeatures, "vkGetPhysicalDeviceFeatures"},
+    {PV_VK_COMMAND_vkGetPhysicalDeviceFormatProperties, "vkGetPhysicalDeviceFormatProperties"},
     {PV_VK_COMMAND_vkGetPhysicalDeviceProperties, "vkGetPhysicalDeviceProperties"},
     {PV_VK_COMMAND_vkGetPhysicalDeviceQueueFamilyProperties, "vkGetPhysicalDeviceQueueFamilyProperties"},
     {PV_VK_COMMAND_vkGetPhysicalDeviceMemoryProperties, "vkGetPhysicalDeviceMemoryProperties"},
@@ -44,6 +45,9 @@ static const struct {
     
     /* Sync */
     {PV_VK_COMMAND_vkCreateFence, "vkCreateFence"},
+    {PV_VK_COMMAND_vkDestroyFence, "vkDestroyFence"},
+    {PV_VK_COMMAND_vkResetFences, "vkResetFences"},
+    {PV_VK_COMMAND_vkGetFenceStatus, "vkGetFenceStatus"},
     {PV_VK_COMMAND_vkWaitForFences, "vkWaitForFences"},
     {PV_VK_COMMAND_vkCreateSemaphore, "vkCreateSemaphore"},
     
@@ -55,11 +59,19 @@ static const struct {
     {PV_VK_COMMAND_vkCreateImage, "vkCreateImage"},
     {PV_VK_COMMAND_vkDestroyImage, "vkDestroyImage"},
     
+    /* Shaders */
+    {PV_VK_COMMAND_vkCreateShaderModule, "vkCreateShaderModule"},
+    {PV_VK_COMMAND_vkDestroyShaderModule, "vkDestroyShaderModule"},
+    {PV_VK_COMMAND_vkCreateGraphicsPipelines, "vkCreateGraphicsPipelines"},
+    {PV_VK_COMMAND_vkCreateComputePipelines, "vkCreateComputePipelines"},
+    {PV_VK_COMMAND_vkDestroyPipeline, "vkDestroyPipeline"},
+    
     /* Command Buffers */
     {PV_VK_COMMAND_vkCreateCommandPool, "vkCreateCommandPool"},
     {PV_VK_COMMAND_vkAllocateCommandBuffers, "vkAllocateCommandBuffers"},
     {PV_VK_COMMAND_vkBeginCommandBuffer, "vkBeginCommandBuffer"},
     {PV_VK_COMMAND_vkEndCommandBuffer, "vkEndCommandBuffer"},
+    {PV_VK_COMMAND_vkCmdBindPipeline, "vkCmdBindPipeline"},
 };
 
 #define NUM_COMMAND_NAMES (sizeof(command_names) / sizeof(command_names[0]))
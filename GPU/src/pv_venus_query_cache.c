@@ -0,0 +1,162 @@
+/*
+ * PearVisor - Venus Physical Device Query Cache Implementation
+ */
+
+#include "pv_venus_query_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Replies start on reply-ring alignment, so each copy-out is aligned too */
+#define BLOB_ALIGN 16
+
+static size_t align_up(size_t value)
+{
+    return (value + BLOB_ALIGN - 1) & ~(size_t)(BLOB_ALIGN - 1);
+}
+
+/*
+ * Query cache: Build
+ */
+int pv_venus_query_cache_build(struct pv_venus_query_cache *cache,
+                               const struct pv_venus_query_device *device,
+                               const struct pv_venus_query_backend *backend)
+{
+    if (!cache || !device || !device->properties || !device->features ||
+        !device->memory_properties || (device->queue_family_count && !device->queue_families) ||
+        !backend || !backend->format_properties) {
+        return -1;
+    }
+
+    pv_venus_query_cache_destroy(cache);
+
+    size_t queue_families_size = sizeof(struct pv_venus_queue_family_properties) +
+                                 device->queue_family_count * sizeof(VkQueueFamilyProperties);
+
+    /* One layout pass; the formats go last */
+    size_t offsets[PV_VENUS_QUERY_COMMAND_COUNT] = { 0 };
+    size_t sizes[PV_VENUS_QUERY_COMMAND_COUNT] = { 0 };
+    sizes[PV_VK_COMMAND_vkGetPhysicalDeviceFeatures] = sizeof(*device->features);
+    sizes[PV_VK_COMMAND_vkGetPhysicalDeviceProperties] = sizeof(*device->properties);
+    sizes[PV_VK_COMMAND_vkGetPhysicalDeviceQueueFamilyProperties] = queue_families_size;
+    sizes[PV_VK_COMMAND_vkGetPhysicalDeviceMemoryProperties] = sizeof(*device->memory_properties);
+
+    size_t total = 0;
+    for (uint32_t i = 0; i < PV_VENUS_QUERY_COMMAND_COUNT; i++) {
+        if (sizes[i]) {
+            offsets[i] = total;
+            total = align_up(total + sizes[i]);
+        }
+    }
+    size_t formats_offset = total;
+    total += PV_VENUS_QUERY_FORMAT_COUNT * sizeof(VkFormatProperties);
+
+    uint8_t *storage = calloc(1, total);
+    if (!storage) {
+        return -1;
+    }
+
+    memcpy(storage + offsets[PV_VK_COMMAND_vkGetPhysicalDeviceFeatures],
+           device->features, sizeof(*device->features));
+    memcpy(storage + offsets[PV_VK_COMMAND_vkGetPhysicalDeviceProperties],
+           device->properties, sizeof(*device->properties));
+    memcpy(storage + offsets[PV_VK_COMMAND_vkGetPhysicalDeviceMemoryProperties],
+           device->memory_properties, sizeof(*device->memory_properties));
+
+    uint8_t *queue_families = storage + offsets[PV_VK_COMMAND_vkGetPhysicalDeviceQueueFamilyProperties];
+    struct pv_venus_queue_family_properties count = { .count = device->queue_family_count };
+    memcpy(queue_families, &count, sizeof(count));
+    if (device->queue_family_count) {
+        memcpy(queue_families + sizeof(count), device->queue_families,
+               device->queue_family_count * sizeof(VkQueueFamilyProperties));
+    }
+
+    /* The only part that costs driver calls, and only this once */
+    VkFormatProperties *formats = (VkFormatProperties *)(storage + formats_offset);
+    for (uint32_t format = 0; format < PV_VENUS_QUERY_FORMAT_COUNT; format++) {
+        backend->format_properties(backend->user_data, (VkFormat)format, &formats[format]);
+    }
+
+    cache->storage = storage;
+    cache->storage_size = total;
+    for (uint32_t i = 0; i < PV_VENUS_QUERY_COMMAND_COUNT; i++) {
+        if (sizes[i]) {
+            cache->replies[i].data = storage + offsets[i];
+            cache->replies[i].size = sizes[i];
+        }
+    }
+    cache->formats = formats;
+    cache->stats.bytes_cached = total;
+
+    printf("[Venus Query] Cached %zu bytes of query replies (%u formats)\n",
+           total, PV_VENUS_QUERY_FORMAT_COUNT);
+    return 0;
+}
+
+/*
+ * Query cache: Destroy
+ */
+void pv_venus_query_cache_destroy(struct pv_venus_query_cache *cache)
+{
+    if (!cache) {
+        return;
+    }
+
+    free(cache->storage);
+    struct pv_venus_query_cache_stats stats = cache->stats;
+    memset(cache, 0, sizeof(*cache));
+
+    /* Counters span rebuilds; the size is of what is cached now */
+    cache->stats = stats;
+    cache->stats.bytes_cached = 0;
+}
+
+/*
+ * Query cache: Lookup
+ */
+int pv_venus_query_cache_lookup(struct pv_venus_query_cache *cache,
+                                uint32_t command_id,
+                                const void *data,
+                                size_t data_size,
+                                struct pv_venus_query_blob *blob)
+{
+    if (!cache || !blob) {
+        return -1;
+    }
+
+    if (command_id == PV_VK_COMMAND_vkGetPhysicalDeviceFormatProperties) {
+        struct pv_venus_get_format_properties args;
+        if (!cache->formats || data_size < sizeof(args)) {
+            cache->stats.misses++;
+            return -1;
+        }
+        memcpy(&args, data, sizeof(args));
+        if (args.format >= PV_VENUS_QUERY_FORMAT_COUNT) {
+            cache->stats.misses++;
+            return -1;
+        }
+        blob->data = &cache->formats[args.format];
+        blob->size = sizeof(VkFormatProperties);
+    } else if (command_id < PV_VENUS_QUERY_COMMAND_COUNT && cache->replies[command_id].size) {
+        *blob = cache->replies[command_id];
+    } else {
+        cache->stats.misses++;
+        return -1;
+    }
+
+    cache->stats.hits++;
+    cache->stats.bytes_served += blob->size;
+    return 0;
+}
+
+/*
+ * Query cache: Get statistics
+ */
+void pv_venus_query_cache_get_stats(const struct pv_venus_query_cache *cache,
+                                    struct pv_venus_query_cache_stats *stats)
+{
+    if (!cache || !stats) {
+        return;
+    }
+    *stats = cache->stats;
+}
@@ -0,0 +1,202 @@
+/*
+ * PearVisor - Venus Reply Ring Implementation
+ */
+
+#include "pv_venus_reply.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* Round @size up to the reply alignment */
+static inline size_t reply_align(size_t size)
+{
+    return (size + PV_VENUS_REPLY_ALIGN - 1) & ~(size_t)(PV_VENUS_REPLY_ALIGN - 1);
+}
+
+struct pv_venus_reply_ring *pv_venus_reply_ring_create(
+    const struct pv_venus_ring_layout *layout)
+{
+    if (!layout || !layout->shared_memory) {
+        fprintf(stderr, "[Venus Reply] Invalid layout\n");
+        return NULL;
+    }
+
+    /* Validate buffer size is power of 2 and holds at least one reply */
+    if (layout->buffer_size < PV_VENUS_REPLY_ALIGN ||
+        (layout->buffer_size & (layout->buffer_size - 1)) != 0) {
+        fprintf(stderr, "[Venus Reply] Buffer size must be power of 2\n");
+        return NULL;
+    }
+
+    /* Replies are written in place, so the buffer must be aligned too */
+    uint8_t *base = (uint8_t *)layout->shared_memory;
+    if (((uintptr_t)(base + layout->buffer_offset) & (PV_VENUS_REPLY_ALIGN - 1)) != 0) {
+        fprintf(stderr, "[Venus Reply] Buffer must be %d-byte aligned\n",
+                PV_VENUS_REPLY_ALIGN);
+        return NULL;
+    }
+
+    struct pv_venus_reply_ring *ring = calloc(1, sizeof(*ring));
+    if (!ring) {
+        fprintf(stderr, "[Venus Reply] Failed to allocate reply ring\n");
+        return NULL;
+    }
+
+    /* Setup control region (guest consumes at head, we produce at tail) */
+    ring->head = (atomic_uint *)(base + layout->head_offset);
+    ring->tail = (atomic_uint *)(base + layout->tail_offset);
+    ring->status = (atomic_uint *)(base + layout->status_offset);
+
+    atomic_store_explicit(ring->tail, 0, memory_order_relaxed);
+    atomic_store_explicit(ring->status, PV_VENUS_RING_STATUS_IDLE,
+                          memory_order_relaxed);
+
+    /* Setup buffer region */
+    ring->data = base + layout->buffer_offset;
+    ring->size = (uint32_t)layout->buffer_size;
+    ring->mask = ring->size - 1;
+
+    printf("[Venus Reply] Created reply ring: buffer=%u bytes\n", ring->size);
+
+    return ring;
+}
+
+void pv_venus_reply_ring_destroy(struct pv_venus_reply_ring *ring)
+{
+    if (!ring) {
+        return;
+    }
+
+    printf("[Venus Reply] Final stats: replies=%llu bytes=%llu paddings=%llu "
+           "overflows=%llu doorbells=%llu\n",
+           ring->stats.replies,
+           ring->stats.bytes_written,
+           ring->stats.paddings,
+           ring->stats.overflows,
+           ring->stats.doorbells);
+
+    free(ring);
+}
+
+void pv_venus_reply_set_doorbell(
+    struct pv_venus_reply_ring *ring,
+    pv_venus_reply_doorbell_t doorbell,
+    void *user_data)
+{
+    if (!ring) {
+        return;
+    }
+
+    ring->doorbell = doorbell;
+    ring->doorbell_data = user_data;
+}
+
+int pv_venus_reply_begin(
+    struct pv_venus_reply_ring *ring,
+    struct pv_venus_reply_encoder *encoder,
+    uint32_t command_id,
+    size_t max_size)
+{
+    if (!ring || !encoder) {
+        return -1;
+    }
+
+    size_t total = reply_align(sizeof(struct pv_venus_reply_header) + max_size);
+    if (total > ring->size) {
+        fprintf(stderr, "[Venus Reply] Reply of %zu bytes exceeds ring size\n", max_size);
+        ring->stats.overflows++;
+        return -1;
+    }
+
+    /* Keep the reply contiguous: pad to the wrap if it would straddle it */
+    uint32_t tail = atomic_load_explicit(ring->tail, memory_order_relaxed);
+    uint32_t offset = tail & ring->mask;
+    uint32_t padding = (offset + total > ring->size) ? ring->size - offset : 0;
+
+    if (padding + total > pv_venus_reply_space(ring)) {
+        ring->stats.overflows++;
+        return -1;
+    }
+
+    if (padding > 0) {
+        struct pv_venus_reply_header *filler =
+            (struct pv_venus_reply_header *)(ring->data + offset);
+        filler->command_id = PV_VENUS_REPLY_PADDING;
+        filler->reply_size = padding;
+        filler->sequence = 0;
+        filler->result = 0;
+        tail += padding;
+        ring->stats.paddings++;
+    }
+
+    encoder->ring = ring;
+    encoder->start = tail;
+    encoder->header = (struct pv_venus_reply_header *)(ring->data + (tail & ring->mask));
+    encoder->header->command_id = command_id;
+    encoder->payload = (uint8_t *)(encoder->header + 1);
+    encoder->capacity = total - sizeof(struct pv_venus_reply_header);
+    encoder->size = 0;
+
+    return 0;
+}
+
+void *pv_venus_reply_reserve(struct pv_venus_reply_encoder *encoder, size_t size)
+{
+    if (!encoder || size > encoder->capacity - encoder->size) {
+        return NULL;
+    }
+
+    void *ptr = encoder->payload + encoder->size;
+    encoder->size += size;
+    return ptr;
+}
+
+int pv_venus_reply_write(
+    struct pv_venus_reply_encoder *encoder,
+    const void *data,
+    size_t size)
+{
+    void *dst = pv_venus_reply_reserve(encoder, size);
+    if (!dst) {
+        return -1;
+    }
+
+    memcpy(dst, data, size);
+    return 0;
+}
+
+void pv_venus_reply_end(struct pv_venus_reply_encoder *encoder, int32_t result)
+{
+    if (!encoder || !encoder->ring) {
+        return;
+    }
+
+    struct pv_venus_reply_ring *ring = encoder->ring;
+    uint32_t reply_size = (uint32_t)reply_align(sizeof(struct pv_venus_reply_header) +
+                                                encoder->size);
+
+    encoder->header->reply_size = reply_size;
+    encoder->header->sequence = ring->sequence++;
+    encoder->header->result = result;
+
+    /* Publish padding (if any) and reply with one tail store */
+    uint32_t old_tail = atomic_load_explicit(ring->tail, memory_order_relaxed);
+    uint32_t new_tail = encoder->start + reply_size;
+    atomic_store_explicit(ring->tail, new_tail, memory_order_release);
+
+    ring->stats.replies++;
+    ring->stats.bytes_written += new_tail - old_tail;
+    encoder->ring = NULL;
+
+    /* Order the tail store before reading status (pairs with a waiting guest) */
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (ring->doorbell &&
+        (atomic_load_explicit(ring->status, memory_order_relaxed) &
+         PV_VENUS_RING_STATUS_NEED_NOTIFY) &&
+        (atomic_fetch_and(ring->status, ~PV_VENUS_RING_STATUS_NEED_NOTIFY) &
+         PV_VENUS_RING_STATUS_NEED_NOTIFY)) {
+        ring->stats.doorbells++;
+        ring->doorbell(ring->doorbell_data);
+    }
+}
@@ -2,12 +2,28 @@
  * PearVisor - Venus Protocol Ring Buffer Implementation
  */
 
+#if defined(__linux__)
+#define _GNU_SOURCE  /* memfd_create */
+#endif
+
 #include "pv_venus_ring.h"
+#include "pv_venus_decoder.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 
 /* Forward declaration of command processing thread */
 static void *pv_venus_ring_thread(void *arg);
@@ -18,6 +34,194 @@ static inline bool is_power_of_two(uint32_t value)
     return value != 0 && (value & (value - 1)) == 0;
 }
 
+/* CPU hint for spin-wait loops */
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    /* isb stalls longer than yield on Apple cores, which is what we want */
+    __asm__ __volatile__("isb sy" ::: "memory");
+#endif
+}
+
+/*
+ * Park the processing thread until the tail moves away from @head,
+ * the ring is stopped, or the park timeout expires
+ */
+static void pv_venus_ring_park(struct pv_venus_ring *ring, uint32_t head)
+{
+    uint32_t timeout_ms = ring->wait_policy.park_timeout_ms;
+
+#if defined(__linux__)
+    atomic_fetch_or(ring->control.status, PV_VENUS_RING_STATUS_NEED_NOTIFY);
+
+    /* Re-check after asking for notification (pairs with fence in notify) */
+    uint32_t tail = atomic_load(ring->control.tail);
+    if (tail == head && ring->running) {
+        struct timespec timeout = {
+            .tv_sec = timeout_ms / 1000,
+            .tv_nsec = (long)(timeout_ms % 1000) * 1000000L,
+        };
+        ring->stats.parks++;
+
+        /* Sleeps only while the tail word still equals the value we saw */
+        syscall(SYS_futex, (void *)ring->control.tail, FUTEX_WAIT_PRIVATE,
+                tail, &timeout, NULL, 0);
+    }
+
+    atomic_fetch_and(ring->control.status, ~PV_VENUS_RING_STATUS_NEED_NOTIFY);
+#else
+    pthread_mutex_lock(&ring->mutex);
+    atomic_fetch_or(ring->control.status, PV_VENUS_RING_STATUS_NEED_NOTIFY);
+
+    /* Double-check tail after acquiring lock */
+    if (atomic_load(ring->control.tail) == head && ring->running) {
+        struct timespec timeout;
+        clock_gettime(CLOCK_REALTIME, &timeout);
+        timeout.tv_sec += timeout_ms / 1000;
+        timeout.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (timeout.tv_nsec >= 1000000000L) {
+            timeout.tv_sec++;
+            timeout.tv_nsec -= 1000000000L;
+        }
+        ring->stats.parks++;
+
+        pthread_cond_timedwait(&ring->cond, &ring->mutex, &timeout);
+    }
+
+    atomic_fetch_and(ring->control.status, ~PV_VENUS_RING_STATUS_NEED_NOTIFY);
+    pthread_mutex_unlock(&ring->mutex);
+#endif
+}
+
+/* Wake a parked processing thread */
+static void pv_venus_ring_wake(struct pv_venus_ring *ring)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, (void *)ring->control.tail, FUTEX_WAKE_PRIVATE,
+            1, NULL, NULL, 0);
+#else
+    pthread_mutex_lock(&ring->mutex);
+    pthread_cond_signal(&ring->cond);
+    pthread_mutex_unlock(&ring->mutex);
+#endif
+}
+
+/*
+ * Wait until the tail moves away from @head (or the ring is stopped):
+ * spin, then yield, then park
+ */
+static void pv_venus_ring_wait(struct pv_venus_ring *ring, uint32_t head)
+{
+    const struct pv_venus_ring_wait_policy *policy = &ring->wait_policy;
+
+    ring->stats.waits++;
+
+    for (uint32_t i = 0; i < policy->spin_iterations; i++) {
+        if (pv_venus_ring_get_tail(ring) != head || !ring->running) {
+            ring->stats.spins++;
+            return;
+        }
+        cpu_relax();
+    }
+
+    for (uint32_t i = 0; i < policy->yield_iterations; i++) {
+        sched_yield();
+        if (pv_venus_ring_get_tail(ring) != head || !ring->running) {
+            ring->stats.yields++;
+            return;
+        }
+    }
+
+    pv_venus_ring_park(ring, head);
+}
+
+/*
+ * Compute region offsets for a layout version
+ */
+int pv_venus_ring_layout_init(
+    struct pv_venus_ring_layout *layout,
+    void *memory,
+    size_t size,
+    uint32_t version,
+    uint32_t cache_line_size)
+{
+    if (!layout || !memory) {
+        return -1;
+    }
+
+    if (cache_line_size == 0) {
+        cache_line_size = PV_VENUS_RING_CACHE_LINE_SIZE;
+    }
+
+    /* Distance between control words and total control region size */
+    size_t stride;
+    size_t control_size;
+    switch (version) {
+    case PV_VENUS_RING_LAYOUT_PACKED:
+        stride = sizeof(uint32_t);
+        control_size = 16;  /* Keep buffer 16-byte aligned */
+        break;
+    case PV_VENUS_RING_LAYOUT_ISOLATED:
+        if (!is_power_of_two(cache_line_size)) {
+            fprintf(stderr, "[Venus Ring] Cache line size must be power of 2\n");
+            return -1;
+        }
+        stride = cache_line_size;
+        control_size = 3 * stride;  /* Buffer starts on its own line too */
+        break;
+    default:
+        fprintf(stderr, "[Venus Ring] Unknown layout version %u\n", version);
+        return -1;
+    }
+
+    if (size <= control_size) {
+        fprintf(stderr, "[Venus Ring] Region too small for layout: %zu\n", size);
+        return -1;
+    }
+
+    /* Largest power-of-2 buffer that fits after the control words */
+    size_t buffer_size = 1;
+    while (buffer_size * 2 <= size - control_size && buffer_size < (1u << 31)) {
+        buffer_size *= 2;
+    }
+
+    memset(layout, 0, sizeof(*layout));
+    layout->shared_memory = memory;
+    layout->shared_memory_size = size;
+    layout->version = version;
+    layout->cache_line_size = cache_line_size;
+    layout->head_offset = 0;
+    layout->tail_offset = stride;
+    layout->status_offset = 2 * stride;
+    layout->buffer_offset = control_size;
+    layout->buffer_size = buffer_size;
+
+    return 0;
+}
+
+/* Check that an ISOLATED layout really keeps each word on its own line */
+static bool layout_is_isolated(const struct pv_venus_ring_layout *layout)
+{
+    size_t line = layout->cache_line_size;
+    if (!is_power_of_two((uint32_t)line)) {
+        return false;
+    }
+
+    size_t head = layout->head_offset / line;
+    size_t tail = layout->tail_offset / line;
+    size_t status = layout->status_offset / line;
+    size_t buffer = layout->buffer_offset / line;
+
+    return layout->head_offset % line == 0 &&
+           layout->tail_offset % line == 0 &&
+           layout->status_offset % line == 0 &&
+           layout->buffer_offset % line == 0 &&
+           head != tail && head != status && tail != status &&
+           buffer != head && buffer != tail && buffer != status;
+}
+
 /*
  * Create a Venus ring buffer
  */
@@ -30,6 +234,12 @@ struct pv_venus_ring *pv_venus_ring_create(
         return NULL;
     }
 
+    /* Validate control region layout */
+    if (layout->version == PV_VENUS_RING_LAYOUT_ISOLATED && !layout_is_isolated(layout)) {
+        fprintf(stderr, "[Venus Ring] Isolated layout shares cache lines\n");
+        return NULL;
+    }
+
     /* Validate buffer size is power of 2 */
     if (!is_power_of_two(layout->buffer_size)) {
         fprintf(stderr, "[Venus Ring] Buffer size must be power of 2\n");
@@ -59,6 +269,7 @@ struct pv_venus_ring *pv_venus_ring_create(
     ring->buffer.mask = layout->buffer_size - 1;
     ring->buffer.current_pos = 0;
     ring->buffer.data = base + layout->buffer_offset;
+    ring->buffer.mirrored = layout->buffer_mirrored;
 
     /* Setup extra region */
     if (layout->extra_size > 0) {
@@ -83,12 +294,171 @@ struct pv_venus_ring *pv_venus_ring_create(
 
     ring->running = false;
     ring->dispatch_context = dispatch_context;
+    ring->mapping_fd = -1;
+
+    /* Setup wait policy */
+    ring->wait_policy = layout->wait_policy;
+    if (ring->wait_policy.park_timeout_ms == 0) {
+        ring->wait_policy = PV_VENUS_RING_WAIT_POLICY_DEFAULT;
+    }
+
+    /* Setup head publication batching */
+    ring->head_batch_bytes = layout->head_batch_bytes;
+    ring->head_batch_commands = layout->head_batch_commands;
+    if (ring->head_batch_bytes == 0 && ring->head_batch_commands == 0) {
+        ring->head_batch_bytes = ring->buffer.size / 4;
+    }
 
     /* Initialize stats */
     memset(&ring->stats, 0, sizeof(ring->stats));
 
-    printf("[Venus Ring] Created ring buffer: size=%u extra=%zu\n",
-           ring->buffer.size, ring->extra.size);
+    printf("[Venus Ring] Created ring buffer: size=%u extra=%zu layout=%s\n",
+           ring->buffer.size, ring->extra.size,
+           layout->version == PV_VENUS_RING_LAYOUT_ISOLATED ? "isolated" : "packed");
+
+    return ring;
+}
+
+/*
+ * Create an anonymous shared memory file of the given size
+ */
+static int create_shared_memory_fd(size_t size)
+{
+#if defined(__linux__)
+    int fd = memfd_create("pv-venus-ring", MFD_CLOEXEC);
+#else
+    static atomic_uint counter;
+    char name[32];  /* macOS limits POSIX shm names to 31 chars */
+    snprintf(name, sizeof(name), "/pv-ring-%d-%u", (int)getpid(),
+             atomic_fetch_add(&counter, 1));
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(name);
+    }
+#endif
+    if (fd < 0) {
+        return -1;
+    }
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/*
+ * Map [control][buffer] from fd, followed by a second view of [buffer]
+ */
+static uint8_t *map_mirrored(int fd, size_t control_size, size_t buffer_size)
+{
+    size_t file_size = control_size + buffer_size;
+    size_t map_size = file_size + buffer_size;
+
+    /* Reserve the whole range first so the two mappings are adjacent */
+    uint8_t *base = mmap(NULL, map_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    if (mmap(base, file_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+             fd, 0) == MAP_FAILED ||
+        mmap(base + file_size, buffer_size, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_FIXED, fd, (off_t)control_size) == MAP_FAILED) {
+        munmap(base, map_size);
+        return NULL;
+    }
+
+    /* Sanity check: a write through one view must show up in the other */
+    volatile uint8_t *first = base + control_size;
+    volatile uint8_t *second = base + file_size;
+    *first = 0xA5;
+    bool aliased = (*second == 0xA5);
+    *first = 0;
+    if (!aliased) {
+        munmap(base, map_size);
+        return NULL;
+    }
+
+    return base;
+}
+
+/*
+ * Create a ring buffer in mirror-mapped memory
+ */
+struct pv_venus_ring *pv_venus_ring_create_mirrored(uint32_t buffer_size)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+
+    if (buffer_size == 0 || (buffer_size & (buffer_size - 1)) != 0 ||
+        buffer_size % page_size != 0) {
+        fprintf(stderr, "[Venus Ring] Mirrored size must be a power of 2 "
+                "and a multiple of %zu, got %u\n", page_size, buffer_size);
+        return NULL;
+    }
+
+    /* Layout: [head][tail][status] on separate lines, pad to page, [buffer][mirror] */
+    size_t control_size = page_size;
+    size_t file_size = control_size + buffer_size;
+    size_t map_size = file_size + buffer_size;
+    bool mirrored = false;
+
+    int fd = create_shared_memory_fd(file_size);
+    uint8_t *base = (fd >= 0) ? map_mirrored(fd, control_size, buffer_size) : NULL;
+
+    if (base) {
+        mirrored = true;
+    } else {
+        /* Fallback: plain layout, commands may straddle the wrap */
+        fprintf(stderr, "[Venus Ring] Mirror mapping unavailable, "
+                "using plain ring layout\n");
+        map_size = file_size;
+        base = (fd >= 0)
+            ? mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+            : mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            fprintf(stderr, "[Venus Ring] Failed to map ring memory\n");
+            if (fd >= 0) {
+                close(fd);
+            }
+            return NULL;
+        }
+    }
+
+    struct pv_venus_ring_layout layout = {
+        .shared_memory = base,
+        .shared_memory_size = map_size,
+        .version = PV_VENUS_RING_LAYOUT_ISOLATED,
+        .cache_line_size = PV_VENUS_RING_CACHE_LINE_SIZE,
+        .head_offset = 0,
+        .tail_offset = PV_VENUS_RING_CACHE_LINE_SIZE,
+        .status_offset = 2 * PV_VENUS_RING_CACHE_LINE_SIZE,
+        .buffer_offset = control_size,
+        .buffer_size = buffer_size,
+        .buffer_mirrored = mirrored,
+        .extra_offset = 0,
+        .extra_size = 0
+    };
+
+    struct pv_venus_ring *ring = pv_venus_ring_create(&layout, NULL);
+    if (!ring) {
+        fprintf(stderr, "[Venus Ring] Failed to create ring buffer\n");
+        munmap(base, map_size);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return NULL;
+    }
+
+    /* Ring owns the mapping from here on */
+    ring->mapping = base;
+    ring->mapping_size = map_size;
+    ring->mapping_fd = fd;
+
+    printf("[Venus Ring] Ring buffer created: %u bytes, %s\n",
+           buffer_size, mirrored ? "mirror-mapped" : "plain layout");
 
     return ring;
 }
@@ -111,16 +481,149 @@ void pv_venus_ring_destroy(struct pv_venus_ring *ring)
     pthread_mutex_destroy(&ring->mutex);
     pthread_cond_destroy(&ring->cond);
 
+    /* Free scratch buffer */
+    if (ring->scratch) {
+        free(ring->scratch);
+    }
+
+    /* Release shared memory if we own it */
+    if (ring->mapping) {
+        munmap(ring->mapping, ring->mapping_size);
+    }
+    if (ring->mapping_fd >= 0) {
+        close(ring->mapping_fd);
+    }
+
     /* Print final stats */
-    printf("[Venus Ring] Final stats: commands=%llu bytes=%llu errors=%llu waits=%llu\n",
+    printf("[Venus Ring] Final stats: commands=%llu bytes=%llu errors=%llu waits=%llu "
+           "zero_copy=%llu wrap_copies=%llu spins=%llu yields=%llu parks=%llu "
+           "notifies=%llu suppressed=%llu head_publishes=%llu recoveries=%llu\n",
            ring->stats.commands_processed,
            ring->stats.bytes_read,
            ring->stats.errors,
-           ring->stats.waits);
+           ring->stats.waits,
+           ring->stats.zero_copy_views,
+           ring->stats.wrap_copies,
+           ring->stats.spins,
+           ring->stats.yields,
+           ring->stats.parks,
+           atomic_load_explicit(&ring->stats.notifies, memory_order_relaxed),
+           atomic_load_explicit(&ring->stats.notifies_suppressed, memory_order_relaxed),
+           ring->stats.head_publishes,
+           ring->stats.recoveries);
+    if (ring->arena.data) {
+        printf("[Venus Ring] Arena: allocations=%llu exhausted=%llu resets=%llu "
+               "high_water=%zu/%zu\n",
+               ring->arena.allocations,
+               ring->arena.exhausted,
+               ring->arena.resets,
+               ring->arena.high_water,
+               ring->arena.size);
+    }
+    if (ring->stats.queue_latency.count > 0) {
+        struct pv_venus_latency_summary latency =
+            pv_venus_latency_summarize(&ring->stats.queue_latency);
+        printf("[Venus Ring] Queue latency: p50=%lluns p99=%lluns p99.9=%lluns max=%lluns\n",
+               latency.p50_ns, latency.p99_ns, latency.p999_ns, latency.max_ns);
+    }
 
+    free(ring->arena.data);
     free(ring);
 }
 
+/*
+ * Reserve space in a ring arena
+ */
+void *pv_venus_ring_arena_reserve(
+    struct pv_venus_ring_arena *arena,
+    size_t size,
+    size_t align)
+{
+    if (!arena || size == 0) {
+        return NULL;
+    }
+
+    if (align == 0) {
+        align = 16;
+    }
+
+    /* One allocation for the life of the ring, on first use */
+    if (!arena->data) {
+        arena->data = malloc(PV_VENUS_RING_ARENA_SIZE);
+        if (!arena->data) {
+            arena->exhausted++;
+            return NULL;
+        }
+        arena->size = PV_VENUS_RING_ARENA_SIZE;
+    }
+
+    /* Align the absolute address, not just the offset */
+    uintptr_t base = (uintptr_t)arena->data;
+    uintptr_t start = (base + arena->offset + align - 1) & ~(uintptr_t)(align - 1);
+    size_t offset = start - base;
+
+    if (offset > arena->size || size > arena->size - offset) {
+        arena->reserved = 0;
+        arena->exhausted++;
+        return NULL;
+    }
+
+    arena->reserved_offset = offset;
+    arena->reserved = size;
+    return arena->data + offset;
+}
+
+/*
+ * Commit bytes from the last reservation
+ */
+void pv_venus_ring_arena_commit(struct pv_venus_ring_arena *arena, size_t size)
+{
+    if (!arena || arena->reserved == 0) {
+        return;
+    }
+
+    if (size > arena->reserved) {
+        size = arena->reserved;
+    }
+
+    arena->offset = arena->reserved_offset + size;
+    arena->reserved = 0;
+
+    if (arena->offset > arena->high_water) {
+        arena->high_water = arena->offset;
+    }
+    arena->allocations++;
+}
+
+/*
+ * Allocate from a ring arena
+ */
+void *pv_venus_ring_arena_alloc(
+    struct pv_venus_ring_arena *arena,
+    size_t size,
+    size_t align)
+{
+    void *ptr = pv_venus_ring_arena_reserve(arena, size, align);
+    if (ptr) {
+        pv_venus_ring_arena_commit(arena, size);
+    }
+    return ptr;
+}
+
+/*
+ * Release everything allocated from a ring arena
+ */
+void pv_venus_ring_arena_reset(struct pv_venus_ring_arena *arena)
+{
+    if (!arena || arena->offset == 0) {
+        return;
+    }
+
+    arena->offset = 0;
+    arena->reserved = 0;
+    arena->resets++;
+}
+
 /*
  * Read data from ring buffer
  */
@@ -134,9 +637,17 @@ int pv_venus_ring_read(struct pv_venus_ring *ring, void *dest, size_t size)
     size_t remaining = size;
     uint32_t pos = ring->buffer.current_pos;
 
+    /* Mirrored buffer: every range up to size bytes is contiguous */
+    if (ring->buffer.mirrored && size <= ring->buffer.size) {
+        memcpy(dst, ring->buffer.data + pv_venus_ring_seq_offset(ring, pos), size);
+        ring->buffer.current_pos = pos + size;
+        ring->stats.bytes_read += size;
+        return 0;
+    }
+
     while (remaining > 0) {
         /* Calculate how much we can read in one chunk (until wrap) */
-        uint32_t pos_masked = pos & ring->buffer.mask;
+        uint32_t pos_masked = pv_venus_ring_seq_offset(ring, pos);
         uint32_t available_to_wrap = ring->buffer.size - pos_masked;
         size_t chunk = (remaining < available_to_wrap) ? remaining : available_to_wrap;
 
@@ -156,6 +667,64 @@ int pv_venus_ring_read(struct pv_venus_ring *ring, void *dest, size_t size)
     return 0;
 }
 
+/*
+ * Acquire a zero-copy view of the next bytes in the ring
+ */
+int pv_venus_ring_view_acquire(
+    struct pv_venus_ring *ring,
+    size_t size,
+    struct pv_venus_ring_view *view)
+{
+    if (!ring || !view || size == 0) {
+        return -1;
+    }
+
+    /* Never hand out bytes the guest has not published yet */
+    if (size > ring->buffer.size || size > pv_venus_ring_available(ring)) {
+        fprintf(stderr, "[Venus Ring] View out of bounds: size=%zu available=%u\n",
+                size, pv_venus_ring_available(ring));
+        ring->stats.errors++;
+        return -1;
+    }
+
+    uint32_t pos_masked = pv_venus_ring_seq_offset(ring, ring->buffer.current_pos);
+    uint32_t available_to_wrap = ring->buffer.size - pos_masked;
+
+    if (size <= available_to_wrap || ring->buffer.mirrored) {
+        /* Contiguous: point straight into the ring */
+        view->data = ring->buffer.data + pos_masked;
+        view->size = size;
+        view->copied = false;
+
+        ring->buffer.current_pos += size;
+        ring->stats.bytes_read += size;
+        ring->stats.zero_copy_views++;
+        return 0;
+    }
+
+    /* Straddles the wrap: linearize into the scratch buffer */
+    if (size > ring->scratch_size) {
+        uint8_t *scratch = realloc(ring->scratch, size);
+        if (!scratch) {
+            fprintf(stderr, "[Venus Ring] Failed to grow scratch buffer\n");
+            ring->stats.errors++;
+            return -1;
+        }
+        ring->scratch = scratch;
+        ring->scratch_size = size;
+    }
+
+    if (pv_venus_ring_read(ring, ring->scratch, size) != 0) {
+        return -1;
+    }
+
+    view->data = ring->scratch;
+    view->size = size;
+    view->copied = true;
+    ring->stats.wrap_copies++;
+    return 0;
+}
+
 /*
  * Get pointer to data in extra region
  */
@@ -189,59 +758,76 @@ static void *pv_venus_ring_thread(void *arg)
 
     printf("[Venus Ring] Thread started\n");
 
-    /* Set status to running */
-    atomic_store_explicit(ring->control.status, PV_VENUS_RING_STATUS_RUNNING,
-                         memory_order_relaxed);
+    /* Set status to running, keeping an error the guest hasn't reset */
+    atomic_fetch_or(ring->control.status, PV_VENUS_RING_STATUS_RUNNING);
 
     while (ring->running) {
+        /* A ring that lost its framing is dead until the guest resets it */
+        if (!pv_venus_ring_recover(ring)) {
+            pv_venus_ring_wait(ring, pv_venus_ring_get_tail(ring));
+            continue;
+        }
+
         /* Get current tail (guest's write position) */
         uint32_t tail = pv_venus_ring_get_tail(ring);
         uint32_t head = ring->buffer.current_pos;
 
         /* Check if we have data to process */
         if (head == tail) {
-            /* No data available, wait for notification */
-            pthread_mutex_lock(&ring->mutex);
-            
-            /* Double-check tail after acquiring lock */
-            tail = pv_venus_ring_get_tail(ring);
-            if (head == tail && ring->running) {
-                ring->stats.waits++;
-                
-                /* Wait with timeout (1 second) */
-                struct timespec timeout;
-                clock_gettime(CLOCK_REALTIME, &timeout);
-                timeout.tv_sec += 1;
-                
-                pthread_cond_timedwait(&ring->cond, &ring->mutex, &timeout);
-            }
-            
-            pthread_mutex_unlock(&ring->mutex);
+            /* No data available, spin/yield/park until the guest writes */
+            pv_venus_ring_wait(ring, head);
             continue;
         }
 
-        /* TODO: Process commands here */
-        /* For now, just skip to demonstrate ring buffer operation */
-        printf("[Venus Ring] Data available: head=%u tail=%u available=%u bytes\n",
-               head, tail, pv_venus_ring_available(ring));
-
-        /* Simulate processing by advancing head */
-        ring->buffer.current_pos = tail;
-        pv_venus_ring_set_head(ring, tail);
-        ring->stats.commands_processed++;
-        
-        /* Small sleep to avoid busy loop in this stub */
-        usleep(10000);  /* 10ms */
+        if (ring->dispatch_context) {
+            /* Decode and dispatch everything the guest has published */
+            int processed = pv_venus_decode_all(ring, ring->dispatch_context);
+            if (processed > 0) {
+                ring->stats.commands_processed += processed;
+            }
+        } else {
+            /* Nobody to dispatch to: drop the data so the guest can't stall */
+            ring->buffer.current_pos = tail;
+            pv_venus_ring_set_head(ring, tail);
+            ring->stats.head_publishes++;
+        }
     }
 
-    /* Set status back to idle */
-    atomic_store_explicit(ring->control.status, PV_VENUS_RING_STATUS_IDLE,
-                         memory_order_relaxed);
+    /* Set status back to idle, keeping an error for the guest to see */
+    atomic_fetch_and(ring->control.status, PV_VENUS_RING_STATUS_ERROR);
 
     printf("[Venus Ring] Thread stopped\n");
     return NULL;
 }
 
+/*
+ * Resume decoding after the guest resets an error
+ */
+bool pv_venus_ring_recover(struct pv_venus_ring *ring)
+{
+    if (!ring) {
+        return false;
+    }
+
+    if (atomic_load_explicit(ring->control.status, memory_order_acquire) &
+        PV_VENUS_RING_STATUS_ERROR) {
+        return false;
+    }
+
+    if (ring->framing_lost) {
+        uint32_t tail = pv_venus_ring_get_tail(ring);
+        printf("[Venus Ring] Guest reset the ring, skipping %u bytes\n",
+               pv_venus_ring_seq_distance(ring->buffer.current_pos, tail));
+        ring->buffer.current_pos = tail;
+        pv_venus_ring_set_head(ring, tail);
+        ring->stats.head_publishes++;
+        ring->stats.recoveries++;
+        ring->framing_lost = false;
+    }
+
+    return true;
+}
+
 /*
  * Start ring buffer processing thread
  */
@@ -283,9 +869,7 @@ int pv_venus_ring_stop(struct pv_venus_ring *ring)
     ring->running = false;
 
     /* Wake up thread if it's waiting */
-    pthread_mutex_lock(&ring->mutex);
-    pthread_cond_signal(&ring->cond);
-    pthread_mutex_unlock(&ring->mutex);
+    pv_venus_ring_wake(ring);
 
     /* Wait for thread to finish */
     pthread_join(ring->thread, NULL);
@@ -303,8 +887,22 @@ void pv_venus_ring_notify(struct pv_venus_ring *ring)
         return;
     }
 
-    /* Wake up processing thread */
-    pthread_mutex_lock(&ring->mutex);
-    pthread_cond_signal(&ring->cond);
-    pthread_mutex_unlock(&ring->mutex);
+    /* Order the guest's tail store before reading status (pairs with park) */
+    atomic_thread_fence(memory_order_seq_cst);
+
+    /*
+     * Spinning or busy threads will see the new tail on their own. The
+     * first notifier to find the bit set clears it, so a burst of
+     * doorbells costs one wakeup.
+     */
+    if (!pv_venus_ring_needs_notify(ring) ||
+        !(atomic_fetch_and(ring->control.status, ~PV_VENUS_RING_STATUS_NEED_NOTIFY) &
+          PV_VENUS_RING_STATUS_NEED_NOTIFY)) {
+        atomic_fetch_add_explicit(&ring->stats.notifies_suppressed, 1,
+                                  memory_order_relaxed);
+        return;
+    }
+
+    atomic_fetch_add_explicit(&ring->stats.notifies, 1, memory_order_relaxed);
+    pv_venus_ring_wake(ring);
 }
@@ -0,0 +1,286 @@
+/*
+ * PearVisor - Venus Shader Module Cache Implementation
+ */
+
+#include "pv_venus_shader_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define HASH_K1 0x9E3779B97F4A7C15ull
+#define HASH_K2 0xC2B2AE3D27D4EB4Full
+
+static inline uint64_t rotl64(uint64_t value, unsigned bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+/*
+ * Hash: Multiply-rotate over 64-bit words, murmur3 finalizer
+ */
+uint64_t pv_venus_shader_hash(const void *code, size_t size)
+{
+    const uint8_t *bytes = code;
+    uint64_t hash = HASH_K1 ^ (size * HASH_K2);
+
+    while (size >= 8) {
+        uint64_t word;
+        memcpy(&word, bytes, sizeof(word));
+        hash = rotl64(hash ^ (word * HASH_K2), 31) * HASH_K1;
+        bytes += 8;
+        size -= 8;
+    }
+    if (size > 0) {
+        uint64_t word = 0;
+        memcpy(&word, bytes, size);
+        hash = rotl64(hash ^ (word * HASH_K2), 31) * HASH_K1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/*
+ * Double the bucket array (lock held); on failure the cache just stays denser
+ */
+static void cache_grow(struct pv_venus_shader_cache *cache)
+{
+    size_t bucket_count = cache->bucket_count * 2;
+    struct pv_venus_shader **buckets = calloc(bucket_count, sizeof(*buckets));
+    if (!buckets) {
+        return;
+    }
+
+    for (size_t i = 0; i < cache->bucket_count; i++) {
+        struct pv_venus_shader *shader = cache->buckets[i];
+        while (shader) {
+            struct pv_venus_shader *next = shader->next;
+            size_t bucket = shader->hash & (bucket_count - 1);
+            shader->next = buckets[bucket];
+            buckets[bucket] = shader;
+            shader = next;
+        }
+    }
+
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucket_count = bucket_count;
+}
+
+/* Entry for exactly this code on this device (lock held) */
+static struct pv_venus_shader *find_locked(struct pv_venus_shader_cache *cache, void *device,
+                                          uint64_t hash, const void *code, size_t code_size)
+{
+    struct pv_venus_shader *shader = cache->buckets[hash & (cache->bucket_count - 1)];
+    while (shader &&
+           !(shader->hash == hash && shader->device == device &&
+             shader->code_size == code_size && memcmp(shader->code, code, code_size) == 0)) {
+        shader = shader->next;
+    }
+    return shader;
+}
+
+/* Destroy an entry already unlinked and uncounted (no lock needed) */
+static void shader_free(struct pv_venus_shader_cache *cache, struct pv_venus_shader *shader)
+{
+    cache->backend.destroy(cache->backend.user_data, shader->device, shader->module);
+    free(shader->code);
+    free(shader);
+}
+
+/*
+ * Cache: Initialize
+ */
+int pv_venus_shader_cache_init(struct pv_venus_shader_cache *cache,
+                               const struct pv_venus_shader_cache_backend *backend)
+{
+    if (!cache || !backend || !backend->create || !backend->destroy) {
+        return -1;
+    }
+
+    memset(cache, 0, sizeof(*cache));
+    cache->backend = *backend;
+    cache->bucket_count = PV_VENUS_SHADER_CACHE_BUCKETS;
+    cache->buckets = calloc(cache->bucket_count, sizeof(*cache->buckets));
+    if (!cache->buckets) {
+        return -1;
+    }
+
+    if (pthread_mutex_init(&cache->lock, NULL) != 0) {
+        free(cache->buckets);
+        cache->buckets = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Cache: Destroy
+ */
+void pv_venus_shader_cache_destroy(struct pv_venus_shader_cache *cache)
+{
+    if (!cache || !cache->buckets) {
+        return;
+    }
+
+    for (size_t i = 0; i < cache->bucket_count; i++) {
+        while (cache->buckets[i]) {
+            struct pv_venus_shader *shader = cache->buckets[i];
+            cache->buckets[i] = shader->next;
+            cache->stats.modules--;
+            cache->stats.code_bytes -= shader->code_size;
+            shader_free(cache, shader);
+        }
+    }
+
+    printf("[Venus Shaders] Final stats: lookups=%llu hits=%llu bytes_saved=%llu\n",
+           cache->stats.lookups, cache->stats.hits, cache->stats.bytes_saved);
+
+    free(cache->buckets);
+    pthread_mutex_destroy(&cache->lock);
+    memset(cache, 0, sizeof(*cache));
+}
+
+/*
+ * Cache: Acquire
+ */
+struct pv_venus_shader *pv_venus_shader_cache_acquire(struct pv_venus_shader_cache *cache,
+                                                      void *device,
+                                                      const void *code,
+                                                      size_t code_size)
+{
+    if (!cache || !code || code_size == 0 || code_size % sizeof(uint32_t) != 0) {
+        return NULL;
+    }
+
+    /* Hash outside the lock; it is the only pass over the code on a hit */
+    uint64_t hash = pv_venus_shader_hash(code, code_size);
+
+    pthread_mutex_lock(&cache->lock);
+    cache->stats.lookups++;
+
+    struct pv_venus_shader *shader = find_locked(cache, device, hash, code, code_size);
+    if (shader) {
+        shader->refs++;
+        cache->stats.hits++;
+        cache->stats.bytes_saved += code_size;
+        pthread_mutex_unlock(&cache->lock);
+        return shader;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    /* Miss: compile from an aligned private copy, without holding up other lookups */
+    shader = calloc(1, sizeof(*shader));
+    uint32_t *copy = malloc(code_size);
+    if (!shader || !copy) {
+        free(shader);
+        free(copy);
+        return NULL;
+    }
+    memcpy(copy, code, code_size);
+
+    if (cache->backend.create(cache->backend.user_data, device, copy, code_size,
+                              &shader->module) != 0) {
+        free(shader);
+        free(copy);
+        return NULL;
+    }
+
+    shader->device = device;
+    shader->hash = hash;
+    shader->code_size = code_size;
+    shader->code = copy;
+    shader->refs = 1;
+
+    pthread_mutex_lock(&cache->lock);
+
+    /* Someone else compiled the same code meanwhile: theirs wins */
+    struct pv_venus_shader *raced = find_locked(cache, device, hash, code, code_size);
+    if (raced) {
+        raced->refs++;
+        cache->stats.hits++;
+        cache->stats.bytes_saved += code_size;
+        pthread_mutex_unlock(&cache->lock);
+        shader_free(cache, shader);
+        return raced;
+    }
+
+    size_t bucket = hash & (cache->bucket_count - 1);
+    shader->next = cache->buckets[bucket];
+    cache->buckets[bucket] = shader;
+
+    cache->stats.modules++;
+    cache->stats.code_bytes += code_size;
+    if (cache->stats.modules > cache->bucket_count) {
+        cache_grow(cache);
+    }
+
+    pthread_mutex_unlock(&cache->lock);
+    return shader;
+}
+
+/*
+ * Cache: Retain
+ */
+void pv_venus_shader_cache_retain(struct pv_venus_shader_cache *cache,
+                                  struct pv_venus_shader *shader)
+{
+    if (!cache || !shader) {
+        return;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    shader->refs++;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+/*
+ * Cache: Release
+ */
+void pv_venus_shader_cache_release(struct pv_venus_shader_cache *cache,
+                                   struct pv_venus_shader *shader)
+{
+    if (!cache || !shader) {
+        return;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+
+    bool last = --shader->refs == 0;
+    if (last) {
+        struct pv_venus_shader **link = &cache->buckets[shader->hash & (cache->bucket_count - 1)];
+        while (*link != shader) {
+            link = &(*link)->next;
+        }
+        *link = shader->next;
+        cache->stats.modules--;
+        cache->stats.code_bytes -= shader->code_size;
+    }
+
+    pthread_mutex_unlock(&cache->lock);
+
+    /* Unlinked, so nobody else can reach it: destroy without the lock */
+    if (last) {
+        shader_free(cache, shader);
+    }
+}
+
+/*
+ * Cache: Get statistics
+ */
+void pv_venus_shader_cache_get_stats(struct pv_venus_shader_cache *cache,
+                                     struct pv_venus_shader_cache_stats *stats)
+{
+    if (!cache || !stats) {
+        return;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    *stats = cache->stats;
+    pthread_mutex_unlock(&cache->lock);
+}
@@ -0,0 +1,324 @@
+/*
+ * PearVisor - Venus Queue Submit Coalescing Implementation
+ */
+
+#include "pv_venus_submit.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Grow a handle array to hold @needed entries */
+static int reserve(void **array, uint32_t *capacity, uint32_t needed, size_t element_size)
+{
+    if (needed <= *capacity) {
+        return 0;
+    }
+
+    uint32_t new_capacity = *capacity ? *capacity : 64;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+
+    void *grown = realloc(*array, (size_t)new_capacity * element_size);
+    if (!grown) {
+        return -1;
+    }
+    *array = grown;
+    *capacity = new_capacity;
+    return 0;
+}
+
+/*
+ * Submit everything held as one vkQueueSubmit (lock held)
+ */
+static int flush_locked(struct pv_venus_submit_coalescer *coalescer,
+                        enum pv_venus_submit_flush_reason reason)
+{
+    if (coalescer->batch_count == 0) {
+        return 0;
+    }
+
+    /* The arrays are final now, so pointers into them are safe */
+    VkSubmitInfo submits[PV_VENUS_SUBMIT_MAX_BATCHES];
+    for (uint32_t i = 0; i < coalescer->batch_count; i++) {
+        const struct pv_venus_submit_batch *batch = &coalescer->batches[i];
+        submits[i] = (VkSubmitInfo){
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .pNext = NULL,
+            .waitSemaphoreCount = batch->wait_count,
+            .pWaitSemaphores = &coalescer->semaphores[batch->first_wait],
+            .pWaitDstStageMask = &coalescer->wait_stages[batch->first_wait],
+            .commandBufferCount = batch->command_buffer_count,
+            .pCommandBuffers = &coalescer->command_buffers[batch->first_command_buffer],
+            .signalSemaphoreCount = batch->signal_count,
+            .pSignalSemaphores = &coalescer->semaphores[batch->first_signal],
+        };
+    }
+
+    int result = coalescer->backend.submit(coalescer->backend.user_data, coalescer->queue,
+                                           coalescer->batch_count, submits, coalescer->fence,
+                                           coalescer->stats.guest_submits);
+
+    coalescer->stats.host_submits++;
+    coalescer->stats.flushes[reason]++;
+    if (result != 0) {
+        coalescer->stats.failed_submits++;
+        fprintf(stderr, "[Venus Submit] vkQueueSubmit of %u batches failed\n",
+                coalescer->batch_count);
+    }
+
+    coalescer->batch_count = 0;
+    coalescer->command_buffer_count = 0;
+    coalescer->semaphore_count = 0;
+    coalescer->bytes = 0;
+    coalescer->fence = VK_NULL_HANDLE;
+    coalescer->queue = VK_NULL_HANDLE;
+    return result;
+}
+
+/*
+ * Timer thread: flush batches held longer than the delay budget
+ */
+static void *timer_main(void *arg)
+{
+    struct pv_venus_submit_coalescer *coalescer = arg;
+
+    pthread_mutex_lock(&coalescer->lock);
+    while (!coalescer->stop) {
+        if (coalescer->batch_count == 0) {
+            pthread_cond_wait(&coalescer->wake, &coalescer->lock);
+            continue;
+        }
+
+        uint64_t now = now_ns();
+        uint64_t deadline = coalescer->oldest_ns + coalescer->max_delay_ns;
+        if (now >= deadline) {
+            flush_locked(coalescer, PV_VENUS_SUBMIT_FLUSH_TIMER);
+            continue;
+        }
+
+        /* Timed waits take wall-clock time */
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        uint64_t wait = deadline - now;
+        until.tv_sec += (time_t)(wait / 1000000000ull);
+        until.tv_nsec += (long)(wait % 1000000000ull);
+        if (until.tv_nsec >= 1000000000L) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&coalescer->wake, &coalescer->lock, &until);
+    }
+    pthread_mutex_unlock(&coalescer->lock);
+
+    return NULL;
+}
+
+/*
+ * Coalescer: Initialize
+ */
+int pv_venus_submit_init(struct pv_venus_submit_coalescer *coalescer,
+                         const struct pv_venus_submit_backend *backend,
+                         uint64_t max_bytes,
+                         uint32_t max_delay_us)
+{
+    if (!coalescer || !backend || !backend->submit) {
+        return -1;
+    }
+
+    memset(coalescer, 0, sizeof(*coalescer));
+    coalescer->backend = *backend;
+    coalescer->max_bytes = max_bytes ? max_bytes : PV_VENUS_SUBMIT_MAX_BYTES;
+    coalescer->max_delay_ns =
+        (uint64_t)(max_delay_us ? max_delay_us : PV_VENUS_SUBMIT_MAX_DELAY_US) * 1000;
+
+    if (pthread_mutex_init(&coalescer->lock, NULL) != 0) {
+        return -1;
+    }
+    if (pthread_cond_init(&coalescer->wake, NULL) != 0) {
+        pthread_mutex_destroy(&coalescer->lock);
+        return -1;
+    }
+
+    if (pthread_create(&coalescer->timer, NULL, timer_main, coalescer) != 0) {
+        /* Still correct, batches just wait for the next trigger */
+        fprintf(stderr, "[Venus Submit] Failed to start flush timer\n");
+    } else {
+        coalescer->timer_running = true;
+    }
+    return 0;
+}
+
+/*
+ * Coalescer: Destroy
+ */
+void pv_venus_submit_destroy(struct pv_venus_submit_coalescer *coalescer)
+{
+    if (!coalescer || !coalescer->backend.submit) {
+        return;
+    }
+
+    pthread_mutex_lock(&coalescer->lock);
+    flush_locked(coalescer, PV_VENUS_SUBMIT_FLUSH_EXPLICIT);
+    coalescer->stop = true;
+    pthread_cond_signal(&coalescer->wake);
+    pthread_mutex_unlock(&coalescer->lock);
+
+    if (coalescer->timer_running) {
+        pthread_join(coalescer->timer, NULL);
+    }
+
+    printf("[Venus Submit] Final stats: guest_submits=%llu host_submits=%llu merge_ratio=%.2f\n",
+           coalescer->stats.guest_submits, coalescer->stats.host_submits,
+           pv_venus_submit_merge_ratio(&coalescer->stats));
+
+    free(coalescer->command_buffers);
+    free(coalescer->semaphores);
+    free(coalescer->wait_stages);
+    pthread_cond_destroy(&coalescer->wake);
+    pthread_mutex_destroy(&coalescer->lock);
+    memset(coalescer, 0, sizeof(*coalescer));
+}
+
+/*
+ * Coalescer: Hold a batch
+ */
+int pv_venus_submit_enqueue(struct pv_venus_submit_coalescer *coalescer,
+                            VkQueue queue,
+                            const VkSubmitInfo *batch,
+                            VkFence fence,
+                            size_t bytes,
+                            uint64_t *seqno)
+{
+    if (!coalescer || !batch) {
+        return -1;
+    }
+
+    int result = 0;
+    pthread_mutex_lock(&coalescer->lock);
+
+    /*
+     * Batches for another queue may wait on semaphores signalled by held
+     * ones, so those must reach the driver first; and a submit has room
+     * for one fence.
+     */
+    if (coalescer->batch_count > 0 &&
+        (queue != coalescer->queue || (fence && coalescer->fence) ||
+         coalescer->batch_count == PV_VENUS_SUBMIT_MAX_BATCHES)) {
+        result = flush_locked(coalescer, coalescer->batch_count == PV_VENUS_SUBMIT_MAX_BATCHES
+                                             ? PV_VENUS_SUBMIT_FLUSH_BUDGET
+                                             : PV_VENUS_SUBMIT_FLUSH_ORDERING);
+    }
+
+    uint32_t semaphores = batch->waitSemaphoreCount + batch->signalSemaphoreCount;
+    if (reserve((void **)&coalescer->command_buffers, &coalescer->command_buffer_capacity,
+                coalescer->command_buffer_count + batch->commandBufferCount,
+                sizeof(VkCommandBuffer)) != 0 ||
+        reserve((void **)&coalescer->semaphores, &coalescer->semaphore_capacity,
+                coalescer->semaphore_count + semaphores, sizeof(VkSemaphore)) != 0 ||
+        reserve((void **)&coalescer->wait_stages, &coalescer->wait_stage_capacity,
+                coalescer->semaphore_count + semaphores, sizeof(VkPipelineStageFlags)) != 0) {
+        pthread_mutex_unlock(&coalescer->lock);
+        return -1;
+    }
+
+    struct pv_venus_submit_batch *held = &coalescer->batches[coalescer->batch_count];
+    held->first_command_buffer = coalescer->command_buffer_count;
+    held->command_buffer_count = batch->commandBufferCount;
+    if (batch->commandBufferCount) {
+        memcpy(&coalescer->command_buffers[coalescer->command_buffer_count],
+               batch->pCommandBuffers, batch->commandBufferCount * sizeof(VkCommandBuffer));
+    }
+    coalescer->command_buffer_count += batch->commandBufferCount;
+
+    held->first_wait = coalescer->semaphore_count;
+    held->wait_count = batch->waitSemaphoreCount;
+    if (batch->waitSemaphoreCount) {
+        memcpy(&coalescer->semaphores[held->first_wait], batch->pWaitSemaphores,
+               batch->waitSemaphoreCount * sizeof(VkSemaphore));
+        memcpy(&coalescer->wait_stages[held->first_wait], batch->pWaitDstStageMask,
+               batch->waitSemaphoreCount * sizeof(VkPipelineStageFlags));
+    }
+    coalescer->semaphore_count += batch->waitSemaphoreCount;
+
+    held->first_signal = coalescer->semaphore_count;
+    held->signal_count = batch->signalSemaphoreCount;
+    if (batch->signalSemaphoreCount) {
+        memcpy(&coalescer->semaphores[held->first_signal], batch->pSignalSemaphores,
+               batch->signalSemaphoreCount * sizeof(VkSemaphore));
+    }
+    coalescer->semaphore_count += batch->signalSemaphoreCount;
+
+    if (coalescer->batch_count++ == 0) {
+        coalescer->queue = queue;
+        coalescer->oldest_ns = now_ns();
+        pthread_cond_signal(&coalescer->wake);
+    }
+    if (fence) {
+        coalescer->fence = fence;
+    }
+    coalescer->bytes += bytes;
+    coalescer->stats.guest_submits++;
+    if (seqno) {
+        *seqno = coalescer->stats.guest_submits;
+    }
+
+    if (coalescer->bytes >= coalescer->max_bytes) {
+        if (flush_locked(coalescer, PV_VENUS_SUBMIT_FLUSH_BUDGET) != 0) {
+            result = -1;
+        }
+    }
+
+    pthread_mutex_unlock(&coalescer->lock);
+    return result;
+}
+
+/*
+ * Coalescer: Flush
+ */
+int pv_venus_submit_flush(struct pv_venus_submit_coalescer *coalescer,
+                          enum pv_venus_submit_flush_reason reason)
+{
+    if (!coalescer || reason >= PV_VENUS_SUBMIT_FLUSH_REASON_COUNT) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&coalescer->lock);
+    int result = flush_locked(coalescer, reason);
+    pthread_mutex_unlock(&coalescer->lock);
+    return result;
+}
+
+/*
+ * Coalescer: Get statistics
+ */
+void pv_venus_submit_get_stats(struct pv_venus_submit_coalescer *coalescer,
+                               struct pv_venus_submit_stats *stats)
+{
+    if (!coalescer || !stats) {
+        return;
+    }
+
+    pthread_mutex_lock(&coalescer->lock);
+    *stats = coalescer->stats;
+    pthread_mutex_unlock(&coalescer->lock);
+}
+
+/*
+ * Coalescer: Merge ratio
+ */
+double pv_venus_submit_merge_ratio(const struct pv_venus_submit_stats *stats)
+{
+    if (!stats || stats->host_submits == 0) {
+        return 0.0;
+    }
+    return (double)stats->guest_submits / (double)stats->host_submits;
+}
@@ -5,6 +5,7 @@
  */
 
 #include <stdio.h>
+#include <sys/stat.h>
 #include "pv_moltenvk.h"
 
 int main(int argc, char **argv)
@@ -53,6 +54,26 @@ int main(int argc, char **argv)
     printf("\n--- Test 5: Vulkan Information ---\n");
     pv_moltenvk_print_info(ctx);
 
+    /* Test 6: Pipeline cache persists */
+    printf("\n--- Test 6: Pipeline Cache ---\n");
+    if (!ctx->pipeline_cache) {
+        fprintf(stderr, "No pipeline cache\n");
+        pv_moltenvk_cleanup(ctx);
+        return 1;
+    }
+    if (ctx->pipeline_cache_path) {
+        struct stat st;
+        ctx->pipeline_cache_saved = 0;   /* Force a write even if it was loaded */
+        if (pv_moltenvk_pipeline_cache_flush(ctx, true) != 0 ||
+            stat(ctx->pipeline_cache_path, &st) != 0) {
+            fprintf(stderr, "Failed to write pipeline cache\n");
+            pv_moltenvk_cleanup(ctx);
+            return 1;
+        }
+        printf("Pipeline cache written: %s (%lld bytes)\n",
+               ctx->pipeline_cache_path, (long long)st.st_size);
+    }
+
     /* Cleanup */
     printf("--- Cleanup ---\n");
     pv_moltenvk_cleanup(ctx);
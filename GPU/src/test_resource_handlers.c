@@ -90,10 +90,12 @@ static void test_memory_allocation(void)
     assert(processed == 1);
     
     /* Verify memory was tracked */
-    VkDeviceMemory memory = pv_venus_object_get(&handler_ctx->objects, 0x5000);
-    assert(memory != NULL);
+    struct pv_venus_memory_allocation *memory =
+        pv_venus_object_get(&handler_ctx->objects, 0x5000);
+    assert(memory != NULL && memory->block != NULL);
     
-    printf("  ✓ Memory allocated and tracked: %p\n", (void*)memory);
+    printf("  ✓ Memory allocated and tracked: block %p offset %llu\n",
+           memory->block->memory, (unsigned long long)memory->offset);
     
     /* Cleanup */
     pv_venus_dispatch_destroy(dispatch_ctx);
@@ -0,0 +1,249 @@
+/*
+ * PearVisor - Venus Submit Completion Test
+ *
+ * Fake fences are signalled by the test; the completion thread must
+ * publish guest progress in submit order, recycle its own fences, never
+ * strand a waiter, and mark the context lost at the first failed submit.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "pv_venus_completion.h"
+
+/* A fake fence: 1 = signalled, -1 = device lost */
+struct fake_fence {
+    atomic_int state;
+    atomic_int resets;
+    atomic_int destroyed;
+};
+
+static int fake_wait(void *user_data, void *fence, uint64_t timeout_ns)
+{
+    (void)user_data;
+    struct fake_fence *fake = fence;
+    for (uint64_t waited = 0; waited < timeout_ns; waited += 100000) {
+        int state = atomic_load(&fake->state);
+        if (state != 0) {
+            return state;
+        }
+        usleep(100);
+    }
+    return 0;
+}
+
+static void fake_reset(void *user_data, void *fence)
+{
+    (void)user_data;
+    struct fake_fence *fake = fence;
+    atomic_store(&fake->state, 0);
+    atomic_fetch_add(&fake->resets, 1);
+}
+
+static void fake_destroy(void *user_data, void *fence)
+{
+    (void)user_data;
+    struct fake_fence *fake = fence;
+    atomic_fetch_add(&fake->destroyed, 1);
+}
+
+/* Poll until the tracker reports @seqno, or give up after a second */
+static int wait_completed(struct pv_venus_completion_tracker *tracker, uint64_t seqno)
+{
+    for (int i = 0; i < 1000; i++) {
+        if (pv_venus_completion_completed(tracker) >= seqno) {
+            return 0;
+        }
+        usleep(1000);
+    }
+    return -1;
+}
+
+static void *signal_later(void *arg)
+{
+    usleep(20000);
+    atomic_store(&((struct fake_fence *)arg)->state, 1);
+    return NULL;
+}
+
+int main(void)
+{
+    printf("=== PearVisor Venus Submit Completion Test ===\n\n");
+
+    struct pv_venus_completion_backend backend = {
+        .wait = fake_wait,
+        .reset = fake_reset,
+        .destroy = fake_destroy,
+    };
+    struct pv_venus_completion_tracker tracker;
+    if (pv_venus_completion_init(&tracker, &backend) != 0) {
+        fprintf(stderr, "Init failed\n");
+        return 1;
+    }
+
+    static struct fake_fence fences[8];
+    struct pv_venus_completion_stats stats;
+
+    /* Test 1: Progress is published in order, whatever order fences signal in */
+    printf("--- Test 1: In-Order Publishing ---\n");
+    static _Alignas(64) unsigned char shared[4096];
+    struct pv_venus_completion_page *page = (struct pv_venus_completion_page *)shared;
+    pv_venus_completion_attach_page(&tracker, page, sizeof(shared));
+    if (page->magic != PV_VENUS_COMPLETION_MAGIC) {
+        fprintf(stderr, "Page not stamped\n");
+        return 1;
+    }
+
+    pv_venus_completion_push(&tracker, &fences[0], false, 2);
+    pv_venus_completion_push(&tracker, &fences[1], false, 3);
+    pv_venus_completion_push(&tracker, &fences[2], false, 7);
+    if (atomic_load(&page->submitted) != 7) {
+        fprintf(stderr, "Submitted not published\n");
+        return 1;
+    }
+
+    atomic_store(&fences[2].state, 1);
+    atomic_store(&fences[1].state, 1);
+    usleep(20000);
+    if (atomic_load(&page->completed) != 0) {
+        fprintf(stderr, "Published past an unfinished submit\n");
+        return 1;
+    }
+    atomic_store(&fences[0].state, 1);
+    if (wait_completed(&tracker, 7) != 0 || atomic_load(&page->completed) != 7) {
+        fprintf(stderr, "Completion not published\n");
+        return 1;
+    }
+    printf("  completed=%llu after the oldest fence signalled\n",
+           (unsigned long long)atomic_load(&page->completed));
+
+    /* The guest can't rewind what the host believes */
+    atomic_store(&page->completed, 0);
+    if (pv_venus_completion_completed(&tracker) != 7) {
+        fprintf(stderr, "Host trusted a guest write\n");
+        return 1;
+    }
+
+    /* Test 2: Owned fences come back reset; borrowed ones don't */
+    printf("\n--- Test 2: Fence Recycling ---\n");
+    if (pv_venus_completion_take_fence(&tracker) != NULL) {
+        fprintf(stderr, "Borrowed fence was pooled\n");
+        return 1;
+    }
+    atomic_store(&fences[3].state, 1);
+    pv_venus_completion_push(&tracker, &fences[3], true, 8);
+    wait_completed(&tracker, 8);
+    if (pv_venus_completion_take_fence(&tracker) != &fences[3] ||
+        atomic_load(&fences[3].resets) != 1 || atomic_load(&fences[3].state) != 0) {
+        fprintf(stderr, "Owned fence not recycled\n");
+        return 1;
+    }
+    printf("  owned fence reset and reused\n");
+
+    /* Test 3: A host wait blocks only until its submit lands */
+    printf("\n--- Test 3: Host Wait ---\n");
+    pv_venus_completion_push(&tracker, &fences[4], false, 9);
+    pthread_t thread;
+    pthread_create(&thread, NULL, signal_later, &fences[4]);
+    pv_venus_completion_wait(&tracker, 9);
+    pthread_join(thread, NULL);
+    if (pv_venus_completion_completed(&tracker) < 9) {
+        fprintf(stderr, "Wait returned early\n");
+        return 1;
+    }
+    /* Nothing in flight: a seqno never submitted must not hang */
+    pv_venus_completion_wait(&tracker, 1000);
+    printf("  waited for submit 9\n");
+
+    /* Test 4: A failed wait or submit publishes in order, and loses the context */
+    printf("\n--- Test 4: Lost Context ---\n");
+    struct pv_venus_completion_tracker lost;
+    static _Alignas(64) unsigned char lost_shared[256];
+    struct pv_venus_completion_page *lost_page = (struct pv_venus_completion_page *)lost_shared;
+    static struct fake_fence lost_fences[2];
+    if (pv_venus_completion_init(&lost, &backend) != 0 ||
+        pv_venus_completion_attach_page(&lost, lost_page, sizeof(lost_shared)) != 0) {
+        fprintf(stderr, "Init failed\n");
+        return 1;
+    }
+    pv_venus_completion_push(&lost, &lost_fences[0], false, 1);
+    pv_venus_completion_push_failed(&lost, 2);           /* The driver refused it */
+    atomic_store(&lost_fences[1].state, -1);
+    pv_venus_completion_push(&lost, &lost_fences[1], true, 3);
+    usleep(20000);
+    if (atomic_load(&lost_page->completed) != 0 || pv_venus_completion_failed(&lost) != 0) {
+        fprintf(stderr, "Failed submit jumped the queue\n");
+        return 1;
+    }
+    atomic_store(&lost_fences[0].state, 1);
+    if (wait_completed(&lost, 3) != 0 || atomic_load(&lost_fences[1].destroyed) != 1) {
+        fprintf(stderr, "Lost submits stranded their waiters\n");
+        return 1;
+    }
+    if (atomic_load(&lost_page->failed) != 2 || pv_venus_completion_failed(&lost) != 2 ||
+        pv_venus_completion_wait_timeout(&lost, 3, 0) != -1) {
+        fprintf(stderr, "Context not marked lost at submit 2\n");
+        return 1;
+    }
+    pv_venus_completion_get_stats(&lost, &stats);
+    pv_venus_completion_destroy(&lost);
+    if (stats.errors != 2) {
+        fprintf(stderr, "Expected 2 errors, got %llu\n", stats.errors);
+        return 1;
+    }
+    printf("  published to 3, lost at submit 2\n");
+
+    /* Test 5: Fence slots, and waits with a timeout */
+    printf("\n--- Test 5: Fence Slots ---\n");
+    uint32_t slots = page->fence_slot_count;
+    if (slots != (sizeof(shared) - sizeof(*page)) / sizeof(uint64_t) ||
+        atomic_load(&page->fences[slots - 1]) != PV_VENUS_FENCE_UNSIGNALED) {
+        fprintf(stderr, "Fence slots not set up\n");
+        return 1;
+    }
+    pv_venus_completion_set_fence(&tracker, 3, 12);
+    pv_venus_completion_set_fence(&tracker, slots, 12);     /* Past the end: ignored */
+    pv_venus_completion_push(&tracker, &fences[7], false, 12);
+    /* What the guest checks without a round trip */
+    if (atomic_load(&page->fences[3]) <= atomic_load(&page->completed)) {
+        fprintf(stderr, "Fence signalled early\n");
+        return 1;
+    }
+    if (pv_venus_completion_wait_timeout(&tracker, 12, 5 * 1000 * 1000) != 1) {
+        fprintf(stderr, "Wait didn't time out\n");
+        return 1;
+    }
+    pthread_create(&thread, NULL, signal_later, &fences[7]);
+    if (pv_venus_completion_wait_timeout(&tracker, 12, 5000ull * 1000 * 1000) != 0 ||
+        atomic_load(&page->fences[3]) > atomic_load(&page->completed)) {
+        fprintf(stderr, "Fence never signalled\n");
+        return 1;
+    }
+    pthread_join(thread, NULL);
+    printf("  slot 3 signalled by submit 12\n");
+
+    /* Test 6: Destroy finishes what is in flight */
+    printf("\n--- Test 6: Destroy ---\n");
+    pv_venus_completion_push(&tracker, &fences[6], true, 13);
+    pthread_create(&thread, NULL, signal_later, &fences[6]);
+
+    pv_venus_completion_get_stats(&tracker, &stats);
+    pv_venus_completion_destroy(&tracker);
+    pthread_join(thread, NULL);
+    if (atomic_load(&page->completed) != 13 || atomic_load(&fences[6].destroyed) != 1) {
+        fprintf(stderr, "Destroy didn't drain\n");
+        return 1;
+    }
+    printf("  submissions=%llu errors=%llu host_waits=%llu\n",
+           stats.submissions, stats.errors, stats.host_waits);
+    if (stats.submissions != 7 || stats.errors != 0 || stats.host_waits != 3) {
+        fprintf(stderr, "Wrong statistics\n");
+        return 1;
+    }
+
+    printf("\n=== All Tests Passed! ===\n");
+    return 0;
+}
@@ -60,6 +60,49 @@ static int handle_create_device(
     return 0;
 }
 
+/* Ring under test, for handlers that inspect ring state */
+static struct pv_venus_ring *test_ring;
+static uint32_t head_updates_seen;
+static uint32_t last_head_seen;
+
+static int handle_draw_check_head(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    (void)context;
+    (void)header;
+    (void)data;
+    (void)data_size;
+    
+    /* Count head movements the guest could observe mid-drain */
+    uint32_t head = pv_venus_ring_get_head(test_ring);
+    if (head != last_head_seen) {
+        head_updates_seen++;
+        last_head_seen = head;
+    }
+    return 0;
+}
+
+/* Handler that takes scratch from the ring arena, as vkQueueSubmit does */
+static int handle_draw_arena(
+    void *context,
+    const struct pv_venus_command_header *header,
+    const void *data,
+    size_t data_size)
+{
+    (void)context;
+    (void)header;
+    
+    uint8_t *scratch = pv_venus_ring_arena_alloc(pv_venus_dispatch_arena(), 1024, 0);
+    if (!scratch) {
+        return -1;
+    }
+    memcpy(scratch, data, data_size);
+    return 0;
+}
+
 /*
  * Write a mock Venus command to the ring buffer
  */
@@ -203,7 +246,13 @@ int main(int argc, char **argv)
     
     ret = pv_venus_decode_command(ring, ctx);
     printf("Decode result (should fail): %d\n", ret);
-    pv_venus_ring_set_head(ring, ring->buffer.current_pos);
+    if (ret != PV_VENUS_DECODE_FRAMING_ERROR ||
+        !(atomic_load(ring->control.status) & PV_VENUS_RING_STATUS_ERROR)) {
+        fprintf(stderr, "Bad header did not put the ring in error\n");
+        return 1;
+    }
+    atomic_fetch_and(ring->control.status, ~PV_VENUS_RING_STATUS_ERROR);   /* Guest reset */
+    pv_venus_ring_recover(ring);
 
     /* Test 6: Check statistics */
     printf("\n--- Test 6: Statistics ---\n");
@@ -211,6 +260,180 @@ int main(int argc, char **argv)
     printf("Commands unknown: %llu\n", ctx->commands_unknown);
     printf("Commands failed: %llu\n", ctx->commands_failed);
 
+    /* Test 7: Batched head publication */
+    printf("\n--- Test 7: Batched Head Publication ---\n");
+    test_ring = ring;
+    last_head_seen = pv_venus_ring_get_head(ring);
+    pv_venus_dispatch_register(ctx, PV_VK_COMMAND_vkCmdDraw, handle_draw_check_head);
+    ring->head_batch_bytes = 0;
+    ring->head_batch_commands = 4;
+    
+    for (int i = 0; i < 16; i++) {
+        write_mock_command(ring, PV_VK_COMMAND_vkCmdDraw, payload, 24);
+    }
+    processed = pv_venus_decode_all(ring, ctx);
+    printf("Processed %d commands, head moved %u times mid-drain\n",
+           processed, head_updates_seen);
+    if (processed != 16 || head_updates_seen != 3 ||
+        pv_venus_ring_get_head(ring) != ring->buffer.current_pos) {
+        fprintf(stderr, "Head was not published in batches\n");
+        return 1;
+    }
+
+    /* Test 8: Ring thread drives the decoder */
+    printf("\n--- Test 8: Ring Thread Dispatch ---\n");
+    uint64_t dispatched_before = ctx->commands_dispatched;
+    ring->dispatch_context = ctx;
+    if (pv_venus_ring_start(ring) != 0) {
+        fprintf(stderr, "Failed to start ring\n");
+        return 1;
+    }
+    
+    for (int i = 0; i < 32; i++) {
+        write_mock_command(ring, PV_VK_COMMAND_vkCmdDraw, payload, 40);
+        pv_venus_ring_notify(ring);
+    }
+    
+    for (int i = 0; i < 100 && 
+         pv_venus_ring_get_head(ring) != pv_venus_ring_get_tail(ring); i++) {
+        usleep(10000);
+    }
+    pv_venus_ring_stop(ring);
+    
+    printf("Thread dispatched %llu commands\n",
+           ctx->commands_dispatched - dispatched_before);
+    if (ctx->commands_dispatched - dispatched_before != 32) {
+        fprintf(stderr, "Ring thread did not dispatch all commands\n");
+        return 1;
+    }
+
+    /* Test 9: Latency histograms */
+    printf("\n--- Test 9: Latency Histograms ---\n");
+    for (uint64_t ns = 0; ns < (1ull << 20); ns = ns * 3 / 2 + 1) {
+        uint32_t bucket = pv_venus_latency_bucket(ns);
+        if (ns > pv_venus_latency_bucket_limit(bucket) ||
+            (bucket > 0 && ns <= pv_venus_latency_bucket_limit(bucket - 1))) {
+            fprintf(stderr, "Sample %llu outside bucket %u\n",
+                    (unsigned long long)ns, bucket);
+            return 1;
+        }
+    }
+
+    struct pv_venus_command_latency *latency = malloc(sizeof(*latency));
+    uint64_t samples = pv_venus_dispatch_latency(ctx, PV_VK_COMMAND_vkCmdDraw, latency);
+    struct pv_venus_latency_summary dispatch = pv_venus_latency_summarize(&latency->dispatch);
+    struct pv_venus_latency_summary queue = pv_venus_latency_summarize(&latency->queue);
+    printf("vkCmdDraw: samples=%llu dispatch p50=%lluns p99=%lluns, queue p50=%lluns p99=%lluns\n",
+           samples, dispatch.p50_ns, dispatch.p99_ns, queue.p50_ns, queue.p99_ns);
+
+    /* Main thread and ring thread each recorded into their own table */
+    int tables = 0;
+    for (struct pv_venus_latency_table *t = atomic_load(&ctx->latency_tables); t; t = t->next) {
+        tables++;
+    }
+    if (samples < 32 || latency->queue.count != samples || tables != 2 ||
+        dispatch.p50_ns > dispatch.max_ns ||
+        pv_venus_dispatch_latency(ctx, PV_VK_COMMAND_vkCreateFence, latency) != 0) {
+        fprintf(stderr, "Unexpected latency snapshot (tables=%d)\n", tables);
+        free(latency);
+        return 1;
+    }
+    free(latency);
+
+    /* Test 10: Bad framing stops the drain instead of decoding garbage */
+    printf("\n--- Test 10: Framing Errors ---\n");
+    struct {
+        uint32_t command_id;
+        uint32_t command_size;
+        uint32_t published;       /* Bytes of the command the guest publishes */
+    } bad[] = {
+        { 9999, 28, 28 },                               /* Unknown command */
+        { PV_VK_COMMAND_vkCmdDraw, 2048, 64 },          /* Runs past the tail */
+        { PV_VK_COMMAND_vkCmdDraw, 4 << 20, 64 },       /* Oversize */
+        { PV_VK_COMMAND_vkCmdDraw, 8, 4 },              /* Truncated header */
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        uint32_t start = pv_venus_ring_get_tail(ring);
+        struct pv_venus_command_header header = { bad[i].command_id, bad[i].command_size };
+        memset((void *)ring->buffer.data, 0xAB, ring->buffer.size);
+        memcpy((void *)(ring->buffer.data + (start & ring->buffer.mask)), &header,
+               sizeof(header));
+        atomic_store((atomic_uint *)ring->control.tail, start + bad[i].published);
+
+        uint64_t failed_before = ctx->commands_failed;
+        processed = pv_venus_decode_all(ring, ctx);
+        if (processed != 0 || ctx->commands_failed != failed_before + 1 ||
+            !(atomic_load(ring->control.status) & PV_VENUS_RING_STATUS_ERROR) ||
+            pv_venus_ring_seq_before(start + bad[i].published, ring->buffer.current_pos)) {
+            fprintf(stderr, "Bad command %zu: processed=%d failed=%llu\n", i, processed,
+                    ctx->commands_failed - failed_before);
+            return 1;
+        }
+
+        /* Nothing resumes until the guest clears the error */
+        if (pv_venus_ring_recover(ring)) {
+            fprintf(stderr, "Bad command %zu: recovered while in error\n", i);
+            return 1;
+        }
+
+        /* Guest resets: the host skips to its tail and publishes it as head */
+        uint64_t recoveries = ring->stats.recoveries;
+        atomic_fetch_and(ring->control.status, ~PV_VENUS_RING_STATUS_ERROR);
+        if (!pv_venus_ring_recover(ring) ||
+            ring->buffer.current_pos != start + bad[i].published ||
+            pv_venus_ring_get_head(ring) != start + bad[i].published ||
+            ring->stats.recoveries != recoveries + 1 || ring->framing_lost ||
+            !pv_venus_ring_recover(ring) || ring->stats.recoveries != recoveries + 1) {
+            fprintf(stderr, "Bad command %zu: reset not honoured\n", i);
+            return 1;
+        }
+    }
+    printf("4 malformed commands each stopped the drain until the guest reset\n");
+
+    /* Test 11: A new context never inherits the last one's latency table */
+    printf("\n--- Test 11: Context Reuse ---\n");
+    pv_venus_dispatch_destroy(ctx);
+    ctx = pv_venus_dispatch_create();       /* Often at the same address */
+    if (!ctx) {
+        fprintf(stderr, "Failed to recreate dispatch context\n");
+        return 1;
+    }
+    pv_venus_dispatch_register(ctx, PV_VK_COMMAND_vkCreateInstance, handle_create_instance);
+    write_mock_command(ring, PV_VK_COMMAND_vkCreateInstance, NULL, 0);
+    processed = pv_venus_decode_all(ring, ctx);
+
+    latency = malloc(sizeof(*latency));
+    tables = 0;
+    for (struct pv_venus_latency_table *t = atomic_load(&ctx->latency_tables); t; t = t->next) {
+        tables++;
+    }
+    if (processed != 1 || tables != 1 ||
+        pv_venus_dispatch_latency(ctx, PV_VK_COMMAND_vkCreateInstance, latency) != 1) {
+        fprintf(stderr, "Recorded into a stale table (tables=%d)\n", tables);
+        free(latency);
+        return 1;
+    }
+    free(latency);
+    printf("Fresh context recorded into its own table\n");
+
+    /* Test 12: Handler scratch comes from the ring arena and lasts one drain */
+    printf("\n--- Test 12: Ring Arena ---\n");
+    pv_venus_dispatch_register(ctx, PV_VK_COMMAND_vkCmdDraw, handle_draw_arena);
+    for (int i = 0; i < 3; i++) {
+        write_mock_command(ring, PV_VK_COMMAND_vkCmdDraw, payload, 24);
+    }
+    uint64_t failed_before = ctx->commands_failed;
+    processed = pv_venus_decode_all(ring, ctx);
+    printf("allocations=%llu high_water=%zu offset=%zu\n",
+           (unsigned long long)ring->arena.allocations, ring->arena.high_water,
+           ring->arena.offset);
+    if (processed != 3 || ctx->commands_failed != failed_before ||
+        ring->arena.allocations != 3 || ring->arena.high_water < 3 * 1024 ||
+        ring->arena.offset != 0 || pv_venus_dispatch_arena() != NULL) {
+        fprintf(stderr, "Arena not used per drain\n");
+        return 1;
+    }
+
     /* Cleanup */
     printf("\n--- Cleanup ---\n");
     pv_venus_dispatch_destroy(ctx);
@@ -26,7 +26,8 @@ static void test_shared_memory_ring(void) {
     printf("Allocated %zu bytes at %p\n", size, memory);
     
     /* Create ring buffer from memory */
-    struct pv_venus_ring *ring = pv_venus_ring_create_from_memory(memory, (uint32_t)size);
+    struct pv_venus_ring *ring = pv_venus_ring_create_from_memory(memory, (uint32_t)size,
+                                                                 PV_VENUS_RING_LAYOUT_ISOLATED, 0);
     assert(ring != NULL);
     printf("  ✓ Ring buffer created from shared memory\n");
     
@@ -82,7 +83,8 @@ static void test_integration_flow(void) {
     printf("Step 1: Allocated shared memory (%zu bytes)\n", size);
     
     /* Step 2: Create ring buffer */
-    struct pv_venus_ring *ring = pv_venus_ring_create_from_memory(memory, (uint32_t)size);
+    struct pv_venus_ring *ring = pv_venus_ring_create_from_memory(memory, (uint32_t)size,
+                                                                 PV_VENUS_RING_LAYOUT_ISOLATED, 0);
     assert(ring != NULL);
     printf("Step 2: Created ring buffer\n");
     
@@ -162,7 +164,8 @@ static void test_ring_notification(void) {
     assert(memory != NULL);
     memset(memory, 0, size);
     
-    struct pv_venus_ring *ring = pv_venus_ring_create_from_memory(memory, (uint32_t)size);
+    struct pv_venus_ring *ring = pv_venus_ring_create_from_memory(memory, (uint32_t)size,
+                                                                 PV_VENUS_RING_LAYOUT_ISOLATED, 0);
     void *ctx = pv_venus_init();
     pv_venus_integration_start(ring, ctx);
     
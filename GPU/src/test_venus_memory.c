@@ -0,0 +1,262 @@
+/*
+ * PearVisor - Venus Memory Suballocator Test
+ *
+ * Test program to verify device memory suballocation against a fake
+ * backend that tracks every host allocation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pv_venus_memory.h"
+
+#define BLOCK_SIZE (4u * 1024 * 1024)
+#define ALIGNMENT  4096u
+
+/* Fake backend: host handles are heap blocks; count what is live */
+static int live_blocks;
+static int zeroed_blocks;
+
+static int fake_allocate(void *user_data, uint32_t memory_type, uint64_t size, void **memory)
+{
+    (void)user_data;
+    (void)memory_type;
+    *memory = malloc(size);
+    live_blocks++;
+    return *memory ? 0 : -1;
+}
+
+static int fake_zero(void *user_data, uint32_t memory_type, void *memory, uint64_t size)
+{
+    (void)user_data;
+    (void)memory_type;
+    memset(memory, 0, size);
+    zeroed_blocks++;
+    return 0;
+}
+
+/* Whether @size bytes at @memory are all zero */
+static int is_zero(const unsigned char *memory, uint64_t size)
+{
+    for (uint64_t i = 0; i < size; i++) {
+        if (memory[i] != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void fake_free(void *user_data, uint32_t memory_type, void *memory)
+{
+    (void)user_data;
+    (void)memory_type;
+    free(memory);
+    live_blocks--;
+}
+
+/* Two allocations in one block must not overlap */
+static int overlaps(const struct pv_venus_memory_allocation *a,
+                    const struct pv_venus_memory_allocation *b)
+{
+    return a->block == b->block &&
+           a->offset < b->offset + b->size && b->offset < a->offset + a->size;
+}
+
+int main(void)
+{
+    printf("=== PearVisor Venus Memory Suballocator Test ===\n\n");
+
+    struct pv_venus_memory_backend backend = {
+        .allocate = fake_allocate,
+        .free = fake_free,
+    };
+    struct pv_venus_memory_allocator allocator;
+    if (pv_venus_memory_allocator_init(&allocator, &backend, BLOCK_SIZE, ALIGNMENT) != 0) {
+        fprintf(stderr, "Init failed\n");
+        return 1;
+    }
+
+    /* Test 1: Many small allocations share a few blocks */
+    printf("--- Test 1: Small Allocations ---\n");
+    enum { SMALL = 1000 };
+    static struct pv_venus_memory_allocation *small[SMALL];
+    for (int i = 0; i < SMALL; i++) {
+        small[i] = pv_venus_memory_alloc(&allocator, 0, 1 + (i * 997) % (64 * 1024));
+        if (!small[i] || small[i]->offset % ALIGNMENT != 0 || !small[i]->slab) {
+            fprintf(stderr, "Small allocation %d failed\n", i);
+            return 1;
+        }
+    }
+    for (int i = 0; i < SMALL; i++) {
+        for (int j = i + 1; j < SMALL; j++) {
+            if (overlaps(small[i], small[j])) {
+                fprintf(stderr, "Allocations %d and %d overlap\n", i, j);
+                return 1;
+            }
+        }
+    }
+    printf("  %d allocations in %d host blocks\n", SMALL, live_blocks);
+    if (live_blocks > 16) {
+        fprintf(stderr, "Too many host allocations\n");
+        return 1;
+    }
+
+    /* Test 2: Large allocations (TLSF) and coalescing */
+    printf("\n--- Test 2: Large Allocations ---\n");
+    for (int i = 0; i < SMALL; i++) {
+        pv_venus_memory_free(&allocator, small[i]);
+    }
+    if (live_blocks != 1) {
+        fprintf(stderr, "Expected one spare block after freeing, have %d\n", live_blocks);
+        return 1;
+    }
+
+    struct pv_venus_memory_allocation *large[8];
+    for (int i = 0; i < 8; i++) {
+        large[i] = pv_venus_memory_alloc(&allocator, 1, 300 * 1024 + i);
+        if (!large[i] || large[i]->slab || !large[i]->range ||
+            large[i]->offset % ALIGNMENT != 0) {
+            fprintf(stderr, "Large allocation %d failed\n", i);
+            return 1;
+        }
+    }
+    for (int i = 0; i < 8; i++) {
+        for (int j = i + 1; j < 8; j++) {
+            if (overlaps(large[i], large[j])) {
+                fprintf(stderr, "Large allocations %d and %d overlap\n", i, j);
+                return 1;
+            }
+        }
+    }
+
+    /* Free every other one, then the rest: neighbours must merge back into one range */
+    struct pv_venus_memory_block *block = large[0]->block;
+    for (int i = 0; i < 8; i += 2) {
+        pv_venus_memory_free(&allocator, large[i]);
+    }
+    for (int i = 1; i < 8; i += 2) {
+        pv_venus_memory_free(&allocator, large[i]);
+    }
+    struct pv_venus_memory_allocation *half =
+        pv_venus_memory_alloc(&allocator, 1, BLOCK_SIZE / 2);
+    if (!half || half->block != block) {
+        fprintf(stderr, "Free ranges did not coalesce\n");
+        return 1;
+    }
+    printf("  freed ranges coalesced, %d host blocks\n", live_blocks);
+    pv_venus_memory_free(&allocator, half);
+
+    /* Test 3: Dedicated allocations */
+    printf("\n--- Test 3: Dedicated Allocations ---\n");
+    int before = live_blocks;
+    struct pv_venus_memory_allocation *big =
+        pv_venus_memory_alloc(&allocator, 2, BLOCK_SIZE);
+    if (!big || !big->block->dedicated || big->offset != 0 || live_blocks != before + 1) {
+        fprintf(stderr, "Dedicated allocation failed\n");
+        return 1;
+    }
+    pv_venus_memory_free(&allocator, big);
+    if (live_blocks != before) {
+        fprintf(stderr, "Dedicated block not released\n");
+        return 1;
+    }
+
+    /* Test 4: Churn keeps the host allocation count flat */
+    printf("\n--- Test 4: Churn ---\n");
+    struct pv_venus_memory_allocation *live[64] = { 0 };
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+    for (int i = 0; i < 100000; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        int slot = (int)(rng % 64);
+        pv_venus_memory_free(&allocator, live[slot]);
+        live[slot] = pv_venus_memory_alloc(&allocator, 0, 1 + (rng >> 20) % (1024 * 1024));
+        if (!live[slot]) {
+            fprintf(stderr, "Churn allocation %d failed\n", i);
+            return 1;
+        }
+    }
+    for (int i = 0; i < 64; i++) {
+        for (int j = i + 1; j < 64; j++) {
+            if (overlaps(live[i], live[j])) {
+                fprintf(stderr, "Churned allocations %d and %d overlap\n", i, j);
+                return 1;
+            }
+        }
+    }
+
+    struct pv_venus_memory_stats stats;
+    pv_venus_memory_get_stats(&allocator, &stats);
+    printf("  allocations=%llu host_allocations=%llu blocks=%llu\n",
+           stats.allocations, stats.host_allocations, stats.blocks);
+    if (stats.host_allocations > stats.allocations / 100) {
+        fprintf(stderr, "Churn hit the backend too often\n");
+        return 1;
+    }
+
+    for (int i = 0; i < 64; i++) {
+        pv_venus_memory_free(&allocator, live[i]);
+    }
+    pv_venus_memory_trim(&allocator);
+    pv_venus_memory_get_stats(&allocator, &stats);
+    if (live_blocks != 0 || stats.bytes_in_use != 0) {
+        fprintf(stderr, "Trim left %d blocks\n", live_blocks);
+        return 1;
+    }
+
+    pv_venus_memory_allocator_destroy(&allocator);
+
+    /* Test 5: Freed blocks are scrubbed in the background and reused */
+    printf("\n--- Test 5: Recycling ---\n");
+    backend.zero = fake_zero;
+    if (pv_venus_memory_allocator_init(&allocator, &backend, BLOCK_SIZE, ALIGNMENT) != 0) {
+        fprintf(stderr, "Init with recycler failed\n");
+        return 1;
+    }
+
+    struct pv_venus_memory_allocation *dirty =
+        pv_venus_memory_alloc(&allocator, 3, BLOCK_SIZE);
+    if (!dirty) {
+        fprintf(stderr, "Dedicated allocation failed\n");
+        return 1;
+    }
+    void *host_memory = dirty->block->memory;
+    memset(host_memory, 0xAB, BLOCK_SIZE);
+    pv_venus_memory_free(&allocator, dirty);
+    pv_venus_memory_wait_idle(&allocator);
+
+    pv_venus_memory_get_stats(&allocator, &stats);
+    if (stats.scrubbed != 1 || stats.pool_blocks != 1 || live_blocks != 1) {
+        fprintf(stderr, "Freed block not pooled (scrubbed=%llu pool=%llu)\n",
+                stats.scrubbed, stats.pool_blocks);
+        return 1;
+    }
+
+    struct pv_venus_memory_allocation *reused =
+        pv_venus_memory_alloc(&allocator, 3, BLOCK_SIZE);
+    pv_venus_memory_get_stats(&allocator, &stats);
+    if (!reused || reused->block->memory != host_memory || stats.recycled != 1 ||
+        stats.host_allocations != 1 || !is_zero(host_memory, BLOCK_SIZE)) {
+        fprintf(stderr, "Scrubbed block not reused\n");
+        return 1;
+    }
+    printf("  block scrubbed and reused without a host allocation\n");
+
+    /* A different size can't use it */
+    struct pv_venus_memory_allocation *other =
+        pv_venus_memory_alloc(&allocator, 3, BLOCK_SIZE - ALIGNMENT);
+    pv_venus_memory_free(&allocator, reused);
+    pv_venus_memory_free(&allocator, other);
+    pv_venus_memory_trim(&allocator);
+    if (live_blocks != 0 || zeroed_blocks != 3) {
+        fprintf(stderr, "Trim left %d blocks, scrubbed %d\n", live_blocks, zeroed_blocks);
+        return 1;
+    }
+    printf("  trim scrubbed and released %d blocks\n", zeroed_blocks - 1);
+
+    pv_venus_memory_allocator_destroy(&allocator);
+
+    printf("\n=== All Tests Passed! ===\n");
+    return 0;
+}
@@ -0,0 +1,323 @@
+/*
+ * PearVisor - Venus Object Table Test
+ *
+ * Test program to verify the guest ID → host handle table
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "pv_venus_objects.h"
+
+#define HANDLE(i) ((void *)(uintptr_t)(0x1000 + (i)))
+
+#define STABLE_OBJECTS 1000
+
+static atomic_bool writer_done;
+
+/* Reader for Test 6: stable objects must always resolve to their handle */
+static void *reader_thread(void *arg)
+{
+    struct pv_venus_object_table *table = arg;
+    uintptr_t errors = 0;
+
+    while (!atomic_load(&writer_done)) {
+        for (size_t i = 0; i < STABLE_OBJECTS; i++) {
+            errors += pv_venus_object_get(table, 0x100000 + i) != HANDLE(i);
+        }
+    }
+
+    return (void *)errors;
+}
+
+int main(void)
+{
+    printf("=== PearVisor Venus Object Table Test ===\n\n");
+
+    struct pv_venus_object_table table;
+
+    /* Test 1: Sizing */
+    printf("--- Test 1: Table Sizing ---\n");
+    if (pv_venus_object_table_init(&table, 100) != 0 ||
+        PV_VENUS_OBJECT_TABLE_MAX_LOAD(table.index->capacity) < 100 ||
+        (table.index->capacity & table.index->mask) != 0) {
+        fprintf(stderr, "Bad table size\n");
+        return 1;
+    }
+    printf("  100 objects -> %zu slots\n", table.index->capacity);
+
+    /* Test 2: Fill to the load limit */
+    printf("\n--- Test 2: Add / Get ---\n");
+    size_t limit = PV_VENUS_OBJECT_TABLE_MAX_LOAD(table.index->capacity);
+    for (size_t i = 0; i < limit; i++) {
+        if (pv_venus_object_add(&table, i * 0x1000, HANDLE(i),
+                                PV_VENUS_OBJECT_TYPE_BUFFER) != 0) {
+            fprintf(stderr, "Add %zu failed\n", i);
+            return 1;
+        }
+    }
+    if (table.grows != 0) {
+        fprintf(stderr, "Grew before reaching the load limit\n");
+        return 1;
+    }
+    for (size_t i = 0; i < limit; i++) {
+        if (pv_venus_object_get(&table, i * 0x1000) != HANDLE(i)) {
+            fprintf(stderr, "Get %zu failed\n", i);
+            return 1;
+        }
+    }
+
+    /* Re-adding a live ID, as any type, fails and leaves the original intact */
+    pv_venus_object_handle original = pv_venus_object_lookup(&table, 0);
+    if (pv_venus_object_add(&table, 0, HANDLE(999), PV_VENUS_OBJECT_TYPE_IMAGE) == 0 ||
+        pv_venus_object_add(&table, 0, HANDLE(998),
+                            pv_venus_object_handle_type(original)) == 0 ||
+        table.count != limit || pv_venus_object_get(&table, 0) != HANDLE(0) ||
+        pv_venus_object_lookup(&table, 0) != original) {
+        fprintf(stderr, "Live ID was rebound\n");
+        return 1;
+    }
+    printf("  %zu objects added and found\n", limit);
+
+    /* Test 3: Removal keeps every probe run intact (no tombstones) */
+    printf("\n--- Test 3: Remove ---\n");
+    for (size_t i = 0; i < limit; i += 2) {
+        pv_venus_object_remove(&table, i * 0x1000);
+    }
+    pv_venus_object_remove(&table, 0xdead0000);
+    for (size_t i = 0; i < limit; i++) {
+        void *expected = (i % 2) ? HANDLE(i) : NULL;
+        if (pv_venus_object_get(&table, i * 0x1000) != expected) {
+            fprintf(stderr, "Lookup %zu wrong after removals\n", i);
+            return 1;
+        }
+    }
+
+    size_t used = 0;
+    for (size_t i = 0; i < table.index->capacity; i++) {
+        used += table.index->objects[i].handle != PV_VENUS_OBJECT_HANDLE_NULL;
+    }
+    if (used != table.count || table.count != limit / 2) {
+        fprintf(stderr, "Count mismatch: slots=%zu count=%zu\n", used, table.count);
+        return 1;
+    }
+    printf("  %zu objects left, %zu slots in use\n", table.count, used);
+
+    pv_venus_object_table_destroy(&table);
+
+    /* Test 4: Incremental grow and shrink */
+    printf("\n--- Test 4: Grow / Shrink ---\n");
+    const size_t total = 100000;
+    pv_venus_object_table_init(&table, 0);
+    size_t min_capacity = table.index->capacity;
+
+    for (size_t i = 0; i < total; i++) {
+        if (pv_venus_object_add(&table, i, HANDLE(i), PV_VENUS_OBJECT_TYPE_IMAGE) != 0) {
+            fprintf(stderr, "Add %zu failed while growing\n", i);
+            return 1;
+        }
+        /* Objects stay reachable in whichever array holds them */
+        if (pv_venus_object_get(&table, i / 2) != HANDLE(i / 2)) {
+            fprintf(stderr, "Object %zu lost during resize\n", i / 2);
+            return 1;
+        }
+    }
+    printf("  %zu objects: %zu slots, grows=%llu\n",
+           table.count, table.index->capacity, table.grows);
+
+    for (size_t i = 0; i < total; i++) {
+        if (i % 1000 != 0) {
+            pv_venus_object_remove(&table, i);
+        }
+    }
+    for (size_t i = 0; i < total; i++) {
+        void *expected = (i % 1000 == 0) ? HANDLE(i) : NULL;
+        if (pv_venus_object_get(&table, i) != expected) {
+            fprintf(stderr, "Lookup %zu wrong after shrinking\n", i);
+            return 1;
+        }
+    }
+    printf("  %zu objects: %zu slots, shrinks=%llu\n",
+           table.count, table.index->capacity, table.shrinks);
+
+    if (table.count != total / 1000 || table.shrinks == 0 ||
+        table.index->capacity >= total || table.index->capacity < min_capacity) {
+        fprintf(stderr, "Table did not shrink\n");
+        return 1;
+    }
+
+    pv_venus_object_table_destroy(&table);
+
+    /* Test 5: Slot map handles */
+    printf("\n--- Test 5: Slot Map Handles ---\n");
+    pv_venus_object_table_init(&table, 0);
+    for (size_t i = 0; i < 64; i++) {
+        pv_venus_object_add(&table, 0x6000 + i, HANDLE(i), PV_VENUS_OBJECT_TYPE_BUFFER);
+        pv_venus_object_add(&table, 0x7000 + i, HANDLE(100 + i), PV_VENUS_OBJECT_TYPE_IMAGE);
+    }
+
+    pv_venus_object_handle buffer = pv_venus_object_lookup(&table, 0x6005);
+    if (pv_venus_object_handle_type(buffer) != PV_VENUS_OBJECT_TYPE_BUFFER ||
+        pv_venus_object_resolve(&table, buffer) != HANDLE(5)) {
+        fprintf(stderr, "Handle does not resolve\n");
+        return 1;
+    }
+
+    /* A handle outliving its object is rejected, even once the slot is reused */
+    pv_venus_object_remove(&table, 0x6005);
+    if (pv_venus_object_resolve(&table, buffer) != NULL) {
+        fprintf(stderr, "Stale handle resolved after remove\n");
+        return 1;
+    }
+    pv_venus_object_add(&table, 0x6100, HANDLE(200), PV_VENUS_OBJECT_TYPE_BUFFER);
+    pv_venus_object_handle reused = pv_venus_object_lookup(&table, 0x6100);
+    if (pv_venus_object_handle_slot(reused) != pv_venus_object_handle_slot(buffer) ||
+        pv_venus_object_resolve(&table, buffer) != NULL ||
+        pv_venus_object_resolve(&table, reused) != HANDLE(200)) {
+        fprintf(stderr, "Stale handle resolved after slot reuse\n");
+        return 1;
+    }
+
+    /* An ID comes back as another type only once it has been removed */
+    if (pv_venus_object_add(&table, 0x7000, HANDLE(300), PV_VENUS_OBJECT_TYPE_BUFFER) == 0 ||
+        pv_venus_object_resolve(&table, pv_venus_object_lookup(&table, 0x7000)) != HANDLE(100)) {
+        fprintf(stderr, "Live image rebound as a buffer\n");
+        return 1;
+    }
+    pv_venus_object_remove(&table, 0x7000);
+    pv_venus_object_add(&table, 0x7000, HANDLE(300), PV_VENUS_OBJECT_TYPE_BUFFER);
+
+    /* Per-type iteration walks packed arrays */
+    const struct pv_venus_slot_map *buffers = table.types[PV_VENUS_OBJECT_TYPE_BUFFER];
+    const struct pv_venus_slot_map *images = table.types[PV_VENUS_OBJECT_TYPE_IMAGE];
+    printf("  buffers=%u images=%u\n", buffers->count, images->count);
+    if (buffers->count != 65 || images->count != 63) {
+        fprintf(stderr, "Wrong per-type counts\n");
+        return 1;
+    }
+    for (uint32_t i = 0; i < buffers->count; i++) {
+        if (pv_venus_object_get(&table, buffers->guest_ids[i]) != buffers->host_handles[i]) {
+            fprintf(stderr, "Dense entry %u out of sync\n", i);
+            return 1;
+        }
+    }
+
+    pv_venus_object_table_destroy(&table);
+
+    /* Test 6: Unlocked (seqlock) readers during grow/shrink churn */
+    printf("\n--- Test 6: Concurrent Readers ---\n");
+    pv_venus_object_table_init(&table, 0);
+    for (size_t i = 0; i < STABLE_OBJECTS; i++) {
+        pv_venus_object_add(&table, 0x100000 + i, HANDLE(i), PV_VENUS_OBJECT_TYPE_BUFFER);
+    }
+
+    pthread_t readers[3];
+    for (int i = 0; i < 3; i++) {
+        pthread_create(&readers[i], NULL, reader_thread, &table);
+    }
+
+    /* Waves of adds and removes force repeated index and slot map resizes */
+    for (int wave = 0; wave < 20; wave++) {
+        for (size_t i = 0; i < 20000; i++) {
+            pv_venus_object_add(&table, 0x200000 + i, HANDLE(i), PV_VENUS_OBJECT_TYPE_IMAGE);
+        }
+        for (size_t i = 0; i < 20000; i++) {
+            pv_venus_object_remove(&table, 0x200000 + i);
+        }
+    }
+    atomic_store(&writer_done, true);
+
+    uintptr_t errors = 0;
+    for (int i = 0; i < 3; i++) {
+        void *result;
+        pthread_join(readers[i], &result);
+        errors += (uintptr_t)result;
+    }
+    printf("  grows=%llu shrinks=%llu, reader errors=%zu\n",
+           table.grows, table.shrinks, (size_t)errors);
+    if (errors != 0) {
+        fprintf(stderr, "Readers saw wrong handles during resizes\n");
+        return 1;
+    }
+
+    pv_venus_object_table_destroy(&table);
+
+    /* Test 7: Ownership graph teardown */
+    printf("\n--- Test 7: Subtree Teardown ---\n");
+    pv_venus_object_table_init(&table, 0);
+    pv_venus_object_add(&table, 0x1000, HANDLE(0), PV_VENUS_OBJECT_TYPE_INSTANCE);
+    pv_venus_object_add_child(&table, 0x3000, HANDLE(1), PV_VENUS_OBJECT_TYPE_DEVICE, 0x1000);
+    pv_venus_object_add_child(&table, 0x3001, HANDLE(2), PV_VENUS_OBJECT_TYPE_DEVICE, 0x1000);
+    for (size_t i = 0; i < 100; i++) {
+        pv_venus_object_add_child(&table, 0x6000 + i, HANDLE(10 + i),
+                                  PV_VENUS_OBJECT_TYPE_BUFFER, 0x3000);
+    }
+    pv_venus_object_add_child(&table, 0x8000, HANDLE(3), PV_VENUS_OBJECT_TYPE_COMMAND_POOL, 0x3000);
+    for (size_t i = 0; i < 10; i++) {
+        pv_venus_object_add_child(&table, 0x9000 + i, HANDLE(200 + i),
+                                  PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER, 0x8000);
+    }
+
+    if (pv_venus_object_add_child(&table, 0x6fff, HANDLE(4), PV_VENUS_OBJECT_TYPE_BUFFER,
+                                  0xdead) == 0 ||
+        pv_venus_object_add_child(&table, 0x3000, HANDLE(1), PV_VENUS_OBJECT_TYPE_DEVICE,
+                                  0x9000) == 0) {
+        fprintf(stderr, "Bad parent accepted\n");
+        return 1;
+    }
+
+    /* A removed child leaves its siblings linked */
+    pv_venus_object_remove(&table, 0x6032);
+
+    struct pv_venus_object_release *releases;
+    size_t released = pv_venus_object_remove_tree(&table, 0x3000, &releases);
+    printf("  device teardown released %zu objects\n", released);
+    if (released != 1 + 99 + 1 + 10 || releases[released - 1].guest_id != 0x3000) {
+        fprintf(stderr, "Wrong teardown set\n");
+        return 1;
+    }
+
+    /* Children-first: nothing appears after its parent */
+    for (size_t i = 0; i < released; i++) {
+        if (releases[i].type == PV_VENUS_OBJECT_TYPE_COMMAND_BUFFER &&
+            releases[i].parent_handle != HANDLE(3)) {
+            fprintf(stderr, "Command buffer released without its pool\n");
+            return 1;
+        }
+        for (size_t j = 0; j < i; j++) {
+            if (releases[j].host_handle == releases[i].parent_handle) {
+                fprintf(stderr, "Parent 0x%llx released before child 0x%llx\n",
+                        releases[j].guest_id, releases[i].guest_id);
+                return 1;
+            }
+        }
+        if (pv_venus_object_get(&table, releases[i].guest_id) != NULL) {
+            fprintf(stderr, "Released object still in table\n");
+            return 1;
+        }
+    }
+    free(releases);
+
+    if (table.count != 2 || !pv_venus_object_get(&table, 0x3001)) {
+        fprintf(stderr, "Teardown touched objects outside the subtree\n");
+        return 1;
+    }
+    pv_venus_object_id instance;
+    if (!pv_venus_object_any(&table, PV_VENUS_OBJECT_TYPE_INSTANCE, &instance) ||
+        instance != 0x1000) {
+        fprintf(stderr, "Live instance not found\n");
+        return 1;
+    }
+    released = pv_venus_object_remove_tree(&table, instance, &releases);
+    free(releases);
+    if (released != 2 || table.count != 0 ||
+        pv_venus_object_any(&table, PV_VENUS_OBJECT_TYPE_INSTANCE, &instance)) {
+        fprintf(stderr, "Instance teardown left objects behind\n");
+        return 1;
+    }
+
+    pv_venus_object_table_destroy(&table);
+
+    printf("\n=== All Tests Passed! ===\n");
+    return 0;
+}
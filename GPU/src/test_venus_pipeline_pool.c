@@ -0,0 +1,183 @@
+/*
+ * PearVisor - Venus Pipeline Compile Pool Test
+ *
+ * Stress test: a burst of hundreds of pipeline creations must queue
+ * without blocking the submitting (ring) thread, and every placeholder
+ * must resolve to its own pipeline exactly once, whatever order the
+ * resolves come in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include "pv_venus_pipeline_pool.h"
+
+#define BURST        600
+#define FAIL_EVERY   17
+
+/* One fake compile: sleeps like a driver would, then returns its index */
+struct fake_job {
+    unsigned index;
+};
+
+static atomic_uint runs[BURST];
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+static int fake_compile(void *job_data, void **pipeline)
+{
+    struct fake_job *job = job_data;
+    unsigned index = job->index;
+    free(job);
+
+    atomic_fetch_add(&runs[index], 1);
+    usleep(200 + (index * 37) % 800);
+
+    if (index % FAIL_EVERY == 0) {
+        return -1;
+    }
+    *pipeline = (void *)(uintptr_t)(index + 1);
+    return 0;
+}
+
+static struct pv_venus_pipeline *submit(struct pv_venus_pipeline_pool *pool, unsigned index)
+{
+    struct fake_job *job = malloc(sizeof(*job));
+    if (!job) {
+        return NULL;
+    }
+    job->index = index;
+    struct pv_venus_pipeline *pipeline = pv_venus_pipeline_compile_async(pool, fake_compile, job);
+    if (!pipeline) {
+        free(job);
+    }
+    return pipeline;
+}
+
+/* Check one resolved placeholder against its index */
+static int check(struct pv_venus_pipeline_pool *pool, struct pv_venus_pipeline *pipeline,
+                 unsigned index)
+{
+    void *result = pv_venus_pipeline_resolve(pool, pipeline);
+    void *expected = index % FAIL_EVERY == 0 ? NULL : (void *)(uintptr_t)(index + 1);
+    if (result != expected) {
+        fprintf(stderr, "Pipeline %u resolved to %p, expected %p\n", index, result, expected);
+        return -1;
+    }
+    return 0;
+}
+
+/* Second resolver, racing the main thread and the workers */
+struct resolver {
+    struct pv_venus_pipeline_pool *pool;
+    struct pv_venus_pipeline **pipelines;
+    int result;
+};
+
+static void *resolver_main(void *arg)
+{
+    struct resolver *resolver = arg;
+    for (unsigned i = 1; i < BURST; i += 2) {
+        if (check(resolver->pool, resolver->pipelines[i], i) != 0) {
+            resolver->result = -1;
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    printf("=== PearVisor Venus Pipeline Compile Pool Test ===\n\n");
+
+    struct pv_venus_pipeline_pool pool;
+    if (pv_venus_pipeline_pool_init(&pool, 4) != 0) {
+        fprintf(stderr, "Init failed\n");
+        return 1;
+    }
+
+    /* Test 1: A burst queues without waiting for compiles */
+    printf("--- Test 1: Burst of %d Pipelines ---\n", BURST);
+    static struct pv_venus_pipeline *pipelines[BURST];
+    double start = now_ms();
+    for (unsigned i = 0; i < BURST; i++) {
+        pipelines[i] = submit(&pool, i);
+        if (!pipelines[i]) {
+            fprintf(stderr, "Submit %u failed\n", i);
+            return 1;
+        }
+    }
+    double submit_ms = now_ms() - start;
+    printf("  submitted in %.2f ms (compiles take ~%.0f ms serially)\n",
+           submit_ms, BURST * 0.6);
+    if (submit_ms > BURST * 0.6 / 4) {
+        fprintf(stderr, "Submitting blocked on compiles\n");
+        return 1;
+    }
+
+    /* Test 2: Resolve from two threads, latest first, while workers drain */
+    printf("\n--- Test 2: Resolve Out of Order ---\n");
+    struct resolver resolver = { .pool = &pool, .pipelines = pipelines };
+    pthread_t thread;
+    pthread_create(&thread, NULL, resolver_main, &resolver);
+    for (int i = BURST - 2 + (BURST % 2); i >= 0; i -= 2) {
+        if (check(&pool, pipelines[i], (unsigned)i) != 0) {
+            return 1;
+        }
+    }
+    pthread_join(thread, NULL);
+    if (resolver.result != 0) {
+        return 1;
+    }
+    double total_ms = now_ms() - start;
+
+    for (unsigned i = 0; i < BURST; i++) {
+        if (atomic_load(&runs[i]) != 1) {
+            fprintf(stderr, "Pipeline %u compiled %u times\n", i, atomic_load(&runs[i]));
+            return 1;
+        }
+        /* Resolved placeholders answer again without waiting */
+        if (check(&pool, pipelines[i], i) != 0) {
+            return 1;
+        }
+    }
+
+    struct pv_venus_pipeline_pool_stats stats;
+    pv_venus_pipeline_pool_get_stats(&pool, &stats);
+    printf("  all resolved in %.1f ms: compiled=%llu failed=%llu inline=%llu waits=%llu "
+           "max_queued=%llu\n",
+           total_ms, stats.compiled, stats.failed, stats.inline_compiles, stats.waits,
+           stats.max_queued);
+    if (stats.compiled != BURST || stats.failed != (BURST + FAIL_EVERY - 1) / FAIL_EVERY) {
+        fprintf(stderr, "Wrong statistics\n");
+        return 1;
+    }
+    for (unsigned i = 0; i < BURST; i++) {
+        pv_venus_pipeline_free(pipelines[i]);
+    }
+
+    /* Test 3: Destroy finishes what is still queued */
+    printf("\n--- Test 3: Drain on Destroy ---\n");
+    for (unsigned i = 0; i < 64; i++) {
+        atomic_store(&runs[i], 0);
+        pipelines[i] = submit(&pool, i);
+    }
+    pv_venus_pipeline_pool_destroy(&pool);
+    for (unsigned i = 0; i < 64; i++) {
+        if (atomic_load(&runs[i]) != 1 ||
+            atomic_load(&pipelines[i]->state) == PV_VENUS_PIPELINE_PENDING) {
+            fprintf(stderr, "Pipeline %u not compiled before destroy returned\n", i);
+            return 1;
+        }
+        pv_venus_pipeline_free(pipelines[i]);
+    }
+
+    printf("\n=== All Tests Passed! ===\n");
+    return 0;
+}
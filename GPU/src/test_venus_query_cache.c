@@ -0,0 +1,194 @@
+/*
+ * PearVisor - Venus Query Cache Test
+ *
+ * Builds the cache from a made-up device and a fake format query: every
+ * reply must match what the device reported, the driver must be asked
+ * about each format exactly once, and formats past the table must miss.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pv_venus_query_cache.h"
+
+static unsigned format_calls;
+
+/* Distinct, recognisable properties per format */
+static void fake_format_properties(void *user_data, VkFormat format,
+                                   VkFormatProperties *properties)
+{
+    (void)user_data;
+    properties->linearTilingFeatures = (VkFormatFeatureFlags)format;
+    properties->optimalTilingFeatures = (VkFormatFeatureFlags)format * 2;
+    properties->bufferFeatures = (VkFormatFeatureFlags)format * 3;
+    format_calls++;
+}
+
+static int lookup(struct pv_venus_query_cache *cache, uint32_t command_id,
+                  struct pv_venus_query_blob *blob)
+{
+    return pv_venus_query_cache_lookup(cache, command_id, NULL, 0, blob);
+}
+
+static int lookup_format(struct pv_venus_query_cache *cache, uint32_t format,
+                         struct pv_venus_query_blob *blob)
+{
+    struct pv_venus_get_format_properties args = { .format = format };
+    return pv_venus_query_cache_lookup(cache, PV_VK_COMMAND_vkGetPhysicalDeviceFormatProperties,
+                                       &args, sizeof(args), blob);
+}
+
+int main(void)
+{
+    printf("=== PearVisor Venus Query Cache Test ===\n\n");
+
+    VkPhysicalDeviceProperties properties;
+    memset(&properties, 0, sizeof(properties));
+    properties.vendorID = 0x106B;
+    properties.deviceType = VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU;
+    strcpy(properties.deviceName, "Fake GPU");
+
+    VkPhysicalDeviceFeatures features = { .robustBufferAccess = VK_TRUE };
+
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    memset(&memory_properties, 0, sizeof(memory_properties));
+    memory_properties.memoryTypeCount = 2;
+    memory_properties.memoryHeapCount = 1;
+    memory_properties.memoryHeaps[0].size = 1ull << 33;
+
+    VkQueueFamilyProperties queue_families[2] = {
+        { .queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, .queueCount = 4 },
+        { .queueFlags = VK_QUEUE_TRANSFER_BIT, .queueCount = 1 },
+    };
+
+    struct pv_venus_query_device device = {
+        .properties = &properties,
+        .features = &features,
+        .memory_properties = &memory_properties,
+        .queue_families = queue_families,
+        .queue_family_count = 2,
+    };
+    struct pv_venus_query_backend backend = { .format_properties = fake_format_properties };
+
+    struct pv_venus_query_cache cache;
+    memset(&cache, 0, sizeof(cache));
+    struct pv_venus_query_blob blob;
+
+    /* Test 1: An empty cache answers nothing */
+    printf("--- Test 1: Empty Cache ---\n");
+    if (lookup(&cache, PV_VK_COMMAND_vkGetPhysicalDeviceProperties, &blob) == 0 ||
+        lookup_format(&cache, VK_FORMAT_R8G8B8A8_UNORM, &blob) == 0) {
+        fprintf(stderr, "Hit before build\n");
+        return 1;
+    }
+    printf("  every lookup misses\n");
+
+    /* Test 2: Fixed replies are what the device reported */
+    printf("\n--- Test 2: Device Replies ---\n");
+    if (pv_venus_query_cache_build(&cache, &device, &backend) != 0) {
+        fprintf(stderr, "Build failed\n");
+        return 1;
+    }
+    if (format_calls != PV_VENUS_QUERY_FORMAT_COUNT) {
+        fprintf(stderr, "Expected %u format queries, got %u\n",
+                PV_VENUS_QUERY_FORMAT_COUNT, format_calls);
+        return 1;
+    }
+
+    if (lookup(&cache, PV_VK_COMMAND_vkGetPhysicalDeviceProperties, &blob) != 0 ||
+        blob.size != sizeof(properties) || memcmp(blob.data, &properties, blob.size) != 0 ||
+        (uintptr_t)blob.data % 16 != 0) {
+        fprintf(stderr, "Properties reply wrong\n");
+        return 1;
+    }
+    if (lookup(&cache, PV_VK_COMMAND_vkGetPhysicalDeviceFeatures, &blob) != 0 ||
+        blob.size != sizeof(features) || memcmp(blob.data, &features, blob.size) != 0) {
+        fprintf(stderr, "Features reply wrong\n");
+        return 1;
+    }
+    if (lookup(&cache, PV_VK_COMMAND_vkGetPhysicalDeviceMemoryProperties, &blob) != 0 ||
+        blob.size != sizeof(memory_properties) ||
+        memcmp(blob.data, &memory_properties, blob.size) != 0) {
+        fprintf(stderr, "Memory properties reply wrong\n");
+        return 1;
+    }
+
+    struct pv_venus_queue_family_properties count;
+    if (lookup(&cache, PV_VK_COMMAND_vkGetPhysicalDeviceQueueFamilyProperties, &blob) != 0 ||
+        blob.size != sizeof(count) + sizeof(queue_families)) {
+        fprintf(stderr, "Queue family reply wrong size\n");
+        return 1;
+    }
+    memcpy(&count, blob.data, sizeof(count));
+    if (count.count != 2 ||
+        memcmp((const uint8_t *)blob.data + sizeof(count), queue_families,
+               sizeof(queue_families)) != 0) {
+        fprintf(stderr, "Queue family reply wrong\n");
+        return 1;
+    }
+    printf("  properties, features, memory, queue families match\n");
+
+    /* Test 3: Every core format from the table, without asking again */
+    printf("\n--- Test 3: Format Table ---\n");
+    for (uint32_t format = 0; format < PV_VENUS_QUERY_FORMAT_COUNT; format++) {
+        VkFormatProperties expected;
+        fake_format_properties(NULL, (VkFormat)format, &expected);
+        if (lookup_format(&cache, format, &blob) != 0 || blob.size != sizeof(expected) ||
+            memcmp(blob.data, &expected, sizeof(expected)) != 0) {
+            fprintf(stderr, "Format %u reply wrong\n", format);
+            return 1;
+        }
+    }
+    format_calls -= PV_VENUS_QUERY_FORMAT_COUNT;   /* The test's own calls */
+    if (format_calls != PV_VENUS_QUERY_FORMAT_COUNT) {
+        fprintf(stderr, "Lookup reached the backend\n");
+        return 1;
+    }
+    printf("  %u formats served from the table\n", PV_VENUS_QUERY_FORMAT_COUNT);
+
+    /* Test 4: What the table can't answer misses */
+    printf("\n--- Test 4: Misses ---\n");
+    struct pv_venus_get_format_properties args = { .format = VK_FORMAT_R8G8B8A8_UNORM };
+    if (lookup_format(&cache, PV_VENUS_QUERY_FORMAT_COUNT, &blob) == 0 ||
+        lookup_format(&cache, 1000156000, &blob) == 0 ||       /* An extension format */
+        pv_venus_query_cache_lookup(&cache, PV_VK_COMMAND_vkGetPhysicalDeviceFormatProperties,
+                                    &args, sizeof(args) - 1, &blob) == 0 ||
+        lookup(&cache, PV_VK_COMMAND_vkGetPhysicalDeviceImageFormatProperties, &blob) == 0 ||
+        lookup(&cache, PV_VK_COMMAND_vkCreateDevice, &blob) == 0) {
+        fprintf(stderr, "Unexpected hit\n");
+        return 1;
+    }
+    printf("  extension formats, short payloads and other commands miss\n");
+
+    /* Test 5: Rebuilding replaces the replies */
+    printf("\n--- Test 5: Rebuild ---\n");
+    strcpy(properties.deviceName, "Other GPU");
+    device.queue_family_count = 1;
+    if (pv_venus_query_cache_build(&cache, &device, &backend) != 0 ||
+        lookup(&cache, PV_VK_COMMAND_vkGetPhysicalDeviceProperties, &blob) != 0 ||
+        strcmp(((const VkPhysicalDeviceProperties *)blob.data)->deviceName, "Other GPU") != 0 ||
+        lookup(&cache, PV_VK_COMMAND_vkGetPhysicalDeviceQueueFamilyProperties, &blob) != 0 ||
+        blob.size != sizeof(count) + sizeof(queue_families[0])) {
+        fprintf(stderr, "Rebuild kept stale replies\n");
+        return 1;
+    }
+
+    struct pv_venus_query_cache_stats stats;
+    pv_venus_query_cache_get_stats(&cache, &stats);
+    printf("  hits=%llu misses=%llu bytes_served=%llu bytes_cached=%llu\n",
+           stats.hits, stats.misses, stats.bytes_served, stats.bytes_cached);
+    if (stats.hits != 4 + PV_VENUS_QUERY_FORMAT_COUNT + 2 || stats.misses != 2 + 5 ||
+        stats.bytes_cached == 0) {
+        fprintf(stderr, "Wrong statistics\n");
+        return 1;
+    }
+
+    pv_venus_query_cache_destroy(&cache);
+    if (lookup(&cache, PV_VK_COMMAND_vkGetPhysicalDeviceFeatures, &blob) == 0) {
+        fprintf(stderr, "Hit after destroy\n");
+        return 1;
+    }
+
+    printf("\n=== All Tests Passed! ===\n");
+    return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * PearVisor - Venus Reply Ring Test
+ *
+ * Test program to verify host-to-guest reply ring
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pv_venus_reply.h"
+
+/* Simulate a guest consuming one reply: one memcpy, one head store */
+static int simulate_guest_read(struct pv_venus_reply_ring *ring,
+                               struct pv_venus_reply_header *header,
+                               void *payload,
+                               size_t payload_size)
+{
+    uint32_t head = atomic_load_explicit(ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(ring->tail, memory_order_acquire);
+
+    if (head == tail) {
+        return -1;
+    }
+
+    const struct pv_venus_reply_header *h =
+        (const struct pv_venus_reply_header *)(ring->data + (head & ring->mask));
+    if (h->command_id == PV_VENUS_REPLY_PADDING) {
+        head += h->reply_size;
+        h = (const struct pv_venus_reply_header *)(ring->data + (head & ring->mask));
+    }
+
+    memcpy(header, h, sizeof(*header));
+    memcpy(payload, h + 1, payload_size);
+
+    atomic_store_explicit((atomic_uint *)ring->head, head + h->reply_size,
+                          memory_order_release);
+
+    printf("[Test] Guest read reply cmd=%u seq=%u size=%u (head: %u)\n",
+           header->command_id, header->sequence, header->reply_size,
+           head + header->reply_size);
+    return 0;
+}
+
+static int doorbells_rung = 0;
+
+static void test_doorbell(void *user_data)
+{
+    (void)user_data;
+    doorbells_rung++;
+}
+
+int main(void)
+{
+    printf("=== PearVisor Venus Reply Ring Test ===\n\n");
+
+    /* Allocate shared memory: a 4KB data region after the control lines */
+    const size_t buffer_size = 4096;
+    size_t shared_size = PV_VENUS_RING_ISOLATED_CONTROL_SIZE + buffer_size;
+    void *shared_mem = aligned_alloc(4096, 2 * buffer_size);
+    if (!shared_mem) {
+        fprintf(stderr, "Failed to allocate shared memory\n");
+        return 1;
+    }
+    memset(shared_mem, 0, shared_size);
+
+    struct pv_venus_ring_layout layout;
+    if (pv_venus_ring_layout_init(&layout, shared_mem, shared_size,
+                                  PV_VENUS_RING_LAYOUT_ISOLATED, 0) != 0) {
+        fprintf(stderr, "Failed to compute layout\n");
+        free(shared_mem);
+        return 1;
+    }
+
+    if (layout.buffer_size != buffer_size) {
+        fprintf(stderr, "Data region is %zu bytes, expected %zu\n",
+                layout.buffer_size, buffer_size);
+        free(shared_mem);
+        return 1;
+    }
+
+    struct pv_venus_reply_ring *ring = pv_venus_reply_ring_create(&layout);
+    if (!ring) {
+        fprintf(stderr, "Failed to create reply ring\n");
+        free(shared_mem);
+        return 1;
+    }
+
+    struct pv_venus_reply_header header;
+    uint8_t payload[256];
+    int rc = 1;
+
+    /* Test 1: Copy a result into a reply */
+    printf("\n--- Test 1: Write Reply ---\n");
+
+    struct pv_venus_reply_encoder encoder;
+    uint32_t value = 0xCAFEF00D;
+    if (pv_venus_reply_begin(ring, &encoder, 6, sizeof(value)) != 0 ||
+        pv_venus_reply_write(&encoder, &value, sizeof(value)) != 0 ||
+        pv_venus_reply_write(&encoder, payload, sizeof(payload)) == 0) {
+        fprintf(stderr, "Failed to encode reply\n");
+        goto out;
+    }
+    pv_venus_reply_end(&encoder, 0);
+
+    uint32_t got = 0;
+    if (simulate_guest_read(ring, &header, &got, sizeof(got)) != 0 ||
+        header.command_id != 6 || header.sequence != 0 || got != value ||
+        header.reply_size % PV_VENUS_REPLY_ALIGN != 0) {
+        fprintf(stderr, "Reply mismatch\n");
+        goto out;
+    }
+
+    /* Test 2: Serialize in place */
+    printf("\n--- Test 2: In-Place Reply ---\n");
+
+    if (pv_venus_reply_begin(ring, &encoder, 8, 64) != 0) {
+        fprintf(stderr, "Failed to begin reply\n");
+        goto out;
+    }
+    uint8_t *slot = pv_venus_reply_reserve(&encoder, 64);
+    if (!slot || ((uintptr_t)slot & (PV_VENUS_REPLY_ALIGN - 1)) != 0 ||
+        slot < ring->data || slot + 64 > ring->data + ring->size) {
+        fprintf(stderr, "Reserved slot not in ring memory\n");
+        goto out;
+    }
+    for (int i = 0; i < 64; i++) {
+        slot[i] = (uint8_t)i;
+    }
+    pv_venus_reply_end(&encoder, -3);
+
+    if (simulate_guest_read(ring, &header, payload, 64) != 0 ||
+        header.result != -3 || header.sequence != 1 || payload[63] != 63) {
+        fprintf(stderr, "In-place reply mismatch\n");
+        goto out;
+    }
+
+    /* Test 3: Replies stay contiguous across the wrap */
+    printf("\n--- Test 3: Wrap Padding ---\n");
+
+    for (int i = 0; i < 40; i++) {
+        memset(payload, i, 200);
+        if (pv_venus_reply_begin(ring, &encoder, 3, 200) != 0) {
+            fprintf(stderr, "Ring unexpectedly full\n");
+            goto out;
+        }
+        pv_venus_reply_write(&encoder, payload, 200);
+        pv_venus_reply_end(&encoder, 0);
+
+        uint8_t check[200];
+        if (simulate_guest_read(ring, &header, check, sizeof(check)) != 0 ||
+            check[0] != i || check[199] != i) {
+            fprintf(stderr, "Reply %d corrupted\n", i);
+            goto out;
+        }
+    }
+    if (ring->stats.paddings == 0) {
+        fprintf(stderr, "Wrap never padded\n");
+        goto out;
+    }
+
+    /* Test 4: Overflow when the guest stops consuming */
+    printf("\n--- Test 4: Overflow ---\n");
+
+    int written = 0;
+    while (pv_venus_reply_begin(ring, &encoder, 3, 200) == 0) {
+        pv_venus_reply_end(&encoder, 0);
+        written++;
+    }
+    printf("  %d replies fit, space left=%u\n", written, pv_venus_reply_space(ring));
+    if (written == 0 || ring->stats.overflows != 1) {
+        fprintf(stderr, "Overflow not detected\n");
+        goto out;
+    }
+    while (simulate_guest_read(ring, &header, payload, 0) == 0) {
+    }
+
+    /* Test 5: Doorbell only for a waiting guest */
+    printf("\n--- Test 5: Doorbell ---\n");
+
+    pv_venus_reply_set_doorbell(ring, test_doorbell, NULL);
+    pv_venus_reply_begin(ring, &encoder, 8, 0);
+    pv_venus_reply_end(&encoder, 0);
+
+    atomic_fetch_or(ring->status, PV_VENUS_RING_STATUS_NEED_NOTIFY);
+    pv_venus_reply_begin(ring, &encoder, 8, 0);
+    pv_venus_reply_end(&encoder, 0);
+    pv_venus_reply_begin(ring, &encoder, 8, 0);
+    pv_venus_reply_end(&encoder, 0);
+
+    printf("  doorbells=%d\n", doorbells_rung);
+    if (doorbells_rung != 1) {
+        fprintf(stderr, "Expected exactly one doorbell\n");
+        goto out;
+    }
+
+    rc = 0;
+    printf("\n=== All Tests Passed! ===\n");
+
+out:
+    pv_venus_reply_ring_destroy(ring);
+    free(shared_mem);
+    return rc;
+}
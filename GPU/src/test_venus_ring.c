@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sched.h>
 #include "pv_venus_ring.h"
 
 /* Simulate a guest writing to the ring */
@@ -16,8 +17,8 @@ static void simulate_guest_write(struct pv_venus_ring *ring, size_t bytes)
     /* Get current tail */
     uint32_t tail = pv_venus_ring_get_tail(ring);
     
-    /* Simulate advancing tail */
-    uint32_t new_tail = (tail + bytes) & ring->buffer.mask;
+    /* Simulate advancing tail (free-running, never masked) */
+    uint32_t new_tail = tail + (uint32_t)bytes;
     
     /* Write new tail (simulating guest) */
     atomic_store_explicit((atomic_uint *)ring->control.tail, new_tail, 
@@ -29,6 +30,231 @@ static void simulate_guest_write(struct pv_venus_ring *ring, size_t bytes)
     pv_venus_ring_notify(ring);
 }
 
+/* Verify free-running head/tail across a full ring and 2^32 wrap */
+static int test_sequence_counters(struct pv_venus_ring *ring)
+{
+    /* Start just below the 32-bit wrap */
+    uint32_t head = UINT32_MAX - 100;
+    ring->buffer.current_pos = head;
+    pv_venus_ring_set_head(ring, head);
+
+    /* Guest fills the entire ring */
+    uint32_t tail = head + ring->buffer.size;
+    atomic_store_explicit((atomic_uint *)ring->control.tail, tail,
+                         memory_order_release);
+
+    printf("  head=%u tail=%u available=%u space=%u\n", head, tail,
+           pv_venus_ring_available(ring), pv_venus_ring_space(ring));
+
+    if (pv_venus_ring_available(ring) != ring->buffer.size ||
+        pv_venus_ring_space(ring) != 0 ||
+        !pv_venus_ring_seq_before(head, tail) ||
+        pv_venus_ring_seq_before(tail, head)) {
+        fprintf(stderr, "Full ring not distinguished from empty\n");
+        return -1;
+    }
+
+    /* Whole ring is readable in one view */
+    struct pv_venus_ring_view view;
+    if (pv_venus_ring_view_acquire(ring, ring->buffer.size, &view) != 0 ||
+        pv_venus_ring_available(ring) != 0) {
+        fprintf(stderr, "Failed to consume full ring\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Verify ring arena reserve/commit/reset */
+static int test_arena(struct pv_venus_ring *ring)
+{
+    struct pv_venus_ring_arena *arena = &ring->arena;
+
+    /* Reserve generously, commit only what was used */
+    uint8_t *a = pv_venus_ring_arena_reserve(arena, 512, 64);
+    if (!a || ((uintptr_t)a & 63) != 0) {
+        fprintf(stderr, "Reserve failed or misaligned\n");
+        return -1;
+    }
+    pv_venus_ring_arena_commit(arena, 100);
+
+    uint8_t *b = pv_venus_ring_arena_alloc(arena, 200, 8);
+    if (!b || b < a + 100) {
+        fprintf(stderr, "Allocation overlaps committed bytes\n");
+        return -1;
+    }
+
+    /* More than what is left must fail without disturbing the arena */
+    size_t offset = arena->offset;
+    if (pv_venus_ring_arena_alloc(arena, arena->size, 8) != NULL ||
+        arena->offset != offset || arena->exhausted != 1) {
+        fprintf(stderr, "Oversized allocation should fail\n");
+        return -1;
+    }
+
+    size_t high_water = arena->high_water;
+    pv_venus_ring_arena_reset(arena);
+    printf("  high_water=%zu exhausted=%llu offset after reset=%zu\n",
+           high_water, (unsigned long long)arena->exhausted, arena->offset);
+
+    /* Reset keeps the memory: the next allocation reuses the same bytes */
+    if (arena->offset != 0 || arena->high_water != high_water ||
+        pv_venus_ring_arena_alloc(arena, 16, 64) != a) {
+        fprintf(stderr, "Reset did not release arena\n");
+        return -1;
+    }
+
+    pv_venus_ring_arena_reset(arena);
+    return 0;
+}
+
+/* Verify a mirror-mapped ring serves wrapping reads without copies */
+static int test_mirrored_ring(void)
+{
+    const uint32_t buffer_size = 64 * 1024;
+
+    struct pv_venus_ring *ring = pv_venus_ring_create_mirrored(buffer_size);
+    if (!ring) {
+        fprintf(stderr, "Failed to create mirrored ring\n");
+        return -1;
+    }
+
+    printf("  Mirrored: %s\n", ring->buffer.mirrored ? "yes" : "no (fallback)");
+
+    /* Place a payload so it straddles the wrap point */
+    uint8_t payload[256];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)i;
+    }
+
+    uint32_t start = buffer_size - 100;
+    uint8_t *data = (uint8_t *)ring->buffer.data;
+    memcpy(data + start, payload, 100);
+    memcpy(data, payload + 100, sizeof(payload) - 100);
+
+    ring->buffer.current_pos = start;
+    atomic_store_explicit((atomic_uint *)ring->control.tail,
+                         start + (uint32_t)sizeof(payload), memory_order_release);
+
+    struct pv_venus_ring_view view;
+    if (pv_venus_ring_view_acquire(ring, sizeof(payload), &view) != 0 ||
+        memcmp(view.data, payload, sizeof(payload)) != 0) {
+        fprintf(stderr, "Wrapped view mismatch\n");
+        pv_venus_ring_destroy(ring);
+        return -1;
+    }
+
+    printf("  Wrapped view: %s\n", view.copied ? "copied" : "zero-copy");
+    if (ring->buffer.mirrored && view.copied) {
+        fprintf(stderr, "Mirrored ring should never copy\n");
+        pv_venus_ring_destroy(ring);
+        return -1;
+    }
+
+    pv_venus_ring_destroy(ring);
+    return 0;
+}
+
+/* Verify a park-only ring sleeps in the kernel and a notify wakes it promptly */
+static int test_park_wake(void)
+{
+    const size_t buffer_size = 4096;
+    const size_t total_size = sizeof(uint32_t) * 4 + buffer_size;
+
+    void *shared_mem = calloc(1, total_size);
+    if (!shared_mem) {
+        fprintf(stderr, "Failed to allocate shared memory\n");
+        return -1;
+    }
+
+    /* Long park timeout, so only a notify can wake the thread in time */
+    struct pv_venus_ring_layout layout = {
+        .shared_memory = shared_mem,
+        .shared_memory_size = total_size,
+        .head_offset = 0,
+        .tail_offset = sizeof(uint32_t),
+        .status_offset = sizeof(uint32_t) * 2,
+        .buffer_offset = sizeof(uint32_t) * 4,
+        .buffer_size = buffer_size,
+        .wait_policy = PV_VENUS_RING_WAIT_POLICY_PARK,
+    };
+    layout.wait_policy.park_timeout_ms = 5000;
+
+    struct pv_venus_ring *ring = pv_venus_ring_create(&layout, NULL);
+    if (!ring) {
+        fprintf(stderr, "Failed to create park-only ring\n");
+        free(shared_mem);
+        return -1;
+    }
+
+    int result = -1;
+    if (ring->wait_policy.spin_iterations != 0 ||
+        ring->wait_policy.yield_iterations != 0) {
+        fprintf(stderr, "Zero spin/yield iterations replaced by the default\n");
+        goto out;
+    }
+
+    if (pv_venus_ring_start(ring) != 0) {
+        fprintf(stderr, "Failed to start park-only ring\n");
+        goto out;
+    }
+
+    /* Wait for the thread to ask for a notification (it is parking) */
+    for (int i = 0; i < 1000 && !pv_venus_ring_needs_notify(ring); i++) {
+        usleep(1000);
+    }
+    if (!pv_venus_ring_needs_notify(ring)) {
+        fprintf(stderr, "Ring thread never parked\n");
+        pv_venus_ring_stop(ring);
+        goto out;
+    }
+    usleep(10000);  /* Let it get into the futex / condvar wait */
+
+    uint32_t tail = pv_venus_ring_get_tail(ring) + 64;
+    uint64_t start = pv_venus_clock_ns();
+    atomic_store_explicit((atomic_uint *)ring->control.tail, tail,
+                         memory_order_release);
+    pv_venus_ring_notify(ring);
+
+    /*
+     * The thread drops the data (no dispatch context) and publishes head.
+     * Allow a tenth of the park timeout: anything slower means the thread
+     * slept through the notify and woke on the timeout instead.
+     */
+    while (pv_venus_ring_get_head(ring) != tail &&
+           pv_venus_clock_ns() - start < 500000000ull) {
+        sched_yield();
+    }
+    uint64_t wake_ns = pv_venus_clock_ns() - start;
+
+    pv_venus_ring_stop(ring);
+
+    uint64_t notifies = atomic_load_explicit(&ring->stats.notifies, memory_order_relaxed);
+    printf("  Wake latency: %llu us (parks=%llu spins=%llu yields=%llu notifies=%llu)\n",
+           (unsigned long long)(wake_ns / 1000),
+           (unsigned long long)ring->stats.parks,
+           (unsigned long long)ring->stats.spins,
+           (unsigned long long)ring->stats.yields,
+           (unsigned long long)notifies);
+
+    if (pv_venus_ring_get_head(ring) != tail) {
+        fprintf(stderr, "Notify did not wake the parked thread within 500 ms\n");
+        goto out;
+    }
+    if (ring->stats.parks == 0 || notifies == 0 ||
+        ring->stats.spins != 0 || ring->stats.yields != 0) {
+        fprintf(stderr, "Unexpected wait counters for a park-only policy\n");
+        goto out;
+    }
+
+    result = 0;
+
+out:
+    pv_venus_ring_destroy(ring);
+    free(shared_mem);
+    return result;
+}
+
 int main(int argc, char **argv)
 {
     (void)argc;
@@ -106,6 +332,12 @@ int main(int argc, char **argv)
     simulate_guest_write(ring, 256);
     sleep(1);
 
+    /* Back-to-back writes while the thread is busy should not need wakeups */
+    for (int i = 0; i < 8; i++) {
+        simulate_guest_write(ring, 16);
+    }
+    sleep(1);
+
     /* Test 4: Check ring state */
     printf("\n--- Test 4: Ring State After Writes ---\n");
     
@@ -115,7 +347,12 @@ int main(int argc, char **argv)
     printf("  Available: %u bytes\n", pv_venus_ring_available(ring));
     printf("  Commands processed: %llu\n", ring->stats.commands_processed);
     printf("  Bytes read: %llu\n", ring->stats.bytes_read);
-    printf("  Waits: %llu\n", ring->stats.waits);
+    printf("  Waits: %llu (spins=%llu yields=%llu parks=%llu)\n",
+           ring->stats.waits, ring->stats.spins,
+           ring->stats.yields, ring->stats.parks);
+    printf("  Notifies: %llu (suppressed=%llu)\n",
+           atomic_load_explicit(&ring->stats.notifies, memory_order_relaxed),
+           atomic_load_explicit(&ring->stats.notifies_suppressed, memory_order_relaxed));
 
     /* Test 5: Test wrapping */
     printf("\n--- Test 5: Test Ring Wrapping ---\n");
@@ -139,6 +376,42 @@ int main(int argc, char **argv)
         fprintf(stderr, "Failed to stop ring\n");
     }
 
+    /* Test 7: Free-running sequence counters */
+    printf("\n--- Test 7: Sequence Counters ---\n");
+    
+    if (test_sequence_counters(ring) != 0) {
+        pv_venus_ring_destroy(ring);
+        free(shared_mem);
+        return 1;
+    }
+
+    /* Test 8: Mirrored ring */
+    printf("\n--- Test 8: Mirror-Mapped Ring ---\n");
+    
+    if (test_mirrored_ring() != 0) {
+        pv_venus_ring_destroy(ring);
+        free(shared_mem);
+        return 1;
+    }
+
+    /* Test 9: Park-only wait policy */
+    printf("\n--- Test 9: Park and Wake ---\n");
+    
+    if (test_park_wake() != 0) {
+        pv_venus_ring_destroy(ring);
+        free(shared_mem);
+        return 1;
+    }
+
+    /* Test 10: Scratch arena */
+    printf("\n--- Test 10: Scratch Arena ---\n");
+    
+    if (test_arena(ring) != 0) {
+        pv_venus_ring_destroy(ring);
+        free(shared_mem);
+        return 1;
+    }
+
     /* Cleanup */
     printf("\n--- Cleanup ---\n");
     pv_venus_ring_destroy(ring);
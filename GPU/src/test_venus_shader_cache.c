@@ -0,0 +1,168 @@
+/*
+ * PearVisor - Venus Shader Module Cache Test
+ *
+ * Test program to verify SPIR-V deduplication against a fake backend
+ * that counts module creations
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pv_venus_shader_cache.h"
+
+/* Fake backend: modules are heap blocks; count what is live */
+static int live_modules;
+static int created_modules;
+static int calls_under_lock;
+
+/* The driver calls must not hold up other lookups */
+static void check_unlocked(struct pv_venus_shader_cache *cache)
+{
+    if (pthread_mutex_trylock(&cache->lock) != 0) {
+        calls_under_lock++;
+        return;
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+static int fake_create(void *user_data, void *device, const uint32_t *code, size_t code_size,
+                       void **module)
+{
+    (void)device;
+    (void)code;
+    (void)code_size;
+    check_unlocked(user_data);
+    *module = malloc(1);
+    live_modules++;
+    created_modules++;
+    return *module ? 0 : -1;
+}
+
+static void fake_destroy(void *user_data, void *device, void *module)
+{
+    (void)device;
+    check_unlocked(user_data);
+    free(module);
+    live_modules--;
+}
+
+/* Fake SPIR-V: magic, then words derived from @seed */
+static void make_code(uint32_t *code, size_t words, uint32_t seed)
+{
+    code[0] = 0x07230203u;
+    for (size_t i = 1; i < words; i++) {
+        code[i] = seed * 2654435761u + (uint32_t)i;
+    }
+}
+
+int main(void)
+{
+    printf("=== PearVisor Venus Shader Module Cache Test ===\n\n");
+
+    struct pv_venus_shader_cache cache;
+    struct pv_venus_shader_cache_backend backend = {
+        .create = fake_create,
+        .destroy = fake_destroy,
+        .user_data = &cache,
+    };
+    if (pv_venus_shader_cache_init(&cache, &backend) != 0) {
+        fprintf(stderr, "Init failed\n");
+        return 1;
+    }
+
+    void *device_a = (void *)0x1;
+    void *device_b = (void *)0x2;
+    enum { WORDS = 1024 };
+    static uint32_t code[WORDS], same[WORDS], other[WORDS];
+    make_code(code, WORDS, 1);
+    make_code(same, WORDS, 1);
+    make_code(other, WORDS, 2);
+
+    /* Test 1: Identical code shares one module */
+    printf("--- Test 1: Deduplication ---\n");
+    struct pv_venus_shader *first = pv_venus_shader_cache_acquire(&cache, device_a, code, sizeof(code));
+    struct pv_venus_shader *second = pv_venus_shader_cache_acquire(&cache, device_a, same, sizeof(same));
+    if (!first || first != second || first->refs != 2 || created_modules != 1) {
+        fprintf(stderr, "Identical code not shared\n");
+        return 1;
+    }
+
+    /* Unaligned copies of the same code hit too */
+    static uint8_t unaligned[sizeof(code) + 1];
+    memcpy(unaligned + 1, code, sizeof(code));
+    struct pv_venus_shader *third =
+        pv_venus_shader_cache_acquire(&cache, device_a, unaligned + 1, sizeof(code));
+    if (third != first || created_modules != 1) {
+        fprintf(stderr, "Unaligned code missed\n");
+        return 1;
+    }
+    printf("  3 uploads, 1 module\n");
+
+    /* Test 2: Different code or device gets its own module */
+    printf("\n--- Test 2: Distinct Modules ---\n");
+    struct pv_venus_shader *different = pv_venus_shader_cache_acquire(&cache, device_a, other, sizeof(other));
+    struct pv_venus_shader *other_device = pv_venus_shader_cache_acquire(&cache, device_b, code, sizeof(code));
+    struct pv_venus_shader *prefix = pv_venus_shader_cache_acquire(&cache, device_a, code, sizeof(code) - 4);
+    if (!different || !other_device || !prefix || different == first || other_device == first ||
+        prefix == first || created_modules != 4) {
+        fprintf(stderr, "Distinct code or device shared a module\n");
+        return 1;
+    }
+    printf("  different code, device and size each got a module\n");
+
+    /* Test 3: Refcounting */
+    printf("\n--- Test 3: Release ---\n");
+    pv_venus_shader_cache_release(&cache, first);
+    pv_venus_shader_cache_release(&cache, second);
+    if (live_modules != 4) {
+        fprintf(stderr, "Module destroyed while still referenced\n");
+        return 1;
+    }
+    pv_venus_shader_cache_release(&cache, third);
+    if (live_modules != 3) {
+        fprintf(stderr, "Module not destroyed with its last reference\n");
+        return 1;
+    }
+
+    /* Test 4: Many modules (bucket growth) */
+    printf("\n--- Test 4: Growth ---\n");
+    enum { MANY = 2000 };
+    static struct pv_venus_shader *many[MANY];
+    for (int round = 0; round < 2; round++) {
+        for (uint32_t i = 0; i < MANY; i++) {
+            uint32_t small[16];
+            make_code(small, 16, 100 + i);
+            struct pv_venus_shader *shader =
+                pv_venus_shader_cache_acquire(&cache, device_a, small, sizeof(small));
+            if (!shader || (round == 1 && shader != many[i])) {
+                fprintf(stderr, "Lookup %u failed in round %d\n", i, round);
+                return 1;
+            }
+            many[i] = shader;
+        }
+    }
+    printf("  %d modules, %zu buckets\n", MANY, cache.bucket_count);
+
+    struct pv_venus_shader_cache_stats stats;
+    pv_venus_shader_cache_get_stats(&cache, &stats);
+    printf("  lookups=%llu hits=%llu bytes_saved=%llu\n",
+           stats.lookups, stats.hits, stats.bytes_saved);
+    if (stats.hits != 2 + MANY || stats.bytes_saved != 2 * sizeof(code) + MANY * 64 ||
+        stats.modules != 3 + MANY) {
+        fprintf(stderr, "Wrong statistics\n");
+        return 1;
+    }
+    if (calls_under_lock != 0) {
+        fprintf(stderr, "%d driver calls made under the cache lock\n", calls_under_lock);
+        return 1;
+    }
+
+    pv_venus_shader_cache_destroy(&cache);
+    if (live_modules != 0) {
+        fprintf(stderr, "Destroy left %d modules\n", live_modules);
+        return 1;
+    }
+
+    printf("\n=== All Tests Passed! ===\n");
+    return 0;
+}
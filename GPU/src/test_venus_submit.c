@@ -0,0 +1,218 @@
+/*
+ * PearVisor - Venus Submit Coalescing Test
+ *
+ * Drives the coalescer with a fake vkQueueSubmit that records what it is
+ * given: consecutive submits must merge, batches and semaphores must keep
+ * their order, and every flush trigger must fire.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "pv_venus_submit.h"
+
+#define MAX_CALLS 64
+
+/* Handles are just distinct integers here */
+#define HANDLE(type, value) ((type)(uintptr_t)(value))
+
+/* What one fake vkQueueSubmit saw */
+struct call {
+    VkQueue queue;
+    VkFence fence;
+    uint32_t batches;
+    uintptr_t command_buffers[PV_VENUS_SUBMIT_MAX_BATCHES];  /* First of each batch */
+    uintptr_t waits[PV_VENUS_SUBMIT_MAX_BATCHES];            /* First wait of each batch */
+    uintptr_t signals[PV_VENUS_SUBMIT_MAX_BATCHES];          /* First signal of each batch */
+};
+
+static struct call calls[MAX_CALLS];
+static unsigned call_count;           /* Read after a locked stats call */
+
+static int fake_submit(void *user_data, VkQueue queue, uint32_t count,
+                       const VkSubmitInfo *submits, VkFence fence, uint64_t seqno)
+{
+    (void)user_data;
+    (void)seqno;
+    struct call *call = &calls[call_count % MAX_CALLS];
+    memset(call, 0, sizeof(*call));
+    call->queue = queue;
+    call->fence = fence;
+    call->batches = count;
+    for (uint32_t i = 0; i < count; i++) {
+        if (submits[i].commandBufferCount) {
+            call->command_buffers[i] = (uintptr_t)submits[i].pCommandBuffers[0];
+        }
+        if (submits[i].waitSemaphoreCount) {
+            call->waits[i] = (uintptr_t)submits[i].pWaitSemaphores[0];
+        }
+        if (submits[i].signalSemaphoreCount) {
+            call->signals[i] = (uintptr_t)submits[i].pSignalSemaphores[0];
+        }
+    }
+    call_count++;
+    return 0;
+}
+
+/* Submit one batch: command buffer @id, optionally waiting on / signalling semaphores */
+static int submit(struct pv_venus_submit_coalescer *coalescer, uintptr_t queue, uintptr_t id,
+                  uintptr_t wait, uintptr_t signal, uintptr_t fence)
+{
+    VkCommandBuffer command_buffer = HANDLE(VkCommandBuffer, id);
+    VkSemaphore wait_semaphore = HANDLE(VkSemaphore, wait);
+    VkSemaphore signal_semaphore = HANDLE(VkSemaphore, signal);
+    VkPipelineStageFlags stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+    VkSubmitInfo info = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .waitSemaphoreCount = wait ? 1 : 0,
+        .pWaitSemaphores = &wait_semaphore,
+        .pWaitDstStageMask = &stage,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &command_buffer,
+        .signalSemaphoreCount = signal ? 1 : 0,
+        .pSignalSemaphores = &signal_semaphore,
+    };
+    return pv_venus_submit_enqueue(coalescer, HANDLE(VkQueue, queue), &info,
+                                   HANDLE(VkFence, fence), 64, NULL);
+}
+
+static int init(struct pv_venus_submit_coalescer *coalescer, uint64_t max_bytes,
+                uint32_t max_delay_us)
+{
+    struct pv_venus_submit_backend backend = { .submit = fake_submit };
+    call_count = 0;
+    return pv_venus_submit_init(coalescer, &backend, max_bytes, max_delay_us);
+}
+
+int main(void)
+{
+    printf("=== PearVisor Venus Submit Coalescing Test ===\n\n");
+
+    struct pv_venus_submit_coalescer coalescer;
+    struct pv_venus_submit_stats stats;
+
+    /* Long delay so only explicit triggers flush in Tests 1-3 */
+    if (init(&coalescer, 1 << 20, 10 * 1000 * 1000) != 0) {
+        fprintf(stderr, "Init failed\n");
+        return 1;
+    }
+
+    /* Test 1: A chain of submits becomes one vkQueueSubmit, in order */
+    printf("--- Test 1: Merge in Order ---\n");
+    for (uintptr_t i = 1; i <= 8; i++) {
+        /* Batch i waits on what batch i-1 signalled */
+        if (submit(&coalescer, 1, 100 + i, i > 1 ? 200 + i - 1 : 0, 200 + i, 0) != 0) {
+            fprintf(stderr, "Submit failed\n");
+            return 1;
+        }
+    }
+    if (call_count != 0) {
+        fprintf(stderr, "Submitted before a flush trigger\n");
+        return 1;
+    }
+    pv_venus_submit_flush(&coalescer, PV_VENUS_SUBMIT_FLUSH_EXPLICIT);
+    if (call_count != 1 || calls[0].batches != 8) {
+        fprintf(stderr, "Expected 1 call with 8 batches, got %u\n", call_count);
+        return 1;
+    }
+    for (uint32_t i = 0; i < 8; i++) {
+        if (calls[0].command_buffers[i] != 101 + i || calls[0].signals[i] != 201 + i ||
+            calls[0].waits[i] != (i ? 200 + i : 0)) {
+            fprintf(stderr, "Batch %u out of order\n", i);
+            return 1;
+        }
+    }
+    printf("  8 submits -> 1 vkQueueSubmit, order kept\n");
+
+    /* Test 2: Fences ride along, but only one fits per submit */
+    printf("\n--- Test 2: Fences ---\n");
+    call_count = 0;
+    submit(&coalescer, 1, 1, 0, 0, 0);
+    submit(&coalescer, 1, 2, 0, 0, 900);
+    submit(&coalescer, 1, 3, 0, 0, 0);         /* Merges after the fenced batch */
+    submit(&coalescer, 1, 4, 0, 0, 901);       /* Second fence: flush first */
+    pv_venus_submit_flush(&coalescer, PV_VENUS_SUBMIT_FLUSH_EXPLICIT);
+    if (call_count != 2 || calls[0].batches != 3 || calls[0].fence != HANDLE(VkFence, 900) ||
+        calls[1].batches != 1 || calls[1].fence != HANDLE(VkFence, 901)) {
+        fprintf(stderr, "Fence grouping wrong (%u calls)\n", call_count);
+        return 1;
+    }
+    printf("  4 submits, 2 fences -> 2 vkQueueSubmit calls\n");
+
+    /* Test 3: Switching queues sends the held batches first */
+    printf("\n--- Test 3: Queue Switch ---\n");
+    call_count = 0;
+    submit(&coalescer, 1, 1, 0, 300, 0);
+    submit(&coalescer, 2, 2, 300, 0, 0);       /* Other queue waits on queue 1 */
+    if (call_count != 1 || calls[0].queue != HANDLE(VkQueue, 1)) {
+        fprintf(stderr, "Queue 1 batch not sent before queue 2's\n");
+        return 1;
+    }
+    pv_venus_submit_flush(&coalescer, PV_VENUS_SUBMIT_FLUSH_EXPLICIT);
+    if (call_count != 2 || calls[1].queue != HANDLE(VkQueue, 2)) {
+        fprintf(stderr, "Queue 2 batch lost\n");
+        return 1;
+    }
+    printf("  signalling queue flushed before the waiting one\n");
+
+    pv_venus_submit_get_stats(&coalescer, &stats);
+    printf("  guest=%llu host=%llu merge_ratio=%.2f ordering_flushes=%llu\n",
+           stats.guest_submits, stats.host_submits, pv_venus_submit_merge_ratio(&stats),
+           stats.flushes[PV_VENUS_SUBMIT_FLUSH_ORDERING]);
+    if (stats.guest_submits != 14 || stats.host_submits != 5 ||
+        stats.flushes[PV_VENUS_SUBMIT_FLUSH_ORDERING] != 2) {
+        fprintf(stderr, "Wrong statistics\n");
+        return 1;
+    }
+    pv_venus_submit_destroy(&coalescer);
+
+    /* Test 4: Byte and batch budgets */
+    printf("\n--- Test 4: Budgets ---\n");
+    init(&coalescer, 64 * 10, 10 * 1000 * 1000);
+    for (uintptr_t i = 1; i <= 25; i++) {
+        submit(&coalescer, 1, i, 0, 0, 0);
+    }
+    if (call_count != 2 || calls[0].batches != 10 || calls[1].batches != 10) {
+        fprintf(stderr, "Byte budget not enforced (%u calls)\n", call_count);
+        return 1;
+    }
+    pv_venus_submit_destroy(&coalescer);
+    if (call_count != 3 || calls[2].batches != 5) {
+        fprintf(stderr, "Destroy did not flush the rest\n");
+        return 1;
+    }
+
+    init(&coalescer, 1 << 30, 10 * 1000 * 1000);
+    for (uintptr_t i = 1; i <= PV_VENUS_SUBMIT_MAX_BATCHES + 1; i++) {
+        submit(&coalescer, 1, i, 0, 0, 0);
+    }
+    if (call_count != 1 || calls[0].batches != PV_VENUS_SUBMIT_MAX_BATCHES) {
+        fprintf(stderr, "Batch cap not enforced\n");
+        return 1;
+    }
+    pv_venus_submit_destroy(&coalescer);
+    printf("  byte and batch budgets flush\n");
+
+    /* Test 5: The timer sends batches nobody flushes */
+    printf("\n--- Test 5: Delay Budget ---\n");
+    init(&coalescer, 1 << 20, 1000);
+    submit(&coalescer, 1, 1, 0, 0, 0);
+    submit(&coalescer, 1, 2, 0, 0, 0);
+    pv_venus_submit_get_stats(&coalescer, &stats);
+    for (int i = 0; i < 200 && stats.host_submits == 0; i++) {
+        usleep(1000);
+        pv_venus_submit_get_stats(&coalescer, &stats);
+    }
+    if (call_count != 1 || calls[0].batches != 2 ||
+        stats.flushes[PV_VENUS_SUBMIT_FLUSH_TIMER] != 1) {
+        fprintf(stderr, "Timer did not flush\n");
+        return 1;
+    }
+    pv_venus_submit_destroy(&coalescer);
+    printf("  held batches sent after the delay budget\n");
+
+    printf("\n=== All Tests Passed! ===\n");
+    return 0;
+}
@@ -9,6 +9,40 @@
 import Foundation
 import Virtualization
 
+/// Placement of the ring control words (head, tail, status)
+///
+/// The guest driver decides where it reads and writes them, so this must
+/// match what the guest advertises. Raw values match
+/// PV_VENUS_RING_LAYOUT_* in pv_venus_ring.h.
+public enum VenusRingLayout {
+    /// head/tail/status at offsets 0/4/8, buffer at 16
+    case packed
+    /// One cache line per word, buffer on the fourth line
+    case isolated(cacheLineSize: Int)
+
+    var version: UInt32 {
+        switch self {
+        case .packed: return 1
+        case .isolated: return 2
+        }
+    }
+
+    var cacheLineSize: UInt32 {
+        switch self {
+        case .packed: return 0
+        case .isolated(let size): return UInt32(size)
+        }
+    }
+
+    /// Bytes ahead of the ring buffer
+    var controlSize: Int {
+        switch self {
+        case .packed: return 16
+        case .isolated(let size): return 3 * size
+        }
+    }
+}
+
 /// Integrates PearVisor GPU subsystem with VZ.framework
 public class GPUIntegration {
 
@@ -17,7 +51,8 @@ public class GPUIntegration {
     private var venusContext: OpaquePointer?
     private var ringBuffer: OpaquePointer?
     private var sharedMemoryRegion: UnsafeMutableRawPointer?
-    private var sharedMemorySize: Int = 4 * 1024 * 1024 // 4MB default
+    private var sharedMemorySize: Int = 0
+    private let ringBufferSize: Int = 4 * 1024 * 1024 // 4MB command ring
     private var isRunning = false
 
     public let vmID: UUID
@@ -56,10 +91,13 @@ public class GPUIntegration {
     // MARK: - Venus Integration
 
     /// Initialize Venus protocol handler and ring buffer
-    public func initializeVenus() throws {
+    ///
+    /// - Parameter ringLayout: Control word layout the guest driver uses
+    public func initializeVenus(ringLayout: VenusRingLayout = .packed) throws {
         print("[GPUIntegration] Initializing Venus protocol stack")
 
-        // Allocate shared memory region for ring buffer
+        // Control words, then the power-of-2 ring right after them
+        sharedMemorySize = ringLayout.controlSize + ringBufferSize
         sharedMemoryRegion = allocateSharedMemory(size: sharedMemorySize)
         guard sharedMemoryRegion != nil else {
             throw GPUIntegrationError.sharedMemoryAllocationFailed
@@ -69,7 +107,9 @@ public class GPUIntegration {
         // Initialize Venus ring buffer (call into C subsystem)
         ringBuffer = pv_venus_ring_create_from_memory(
             sharedMemoryRegion,
-            UInt32(sharedMemorySize)
+            UInt32(sharedMemorySize),
+            ringLayout.version,
+            ringLayout.cacheLineSize
         )
 
         guard ringBuffer != nil else {
@@ -254,7 +294,9 @@ public enum GPUIntegrationError: Error, LocalizedError {
 @_silgen_name("pv_venus_ring_create_from_memory")
 func pv_venus_ring_create_from_memory(
     _ memory: UnsafeMutableRawPointer?,
-    _ size: UInt32
+    _ size: UInt32,
+    _ layoutVersion: UInt32,
+    _ cacheLineSize: UInt32
 ) -> OpaquePointer?
 
 @_silgen_name("pv_venus_ring_destroy")